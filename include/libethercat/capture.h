@@ -0,0 +1,131 @@
+/**
+ * \file capture.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief frame capture
+ *
+ * Copies all transmitted and received frames into a ring, a background 
+ * task writes them to a pcapng file.
+ */
+
+/*
+ * This file is part of libethercat.
+ *
+ * libethercat is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * libethercat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with libethercat (LICENSE.LGPL-V3); if not, write 
+ * to the Free Software Foundation, Inc., 51 Franklin Street, Fifth 
+ * Floor, Boston, MA  02110-1301, USA.
+ * 
+ * Please note that the use of the EtherCAT technology, the EtherCAT 
+ * brand name and the EtherCAT logo is only permitted if the property 
+ * rights of Beckhoff Automation GmbH are observed. For further 
+ * information please contact Beckhoff Automation GmbH & Co. KG, 
+ * Hülshorstweg 20, D-33415 Verl, Germany (www.beckhoff.com) or the 
+ * EtherCAT Technology Group, Ostendstraße 196, D-90482 Nuremberg, 
+ * Germany (ETG, www.ethercat.org).
+ *
+ */
+
+#ifndef LIBETHERCAT_CAPTURE_H
+#define LIBETHERCAT_CAPTURE_H
+
+#include <libosal/types.h>
+#include <libosal/task.h>
+
+#include "libethercat/common.h"
+#include "libethercat/datagram.h"
+#include "libethercat/ring.h"
+
+#define EC_CAPTURE_SNAPLEN  (1514u)     //!< \brief Bytes captured per frame.
+
+struct hw_common;
+
+//! Direction of captured frame.
+typedef enum ec_capture_dir {
+    EC_CAPTURE_DIR_RX = 1,              //!< \brief Received frame.
+    EC_CAPTURE_DIR_TX = 2,              //!< \brief Transmitted frame.
+} ec_capture_dir_t;
+
+//! Captured frame.
+typedef struct ec_capture_record {
+    osal_uint64_t seq;                  //!< \brief Sequence number of ring slot, has to be first.
+    osal_uint64_t timestamp;            //!< \brief Capture time [ns].
+    osal_uint16_t len;                  //!< \brief Frame length on wire.
+    osal_uint16_t caplen;               //!< \brief Bytes stored in data.
+    ec_capture_dir_t dir;               //!< \brief Frame direction.
+    osal_uint8_t data[EC_CAPTURE_SNAPLEN];  //!< \brief Frame data.
+} ec_capture_record_t;
+
+//! Frame capture.
+/*!
+ * Bounded lock-free ring, transmit and receive path add frames without 
+ * blocking, if full the frame is dropped and counted. One writer task
+ * stores them.
+ */
+typedef struct ec_capture {
+    ec_ring_t ring;                                 //!< \brief Positions of producers and writer task.
+    osal_uint64_t dropped;                          //!< \brief Frames dropped since start.
+    osal_uint64_t written;                          //!< \brief Frames written since start.
+    int running;                                    //!< \brief Frames are captured.
+    void *file;                                     //!< \brief Output file.
+    osal_task_t writer_tid;                         //!< \brief Writer task.
+    ec_capture_record_t records[LEC_CAPTURE_RING_SIZE]; //!< \brief Frame slots.
+} ec_capture_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Start capturing frames.
+/*!
+ * All frames sent and received by \p phw are written to \p path in 
+ * pcapng format with nanosecond timestamps. The cyclic path only copies 
+ * the frames, a low priority task writes them. If the ring is full frames 
+ * are dropped, the count is stored in an interface statistics block when 
+ * stopping.
+ *
+ * \param[in] phw           Pointer to hw handle.
+ * \param[in] path          Output file.
+ *
+ * \retval EC_OK                    On success.
+ * \retval EC_ERROR_UNAVAILABLE     File or writer task could not be created.
+ */
+int ec_capture_start(struct hw_common *phw, const osal_char_t *path);
+
+//! Stop capturing frames.
+/*!
+ * Writes all pending frames and closes the file.
+ *
+ * \param[in] phw           Pointer to hw handle.
+ */
+void ec_capture_stop(struct hw_common *phw);
+
+//! Copy frame into capture ring.
+/*!
+ * Does nothing if capture is not running.
+ *
+ * \param[in] cap           Pointer to capture.
+ * \param[in] pframe        Frame to capture.
+ * \param[in] dir           Frame direction.
+ */
+void ec_capture_frame(ec_capture_t *cap, const ec_frame_t *pframe, ec_capture_dir_t dir);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBETHERCAT_CAPTURE_H
+
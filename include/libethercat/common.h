@@ -111,6 +111,86 @@
 #define LEC_MAX_DATAGRAMS                   ( (osal_size_t)     100u)
 #endif 
 
+#ifdef LIBETHERCAT_MAX_BATCH_DATAGRAMS
+//! Maximum number of datagrams of a batched transfer on the wire at once.
+#define LEC_MAX_BATCH_DATAGRAMS             ( (osal_size_t)LIBETHERCAT_MAX_BATCH_DATAGRAMS )
+#else
+//! Maximum number of datagrams of a batched transfer on the wire at once.
+#define LEC_MAX_BATCH_DATAGRAMS             ( (osal_size_t)(LEC_MAX_DATAGRAMS / 2u) )
+#endif 
+
+#ifdef LIBETHERCAT_MAX_PD_CHUNKS
+//! Maximum number of datagrams a process data group is split into.
+#define LEC_MAX_PD_CHUNKS                   ( (osal_size_t)LIBETHERCAT_MAX_PD_CHUNKS )
+#else
+//! Maximum number of datagrams a process data group is split into (at least 1 kB each).
+#define LEC_MAX_PD_CHUNKS                   ( (osal_size_t)((LEC_MAX_PDLEN / 1024u) + 2u) )
+#endif 
+
+#ifdef LIBETHERCAT_MAX_PD_PIPELINE_DEPTH
+//! Maximum number of overlapped cycles of a process data group on the wire.
+#define LEC_MAX_PD_PIPELINE_DEPTH           ( (osal_size_t)LIBETHERCAT_MAX_PD_PIPELINE_DEPTH )
+#else
+//! Maximum number of overlapped cycles of a process data group on the wire.
+#define LEC_MAX_PD_PIPELINE_DEPTH           ( (osal_size_t)       4u)
+#endif 
+
+#ifdef LIBETHERCAT_MAX_INDEX_CYCLIC
+//! Number of datagram indices reserved for cyclic datagrams.
+#define LEC_MAX_INDEX_CYCLIC                ( (osal_size_t)LIBETHERCAT_MAX_INDEX_CYCLIC )
+#else
+//! Number of datagram indices reserved for cyclic datagrams (4 + overlapped per group, dc, state), at most 192.
+#define LEC_MAX_INDEX_CYCLIC                ( (osal_size_t)LEC_MIN(((3u + LEC_MAX_PD_PIPELINE_DEPTH) * LEC_MAX_GROUPS) + 4u, 192u) )
+#endif 
+
+#ifdef LIBETHERCAT_INDEX_SPIN_MAX_NS
+//! Maximum time to spin for a synchronous datagram before sleeping [ns].
+#define LEC_INDEX_SPIN_MAX_NS               ( (osal_uint64_t)LIBETHERCAT_INDEX_SPIN_MAX_NS )
+#else
+//! Maximum time to spin for a synchronous datagram before sleeping [ns].
+#define LEC_INDEX_SPIN_MAX_NS               ( (osal_uint64_t)   20000u)
+#endif 
+
+#ifdef LIBETHERCAT_HW_RX_MIN_SLEEP_NS
+//! Minimum predicted idle time before polling devices sleep while waiting for replies [ns].
+#define LEC_HW_RX_MIN_SLEEP_NS              ( (osal_uint64_t)LIBETHERCAT_HW_RX_MIN_SLEEP_NS )
+#else
+//! Minimum predicted idle time before polling devices sleep while waiting for replies [ns].
+#define LEC_HW_RX_MIN_SLEEP_NS              ( (osal_uint64_t)   10000u)
+#endif 
+
+#ifdef LIBETHERCAT_RX_SPIN_MAX_NS
+//! Time polling devices keep polling for replies later than predicted [ns].
+#define LEC_RX_SPIN_MAX_NS                  ( (osal_uint64_t)LIBETHERCAT_RX_SPIN_MAX_NS )
+#else
+//! Time polling devices keep polling for replies later than predicted [ns].
+#define LEC_RX_SPIN_MAX_NS                  ( (osal_uint64_t)   20000u)
+#endif 
+
+#ifdef LIBETHERCAT_HW_TX_WINDOW_GUARD_NS
+//! Margin low prio frames sent between cycles have to return before the next cycle [ns].
+#define LEC_HW_TX_WINDOW_GUARD_NS           ( (osal_uint64_t)LIBETHERCAT_HW_TX_WINDOW_GUARD_NS )
+#else
+//! Margin low prio frames sent between cycles have to return before the next cycle [ns].
+#define LEC_HW_TX_WINDOW_GUARD_NS           ( (osal_uint64_t)   20000u)
+#endif 
+
+#ifdef LIBETHERCAT_SOCK_RAW_MMAPED_TX_RING_DEPTH
+//! Number of frames in TX ring of mmaped raw socket device.
+#define LEC_SOCK_RAW_MMAPED_TX_RING_DEPTH   ( (int)LIBETHERCAT_SOCK_RAW_MMAPED_TX_RING_DEPTH )
+#else
+//! Number of frames in TX ring of mmaped raw socket device.
+#define LEC_SOCK_RAW_MMAPED_TX_RING_DEPTH   ( (int)     100 )
+#endif 
+
+#ifdef LIBETHERCAT_SOCK_RAW_MMAPED_RX_BLOCK_RING
+//! Use TPACKET_V3 block ring instead of per-frame TPACKET_V2 ring in mmaped raw socket device.
+#define LEC_SOCK_RAW_MMAPED_RX_BLOCK_RING   LIBETHERCAT_SOCK_RAW_MMAPED_RX_BLOCK_RING
+#else
+//! Use TPACKET_V3 block ring instead of per-frame TPACKET_V2 ring in mmaped raw socket device.
+#define LEC_SOCK_RAW_MMAPED_RX_BLOCK_RING   0
+#endif 
+
 #ifdef LIBETHERCAT_MAX_EEPROM_CAT_SM
 //! Maximum number of EEPROM catergory sync manager entries.
 #define LEC_MAX_EEPROM_CAT_SM               ( (osal_size_t)LIBETHERCAT_MAX_EEPROM_CAT_SM )
@@ -159,6 +239,14 @@
 #define LEC_MAX_EEPROM_CAT_DC               ( (osal_size_t)       8u)
 #endif
 
+#ifdef LIBETHERCAT_MAX_EEPROM_IMAGE_SIZE
+//! Maximum number of EEPROM bytes prefetched per slave.
+#define LEC_MAX_EEPROM_IMAGE_SIZE           ( (osal_size_t)LIBETHERCAT_MAX_EEPROM_IMAGE_SIZE )
+#else
+//! Maximum number of EEPROM bytes prefetched per slave.
+#define LEC_MAX_EEPROM_IMAGE_SIZE           ( (osal_size_t)    4096u)
+#endif
+
 #ifdef LIBETHERCAT_MAX_STRING_LEN
 //! Maximum string length.
 #define LEC_MAX_STRING_LEN                  ( (osal_size_t)LIBETHERCAT_MAX_STRING_LEN )
@@ -167,6 +255,38 @@
 #define LEC_MAX_STRING_LEN                  ( (osal_size_t)     128u)
 #endif
 
+#ifdef LIBETHERCAT_MAX_TRACE_EVENTS
+//! Number of trace events kept per thread, power of 2.
+#define LEC_MAX_TRACE_EVENTS                ( (osal_size_t)LIBETHERCAT_MAX_TRACE_EVENTS )
+#else
+//! Number of trace events kept per thread, power of 2.
+#define LEC_MAX_TRACE_EVENTS                ( (osal_size_t)    4096u)
+#endif
+
+#ifdef LIBETHERCAT_LOG_RING_SIZE
+//! Number of deferred log messages, power of 2.
+#define LEC_LOG_RING_SIZE                   ( (osal_size_t)LIBETHERCAT_LOG_RING_SIZE )
+#else
+//! Number of deferred log messages, power of 2.
+#define LEC_LOG_RING_SIZE                   ( (osal_size_t)     256u)
+#endif
+
+#ifdef LIBETHERCAT_MAX_LOG_LEVEL
+//! Highest log level compiled in, messages above are removed.
+#define LEC_MAX_LOG_LEVEL                   ( LIBETHERCAT_MAX_LOG_LEVEL )
+#else
+//! Highest log level compiled in, messages above are removed.
+#define LEC_MAX_LOG_LEVEL                   ( 1000 )
+#endif
+
+#ifdef LIBETHERCAT_CAPTURE_RING_SIZE
+//! Number of frames buffered for capture, power of 2.
+#define LEC_CAPTURE_RING_SIZE               ( (osal_size_t)LIBETHERCAT_CAPTURE_RING_SIZE )
+#else
+//! Number of frames buffered for capture, power of 2.
+#define LEC_CAPTURE_RING_SIZE               ( (osal_size_t)     128u)
+#endif
+
 #ifdef LIBETHERCAT_MAX_DATA
 //! Maximum data length.
 #define LEC_MAX_DATA                        ( (osal_size_t)LIBETHERCAT_MAX_DATA )
@@ -54,6 +54,9 @@
 #include "libethercat/pool.h"
 #include "libethercat/async_loop.h"
 #include "libethercat/eeprom.h"
+#include "libethercat/histogram.h"
+#include "libethercat/trace.h"
+#include "libethercat/log.h"
 
 #if LIBETHERCAT_BUILD_POSIX == 1
 #include "libethercat/veth.h"
@@ -74,6 +77,45 @@ struct ec;
 struct ec_slave;
 typedef struct ec_slave ec_slave_t;
     
+//! Part of a process data group sent in one datagram.
+/*!
+ * Groups whose logical image does not fit into one frame are split into 
+ * several datagrams. Outputs are copied from \link ec_pd_group::pd \endlink
+ * at \link pd_out_off \endlink to the start of the payload, inputs are 
+ * copied back from \link in_off \endlink of the payload to \link 
+ * pd_in_off \endlink.
+ */
+typedef struct ec_pd_group_chunk {
+    ec_cyclic_datagram_t cdg;       //!< Cyclic datagram of chunk.
+    osal_uint8_t cmd;               //!< Logical command, LRW, LRD or LWR.
+    osal_uint32_t log;              //!< Logical start address.
+    osal_size_t len;                //!< Payload length.
+    osal_size_t pd_out_off;         //!< Offset of outputs in process data.
+    osal_size_t out_len;            //!< Length of outputs.
+    osal_size_t in_off;             //!< Offset of inputs in payload.
+    osal_size_t pd_in_off;          //!< Offset of inputs in process data.
+    osal_size_t in_len;             //!< Length of inputs.
+    osal_uint16_t wkc_expected;     //!< Expected working counter of chunk.
+    int wkc_mismatch_cnt;           //!< Missed counter to avoid flooding log output.
+    osal_uint64_t rx_cycle;         //!< Chunk cycle whose reply was taken, see \link ec_pd_group::chunk_tx_cycle \endlink.
+} ec_pd_group_chunk_t;
+
+//! Triple buffered copy of a process data image.
+/*!
+ * One producer and one consumer exchange complete images without blocking
+ * each other. The producer fills \link back \endlink and publishes it by 
+ * swapping it with \link middle \endlink, the consumer takes the newest 
+ * published image by swapping \link front \endlink with \link middle 
+ * \endlink. Each buffer has the layout of \link ec_pd_group::pd \endlink.
+ */
+typedef struct ec_pd_triple_buffer {
+    osal_uint8_t buf[3][LEC_MAX_PDLEN];
+                                    //!< Image buffers.
+    osal_uint32_t middle;           //!< Index of published buffer, bit 2 set if not yet taken.
+    osal_uint32_t back;             //!< Index of buffer owned by producer.
+    osal_uint32_t front;            //!< Index of buffer owned by consumer.
+} ec_pd_triple_buffer_t;
+
 //! process data group structure
 typedef struct ec_pd_group {
     osal_uint32_t group;            //!< Number of group.
@@ -185,12 +227,98 @@ typedef struct ec_pd_group {
     ec_cyclic_datagram_t cdg_lrd_mbx_state;
                                     //!< Group cyclic datagram LRD mailbox state.
 
+    osal_uint8_t tx_template[LEC_MAX_POOL_DATA_SIZE];
+                                    //!< Prebuilt group datagrams (compiled cycle).
+                                    /*!<
+                                     * Built after the logical mapping was 
+                                     * created. It contains the chained group 
+                                     * datagrams with headers and zeroed 
+                                     * payloads. Each cycle it is copied to 
+                                     * the tx frame as one block and only the 
+                                     * outputs are patched.
+                                     */
+    osal_size_t tx_template_len;    //!< Length of tx_template, 0 if not available.
+    osal_size_t tx_template_out_off;//!< Offset of outputs payload in tx_template.
+    pool_entry_t *tx_template_entries[3];
+                                    //!< Pool entries of datagrams in tx_template.
+    osal_size_t tx_template_cnt;    //!< Number of datagrams in tx_template.
+
+    ec_pd_group_chunk_t chunks[LEC_MAX_PD_CHUNKS];
+                                    //!< Datagrams of a group larger than one frame.
+    osal_size_t chunk_cnt;          //!< Number of chunks, 0 if group fits into one datagram.
+    osal_size_t chunk_rx_cnt;       //!< Chunks received in current cycle.
+    osal_uint64_t chunk_tx_cycle;   //!< Number of chunk cycles sent.
+
+    osal_size_t pipeline_depth;     //!< Number of LRW cycles on the wire at once.
+                                    /*!<
+                                     * With a depth greater than 1 the LRW of 
+                                     * the next cycle is sent with another 
+                                     * datagram index while the former cycles 
+                                     * are still on the wire. See \link 
+                                     * ec_configure_pd_group_pipeline \endlink.
+                                     */
+    ec_cyclic_datagram_t cdg_pipeline[LEC_MAX_PD_PIPELINE_DEPTH];
+                                    //!< LRW datagrams of overlapped cycles.
+                                    /*!<
+                                     * Slot 0 is unused, the first cycle 
+                                     * always uses \link cdg \endlink.
+                                     */
+    osal_uint64_t pipeline_cycle[LEC_MAX_PD_PIPELINE_DEPTH];
+                                    //!< Cycle number sent in each slot.
+    osal_size_t pipeline_slot;      //!< Slot used for next cycle.
+    osal_uint64_t pipeline_tx_cycle;//!< Number of cycles sent.
+    osal_uint64_t pipeline_rx_cycle;//!< Newest cycle whose inputs were copied.
+
+    int use_triple_buffer;          //!< Exchange process data by triple buffers.
+                                    /*!<
+                                     * See \link ec_configure_pd_group_triple_buffer
+                                     * \endlink.
+                                     */
+    ec_pd_triple_buffer_t tb_in;    //!< Inputs published by receive callback.
+    ec_pd_triple_buffer_t tb_out;   //!< Outputs published by application.
+
     int divisor;                    //!< Timer Divisor
     int divisor_cnt;                //!< Actual timer cycle count
 } ec_pd_group_t;
 
+//! Datagram of a batched transfer.
+typedef struct ec_batch_req {
+    osal_uint8_t cmd;               //!< EtherCAT command.
+    osal_uint32_t adr;              //!< 32-bit address of slave.
+    osal_uint8_t *data;             //!< Data buffer to read/write.
+    osal_size_t datalen;            //!< Length of data.
+
+    osal_uint16_t wkc;              //!< Working counter of reply.
+    int ret;                        //!< EC_OK or error code of this datagram.
+
+    pool_entry_t *p_entry;          //!< Pool entry while on the wire.
+    idx_entry_t *p_idx;             //!< Datagram index while on the wire.
+} ec_batch_req_t;
+
+//! Batched transfer of many datagrams with one wait.
+typedef struct ec_batch {
+    ec_batch_req_t *reqs;           //!< Datagrams of the batch.
+    osal_size_t cnt;                //!< Number of datagrams.
+    osal_size_t pos;                //!< First datagram not yet completed.
+    osal_size_t end;                //!< End of datagrams currently on the wire.
+    osal_bool_t sent;               //!< Frames were sent on submit, replies still to receive.
+} ec_batch_t;
+
 typedef struct ec_statistics {
     osal_uint64_t lost_datagrams;
+    osal_uint64_t tx_window_datagrams;  //!< Low prio datagrams sent between cycles.
+    osal_uint64_t tx_window_saved_ns;   //!< Time their replies arrived before the frames of the next cycle [ns].
+    osal_uint64_t tx_window_late;       //!< Replies of these arriving after the frames of the next cycle.
+    osal_uint64_t tx_window_missed;     //!< Times low prio datagrams were left for the next cycle.
+
+    ec_histogram_t tx_duration;         //!< Time to send cyclic frames [ns].
+    ec_histogram_t rx_duration;         //!< Time to receive all replies of a cycle [ns].
+    ec_histogram_t round_trip;          //!< Round trip time of each datagram [ns].
+    ec_histogram_t cycle_jitter;        //!< Deviation of \link ec_send_process_data \endlink calls 
+                                        //!< from \link ec::main_cycle_interval \endlink [ns].
+    ec_histogram_t dc_diff;             //!< Absolute difference of master and reference clock [ns].
+    osal_uint64_t wkc_mismatch[LEC_MAX_GROUPS];
+                                        //!< Process data datagrams with working counter mismatch per group.
 } ec_statistics_t;
 
 //! ethercat master structure
@@ -218,6 +346,7 @@ typedef struct ec {
     
     osal_int64_t main_cycle_interval;
                                     //!< \brief Expected timer increment of one EtherCAT cycle in [ns].
+    osal_uint64_t last_cycle_start; //!< \brief Time of last \link ec_send_process_data \endlink call in [ns].
     
     pool_entry_t mbx_mp_recv_free_entries[LEC_MAX_MBX_ENTRIES]; //!< \brief static buffers for mailbox receive pool.
     pool_entry_t mbx_mp_send_free_entries[LEC_MAX_MBX_ENTRIES]; //!< \brief static buffers for mailbox send pool.
@@ -246,6 +375,8 @@ typedef struct ec {
     pool_t mbx_gw_recv_pool;        //!< \brief receive mbx gateway message pool
 
     int eeprom_log;                 //!< flag whether to log eeprom to stdout
+    osal_char_t eeprom_cache_dir[LEC_MAX_STRING_LEN];
+                                    //!< directory of eeprom cache, empty if disabled
     ec_state_t master_state;        //!< expected EtherCAT master state
     int state_transition_pending;   //!< state transition is currently pending
 
@@ -273,18 +404,22 @@ typedef struct ec {
 
     void *ec_log_func_user;
     void (*ec_log_func)(ec_t *pec, int lvl, const osal_char_t *format, ...) __attribute__ ((format (printf, 3, 4)));
+    ec_log_ring_t log_ring;         //!< \brief Deferred log messages, see \link ec_log_deferred_start \endlink.
 } ec_t;
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+//! Log message, levels above \link LEC_MAX_LOG_LEVEL \endlink are compiled out.
 #define ec_log(lvl, pre, format, ...) \
-    _ec_log(pec, (lvl), (pre), (format), ##__VA_ARGS__)
+    (((lvl) <= LEC_MAX_LOG_LEVEL) ? _ec_log(pec, (lvl), (pre), (format), ##__VA_ARGS__) : (void)0)
 
 //! \brief EtherCAT logging function 
 /*!
- * This function does all EtherCAT logging. 
+ * This function does all EtherCAT logging. If deferred logging is 
+ * running, only format pointer and arguments are stored and formatting 
+ * is done by the drain task, so format has to be a static string.
  *
  * \param[in]   lvl         Log level of message.
  * \param[in]   pre         String prepended to message.
@@ -349,6 +484,80 @@ int ec_create_pd_groups(ec_t *pec, osal_uint32_t pd_group_cnt);
 void ec_configure_pd_group(ec_t *pec, osal_uint16_t group, int clock_divisor,
     void (*user_cb)(void *arg, int num), void *user_cb_arg);
 
+//! \brief Configure overlapped cycles of process data group.
+/*!
+ * On long lines the round trip of the group frame may exceed the cycle
+ * time. With a \p depth greater than 1 the LRW of the next cycle is sent 
+ * with its own datagram index while up to \p depth - 1 former cycles are
+ * still on the wire. Inputs are only taken from replies newer than the 
+ * last copied one, so \link ec_pd_group::pd \endlink never goes back in 
+ * time. A datagram is reported lost only if it did not return within 
+ * \p depth cycles.
+ *
+ * Only groups using LRW which fit into one datagram are pipelined (see
+ * \link ec_pd_group::chunks \endlink), the compiled cycle is not used and
+ * the mailbox state datagram is skipped while it is still on the wire. 
+ * Replies must be received by a receive thread, in polling mode the 
+ * device waits for all replies of the current cycle. Has to be called 
+ * before switching to SAFEOP.
+ *
+ * \param[in] pec           Pointer to EtherCAT master structure.
+ * \param[in] group         Number of group to configure.
+ * \param[in] depth         Number of cycles on the wire at once, 1 disables 
+ *                          overlapped cycles.
+ *
+ * \retval EC_OK                on success
+ * \retval EC_ERROR_UNAVAILABLE if \p depth exceeds \link LEC_MAX_PD_PIPELINE_DEPTH \endlink.
+ */
+int ec_configure_pd_group_pipeline(ec_t *pec, osal_uint16_t group, osal_size_t depth);
+
+//! \brief Configure triple buffered process data of group.
+/*!
+ * \link ec_pd_group::pd \endlink is shared between the receive thread,
+ * the sending thread and the application. With triple buffers enabled the
+ * receive callback publishes each complete input image with one atomic 
+ * swap, \link ec_pd_group_get_inputs \endlink returns the newest one. 
+ * The application writes its outputs to \link ec_pd_group_get_outputs 
+ * \endlink and hands them over with \link ec_pd_group_publish_outputs
+ * \endlink, the next send of the group takes them over. Neither side 
+ * waits for the other or sees a partly updated image.
+ *
+ * Inputs and outputs are at the same offsets as in \link ec_pd_group::pd
+ * \endlink. Each side is meant for one thread.
+ *
+ * \param[in] pec           Pointer to EtherCAT master structure.
+ * \param[in] group         Number of group to configure.
+ * \param[in] enable        Enable triple buffers.
+ */
+void ec_configure_pd_group_triple_buffer(ec_t *pec, osal_uint16_t group, int enable);
+
+//! \brief Get newest input image of triple buffered group.
+/*!
+ * \param[in] pec           Pointer to EtherCAT master structure.
+ * \param[in] group         Number of group.
+ *
+ * \return Process data image, valid until the next call.
+ */
+const osal_uint8_t *ec_pd_group_get_inputs(ec_t *pec, osal_uint16_t group);
+
+//! \brief Get output image of triple buffered group to write to.
+/*!
+ * The image contains the outputs last published.
+ *
+ * \param[in] pec           Pointer to EtherCAT master structure.
+ * \param[in] group         Number of group.
+ *
+ * \return Process data image, valid until \link ec_pd_group_publish_outputs \endlink.
+ */
+osal_uint8_t *ec_pd_group_get_outputs(ec_t *pec, osal_uint16_t group);
+
+//! \brief Publish outputs of triple buffered group.
+/*!
+ * \param[in] pec           Pointer to EtherCAT master structure.
+ * \param[in] group         Number of group.
+ */
+void ec_pd_group_publish_outputs(ec_t *pec, osal_uint16_t group);
+
 //! \brief Destroy process data groups.
 /*!
  * \param[in] pec           Pointer to ethercat master structure, 
@@ -371,6 +580,61 @@ int ec_destroy_pd_groups(ec_t *pec);
 int ec_transceive(ec_t *pec, osal_uint8_t cmd, osal_uint32_t adr, 
         osal_uint8_t *data, osal_size_t datalen, osal_uint16_t *wkc);
 
+//! \brief Initialize a batched transfer.
+/*!
+ * \param[out] batch        Batch handle.
+ * \param[in]  reqs         Datagrams to transfer, cmd, adr, data and 
+ *                          datalen have to be filled in.
+ * \param[in]  cnt          Number of datagrams.
+ */
+void ec_batch_init(ec_batch_t *batch, ec_batch_req_t *reqs, osal_size_t cnt);
+
+//! \brief Queue next datagrams of a batch without waiting.
+/*!
+ * As many datagrams as datagram indices and pool entries allow (at most
+ * \link LEC_MAX_BATCH_DATAGRAMS \endlink) are queued. They are packed into
+ * as few frames as the mtu allows and sent right away if the master is not 
+ * cyclic or the next cycle leaves enough time, otherwise with the next cycle.
+ *
+ * \param[in]     pec       Pointer to ethercat master structure, 
+ *                          which you got from \link ec_open \endlink.
+ * \param[in,out] batch     Batch handle.
+ *
+ * \retval EC_OK                        on success
+ * \retval EC_ERROR_UNAVAILABLE         if all datagrams were already submitted
+ *                                      or former ones were not waited for.
+ * \retval EC_ERROR_OUT_OF_INDICES      if no datagram index was available.
+ * \retval EC_ERROR_OUT_OF_DATAGRAMS    if no pool entry was available.
+ */
+int ec_batch_submit(ec_t *pec, ec_batch_t *batch);
+
+//! \brief Wait for all submitted datagrams of a batch.
+/*!
+ * Fills in wkc, ret and the read data of each submitted datagram.
+ *
+ * \param[in]     pec       Pointer to ethercat master structure, 
+ *                          which you got from \link ec_open \endlink.
+ * \param[in,out] batch     Batch handle.
+ * \param[in]     timeout   Absolute timeout for the whole batch.
+ *
+ * \retval EC_OK                on success
+ * \retval EC_ERROR_TIMEOUT     if at least one datagram did not return.
+ */
+int ec_batch_wait(ec_t *pec, ec_batch_t *batch, osal_timer_t *timeout);
+
+//! \brief Transfer many datagrams with as few frames as possible.
+/*!
+ * Submits and waits in rounds until all datagrams are done.
+ *
+ * \param[in]     pec       Pointer to ethercat master structure, 
+ *                          which you got from \link ec_open \endlink.
+ * \param[in,out] reqs      Datagrams to transfer.
+ * \param[in]     cnt       Number of datagrams.
+ *
+ * \return EC_OK if all datagrams returned, otherwise first error code.
+ */
+int ec_batch_transceive(ec_t *pec, ec_batch_req_t *reqs, osal_size_t cnt);
+
 //! \brief Set state on ethercat bus.
 /*! 
  * \param[in] pec           Pointer to ethercat master structure, 
@@ -391,6 +655,19 @@ int ec_set_state(ec_t *pec, ec_state_t state);
  */
 int ec_send_process_data(ec_t *pec);
 
+//! \brief Get cycle statistics.
+/*!
+ * Copies counters and histograms, which are recorded continuously without
+ * locking. With \p reset set the statistics start over, values recorded
+ * meanwhile are never lost.
+ *
+ * \param[in]  pec          Pointer to EtherCAT master structure, 
+ *                          which you got from \link ec_open \endlink.
+ * \param[out] stats        Copy of statistics.
+ * \param[in]  reset        Clear statistics.
+ */
+void ec_get_statistics(ec_t *pec, ec_statistics_t *stats, int reset);
+
 //! \brief Send distributed clocks sync datagram.
 /*!
  * \param[in] pec           Pointer to ethercat master structure, 
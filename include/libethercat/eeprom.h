@@ -178,6 +178,9 @@ typedef struct eeprom_info {
 
     osal_uint8_t dcs_cnt;                   //!< count of distributed clocks settings                            
     ec_eeprom_cat_dc_t dcs[LEC_MAX_EEPROM_CAT_DC];                //!< array of distributed clocks settings
+
+    osal_size_t image_len;                  //!< valid bytes in image, 0 if not prefetched
+    osal_uint8_t image[LEC_MAX_EEPROM_IMAGE_SIZE];  //!< eeprom contents from word 0 on, see \link ec_eeprom_prefetch \endlink
 } eeprom_info_t;
 
 #define EC_EEPROM_MBX_AOE                   (0x01u)     //!< \brief AoE mailbox support
@@ -187,6 +190,7 @@ typedef struct eeprom_info {
 #define EC_EEPROM_MBX_SOE                   (0x10u)     //!< \brief SoE mailbox support
 #define EC_EEPROM_MBX_VOE                   (0x20u)     //!< \brief VoE mailbox support
 
+#define EC_EEPROM_ADR_CHECKSUM              (0x0007u)   //!< \brief offset config area checksum
 #define EC_EEPROM_ADR_VENDOR_ID             (0x0008u)   //!< \brief offset vendor id
 #define EC_EEPROM_ADR_PRODUCT_CODE          (0x000Au)   //!< \brief offset product code
 #define EC_EEPROM_ADR_REVISION_NUMBER       (0x000Cu)   //!< \brief offset revision number
@@ -203,6 +207,8 @@ typedef struct eeprom_info {
 #define EC_EEPROM_ADR_SIZE                  (0x003Eu)   //!< \brief offset eeprom size
 #define EC_EEPROM_ADR_CAT_OFFSET            (0x0040u)   //!< \brief offset start of categories
 
+#define EC_EEPROM_CACHE_KEY_LEN             (0x0020u)   //!< \brief bytes compared on cache lookup, config area and identity
+
 #define EC_EEPROM_CAT_NOP                   (     0u)   //!< \brief category do nothing
 #define EC_EEPROM_CAT_STRINGS               (    10u)   //!< \brief category strings
 #define EC_EEPROM_CAT_DATATYPES             (    20u)   //!< \brief category datatypes
@@ -326,6 +332,48 @@ int ec_eepromread_len(struct ec *pec, osal_uint16_t slave,
 int ec_eepromwrite_len(struct ec *pec, osal_uint16_t slave, 
         osal_uint32_t eepadr, const osal_uint8_t *buf, osal_size_t buflen);
 
+//! Prefetch eeprom contents of all slaves.
+/*!
+ * Runs the eeprom read access of all slaves in lock step, each step for 
+ * all slaves is sent with batched datagrams. ESCs supporting 8 byte reads 
+ * are read 8 bytes at once. Each slave's eeprom is read from word 0 up to 
+ * the end category or \link LEC_MAX_EEPROM_IMAGE_SIZE \endlink bytes into 
+ * its image, \link ec_eepromread_len \endlink serves reads from there. 
+ * Slaves failing are left to the single slave access.
+ *
+ * With a cache directory set by \link ec_eeprom_cache_set_dir \endlink only 
+ * the first \link EC_EEPROM_CACHE_KEY_LEN \endlink bytes and the category 
+ * headers are read from slaves with a cached image of the same vendor id, 
+ * product code, revision, serial number and config area checksum. If a 
+ * category header differs from the cached one the slave is read completely 
+ * like the slaves not cached, and the cache is updated. Changes keeping 
+ * all category types and lengths are not detected, but writing through 
+ * \link ec_eepromwrite \endlink removes the cached image.
+ *
+ * \param[in] pec               Pointer to EtherCAT master structure, 
+ *                              which you got from \link ec_open \endlink.
+ *
+ * \retval  EC_OK                               On success.
+ * \retval  EC_ERROR_EEPROM_READ_ERROR          If at least one slave failed.
+ */
+int ec_eeprom_prefetch(struct ec *pec);
+
+//! Set directory of eeprom cache.
+/*!
+ * Cached images are stored as one file per device identity, a device 
+ * swapped for another one with different identity is read again. Writing 
+ * to a slave's eeprom removes its cached image.
+ *
+ * \param[in] pec               Pointer to EtherCAT master structure, 
+ *                              which you got from \link ec_open \endlink.
+ * \param[in] dir               Existing directory for cached images, 
+ *                              NULL disables the cache.
+ *
+ * \retval  EC_OK                               On success.
+ * \retval  EC_ERROR_OUT_OF_MEMORY              If dir is longer than \link LEC_MAX_STRING_LEN \endlink.
+ */
+int ec_eeprom_cache_set_dir(struct ec *pec, const osal_char_t *dir);
+
 //! Read out whole eeprom and categories and store in EtherCAT master structure.
 /*!
  * \param[in] pec               Pointer to EtherCAT master structure, 
@@ -0,0 +1,114 @@
+/**
+ * \file histogram.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief latency histograms
+ *
+ */
+
+/*
+ * This file is part of libethercat.
+ *
+ * libethercat is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * libethercat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with libethercat (LICENSE.LGPL-V3); if not, write 
+ * to the Free Software Foundation, Inc., 51 Franklin Street, Fifth 
+ * Floor, Boston, MA  02110-1301, USA.
+ * 
+ * Please note that the use of the EtherCAT technology, the EtherCAT 
+ * brand name and the EtherCAT logo is only permitted if the property 
+ * rights of Beckhoff Automation GmbH are observed. For further 
+ * information please contact Beckhoff Automation GmbH & Co. KG, 
+ * Hülshorstweg 20, D-33415 Verl, Germany (www.beckhoff.com) or the 
+ * EtherCAT Technology Group, Ostendstraße 196, D-90482 Nuremberg, 
+ * Germany (ETG, www.ethercat.org).
+ *
+ */
+
+#ifndef LIBETHERCAT_HISTOGRAM_H
+#define LIBETHERCAT_HISTOGRAM_H
+
+#include <libosal/types.h>
+
+#define EC_HISTOGRAM_SUB_BITS   (3u)    //!< \brief Linear sub buckets per power of two are 2^EC_HISTOGRAM_SUB_BITS.
+#define EC_HISTOGRAM_BUCKETS    (496u)  //!< \brief Buckets covering the whole 64-bit range.
+
+//! Log-linear histogram with fixed memory.
+/*!
+ * Values below 16 have their own bucket, above each power of two is split
+ * into 8 linear buckets, so a bucket's width is at most 12.5% of its 
+ * value. All members are updated with atomic operations, so recording 
+ * never blocks and may be done from several threads.
+ */
+typedef struct ec_histogram {
+    osal_uint64_t count;                        //!< \brief Number of recorded values.
+    osal_uint64_t sum;                          //!< \brief Sum of recorded values.
+    osal_uint64_t min;                          //!< \brief Smallest recorded value, UINT64_MAX if empty.
+    osal_uint64_t max;                          //!< \brief Largest recorded value.
+    osal_uint64_t buckets[EC_HISTOGRAM_BUCKETS];//!< \brief Number of values per bucket.
+} ec_histogram_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Clear histogram.
+/*!
+ * \param[out] h       Pointer to histogram.
+ */
+void ec_histogram_reset(ec_histogram_t *h);
+
+//! Record one value.
+/*!
+ * \param[in,out] h    Pointer to histogram.
+ * \param[in] value    Value to record.
+ */
+void ec_histogram_add(ec_histogram_t *h, osal_uint64_t value);
+
+//! Copy histogram and optionally clear it.
+/*!
+ * Each member is taken atomically, values recorded meanwhile are either 
+ * in the copy or remain in the histogram.
+ *
+ * \param[in,out] h    Pointer to histogram.
+ * \param[out] snap    Copy of histogram.
+ * \param[in] reset    Clear histogram while copying.
+ */
+void ec_histogram_snapshot(ec_histogram_t *h, ec_histogram_t *snap, int reset);
+
+//! Get value at percentile.
+/*!
+ * \param[in] h        Pointer to histogram.
+ * \param[in] percent  Percentile, 0 to 100.
+ *
+ * \return Upper limit of the bucket holding the percentile, clamped to the
+ * largest recorded value, 0 if empty.
+ */
+osal_uint64_t ec_histogram_percentile(const ec_histogram_t *h, double percent);
+
+//! Get mean value.
+/*!
+ * \param[in] h        Pointer to histogram.
+ *
+ * \return Mean of recorded values, 0 if empty.
+ */
+osal_uint64_t ec_histogram_mean(const ec_histogram_t *h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBETHERCAT_HISTOGRAM_H
+
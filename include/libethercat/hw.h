@@ -45,6 +45,7 @@
 
 #include <libethercat/pool.h>
 #include <libethercat/datagram.h>
+#include <libethercat/capture.h>
 
 #if LIBETHERCAT_BUILD_DEVICE_PIKEOS == 1
 #include <vm_file_types.h>
@@ -124,11 +125,27 @@ typedef struct hw_common {
     osal_uint32_t mtu_size;         //!< mtu size
     osal_mutex_t hw_lock;           //!< transmit lock
 
-    pool_t tx_high;                 //!< high priority datagrams
-    pool_t tx_low;                  //!< low priority datagrams
+    pool_mpsc_t tx_high;            //!< high priority datagrams (lock-free, consumed under hw_lock)
+    pool_mpsc_t tx_low;             //!< low priority datagrams (lock-free, consumed under hw_lock)
 
     pool_entry_t *tx_send[256];     //!< sent datagrams
 
+    ec_frame_t *tx_frame;               //!< \brief Frame currently filled, only valid while holding hw_lock.
+    ec_datagram_t *tx_frame_dg_prev;    //!< \brief Last datagram added to tx_frame.
+    osal_bool_t tx_frame_in_place;      //!< \brief Frame opened with \link hw_tx_frame_open \endlink.
+    osal_uint64_t tx_frame_idx_open;    //!< \brief Frame index when opening tx_frame.
+    osal_uint64_t tx_frame_start_ns;    //!< \brief Time when opening tx_frame.
+
+    osal_uint32_t link_speed_mbps;      //!< \brief Link speed for wire time budget [Mbit/s].
+    osal_uint64_t tx_low_budget_ns;     //!< \brief Wire time budget of one cycle, 0 disables piggybacking.
+    osal_bool_t tx_low_budget_warned;   //!< \brief Cyclic frames exceeding the budget were logged.
+    osal_size_t tx_cycle_wire_bytes;    //!< \brief Bytes on wire of frames sent in current cycle.
+    osal_bool_t tx_window;              //!< \brief Send low prio datagrams between cycles.
+    osal_uint64_t tx_window_guard_ns;   //!< \brief Margin to next cycle for frames sent between cycles.
+    osal_uint64_t tx_window_cycle_ns;   //!< \brief Next cycle start while sending between cycles, else 0.
+    osal_bool_t rx_polling;             //!< \brief Device has no receive thread, replies are received by \link hw_rx \endlink.
+    osal_uint64_t frame_rtt_ns;         //!< \brief Peak-hold average round trip time of frames.
+
     osal_uint64_t frame_idx;        //!< \brief frame index number.
     osal_size_t bytes_sent;         //!< \brief Bytes currently sent.
     osal_size_t bytes_last_sent;    //!< \brief Bytes last sent.
@@ -142,6 +159,8 @@ typedef struct hw_common {
 
     osal_uint64_t last_tx_duration_ns;
     osal_uint64_t last_rx_duration_ns;
+
+    ec_capture_t capture;           //!< \brief Frame capture, see \link ec_capture_start \endlink.
 } hw_common_t;                 //!< \brief Hardware struct type. 
 
 #ifdef __cplusplus
@@ -164,6 +183,49 @@ int hw_open(struct hw_common *phw, struct ec *pec);
  */
 int hw_close(struct hw_common *phw);
 
+//! Configure piggybacking of low priority datagrams on cyclic frames.
+/*!
+ * With a budget set, \link hw_tx \endlink, \link hw_tx_high \endlink and
+ * \link hw_tx_frame_close \endlink fill spare room of the cyclic frames 
+ * with queued low priority datagrams (e.g. from \link ec_transceive 
+ * \endlink in SAFEOP/OP) as long as the wire time of all frames of the 
+ * cycle stays within \p budget_ns. Wire time includes preamble, padding, 
+ * FCS and inter frame gap. Datagrams exceeding the budget stay queued for
+ * the next cycle, but at least one is sent per cycle even if the cyclic 
+ * frames alone exceed the budget (logged once). A budget of 0 disables piggybacking, \link hw_tx 
+ * \endlink then sends all low priority datagrams in frames of their own.
+ *
+ * \param[in]   phw             Pointer to hw handle.
+ * \param[in]   budget_ns       Wire time budget of one cycle [ns].
+ * \param[in]   link_speed_mbps Link speed [Mbit/s], 0 keeps current (default 100).
+ */
+void hw_tx_set_low_budget(struct hw_common *phw, osal_uint64_t budget_ns, osal_uint32_t link_speed_mbps);
+
+//! Configure sending of low priority datagrams between cycles.
+/*!
+ * Enabled by default. Not used with devices in polling mode 
+ * (\link hw_common::rx_polling \endlink), their replies would be received 
+ * by the sending thread while holding hw_lock and could delay the next 
+ * cyclic frame. Their low priority datagrams always wait for the next cycle.
+ *
+ * \param[in]   phw             Pointer to hw handle.
+ * \param[in]   enable          Enable sending in the idle time of a cycle.
+ * \param[in]   guard_ns        Margin frames have to return before the next cycle [ns].
+ */
+void hw_tx_set_low_window(struct hw_common *phw, osal_bool_t enable, osal_uint64_t guard_ns);
+
+//! Send low priority datagrams in the idle time before the next cycle.
+/*!
+ * Datagrams are only sent if their frames are expected back before the 
+ * next cycle starts, the others stay queued for the next cycle.
+ *
+ * \param[in]   phw             Pointer to hw handle.
+ *
+ * \retval OSAL_TRUE when at least one frame was sent
+ * \retval OSAL_FALSE when no frame was sent
+ */
+osal_bool_t hw_tx_low_window(struct hw_common *phw);
+
 //! start sending queued ethercat datagrams
 /*!
  * \param phw hardware handle
@@ -185,6 +247,65 @@ int hw_tx_low(struct hw_common *phw);
  */
 int hw_tx(struct hw_common *phw);
 
+//! Open a frame to build cyclic datagrams in place.
+/*!
+ * This is the zero-copy replacement for \link hw_tx_high \endlink. It 
+ * takes the hw lock and starts a new cycle. Cyclic datagrams (process data, 
+ * distributed clocks) queued by the same thread until \link hw_tx_frame_close
+ * \endlink are serialized directly into the device's tx buffer instead of
+ * being copied from their pool entries.
+ *
+ * \param phw hardware handle
+ * \return 0 or error code
+ */
+int hw_tx_frame_open(struct hw_common *phw);
+
+//! Reserve datagram space in frame opened by \link hw_tx_frame_open \endlink.
+/*!
+ * The datagram header is cleared and idx/len are set, the caller has to 
+ * fill cmd, adr and the complete payload.
+ *
+ * \param[in]   phw             Pointer to hw handle.
+ * \param[in]   p_entry         Pool entry with assigned index, used to 
+ *                              dispatch the answer.
+ * \param[in]   payload_len     Datagram payload length.
+ * \param[out]  ppdg            Returns pointer to datagram in frame.
+ *
+ * \return EC_OK or error code
+ */
+int hw_tx_frame_reserve(struct hw_common *phw, pool_entry_t *p_entry, 
+        osal_size_t payload_len, ec_datagram_t **ppdg);
+
+//! Add prebuilt datagrams to frame opened by \link hw_tx_frame_open \endlink.
+/*!
+ * The template is copied as one block. It has to contain \p cnt chained 
+ * datagrams (the last one with next flag cleared) whose indices match 
+ * those of \p p_entries.
+ *
+ * \param[in]   phw             Pointer to hw handle.
+ * \param[in]   tmpl            Prebuilt chained datagrams.
+ * \param[in]   len             Length of \p tmpl in bytes.
+ * \param[in]   p_entries       Pool entries of the datagrams in \p tmpl, in order.
+ * \param[in]   cnt             Number of datagrams in \p tmpl.
+ * \param[out]  pp_data         Returns pointer to the copy of \p tmpl in 
+ *                              frame, used to patch the payloads.
+ *
+ * \return EC_OK or error code
+ */
+int hw_tx_frame_add_template(struct hw_common *phw, const osal_uint8_t *tmpl, osal_size_t len, 
+        pool_entry_t * const *p_entries, osal_size_t cnt, osal_uint8_t **pp_data);
+
+//! Send frame opened by \link hw_tx_frame_open \endlink.
+/*!
+ * Queued high priority datagrams are appended, then low priority ones 
+ * within the budget set by \link hw_tx_set_low_budget \endlink. Then 
+ * the frame is sent and the hw lock is released.
+ *
+ * \param phw hardware handle
+ * \return 0 or error code
+ */
+int hw_tx_frame_close(struct hw_common *phw);
+
 //! start receiving queued ethercat datagrams in polling modes
 /*!
  * \param phw hardware handle
@@ -201,6 +322,89 @@ int hw_rx(struct hw_common *phw);
  */
 osal_bool_t hw_process_rx_frame(struct hw_common *phw, ec_frame_t *pframe);
 
+//! Process a batch of received EtherCAT frames
+/*!
+ * Used by devices which receive several frames at once, e.g. from a 
+ * kernel ring block. The frames are processed in order.
+ *
+ * \param[in]   phw     Pointer to hw handle.
+ * \param[in]   pframes Array of pointers to received EtherCAT frames.
+ * \param[in]   cnt     Number of frames in pframes.
+ *
+ * \return Number of successfully processed frames.
+ */
+osal_size_t hw_process_rx_frames(struct hw_common *phw, ec_frame_t **pframes, osal_size_t cnt);
+
+#if LIBETHERCAT_BUILD_POSIX == 1
+//! Check if a receive thread cpu mask selects an isolated cpu.
+/*!
+ * Devices use this to decide whether their receive thread may busy-poll.
+ *
+ * \param[in]   cpumask     CPU mask of receive thread.
+ *
+ * \return OSAL_TRUE if cpumask selects exactly one cpu which is listed in 
+ * /sys/devices/system/cpu/isolated.
+ */
+osal_bool_t hw_device_cpu_isolated(int cpumask);
+
+//! Split device name and device options.
+/*!
+ * Options are appended to the device name separated by ':', e.g. 
+ * "eth0:polling:rx_timeout_nsec=200000". Known options are \a polling 
+ * (receive inline in send_finished instead of using a receive thread) 
+ * and \a rx_timeout_nsec (maximum time to wait for replies in polling 
+ * mode). Unknown options are ignored.
+ *
+ * \param[in]   devname         Device name with options.
+ * \param[out]  name            Buffer for plain device name.
+ * \param[in]   name_len        Size of \p name.
+ * \param[out]  polling_mode    Set to OSAL_TRUE if \a polling was given.
+ * \param[out]  rx_timeout_ns   Receive timeout if \a rx_timeout_nsec was given.
+ */
+void hw_device_parse_options(const osal_char_t *devname, osal_char_t *name, osal_size_t name_len, 
+        osal_bool_t *polling_mode, osal_uint64_t *rx_timeout_ns);
+
+//! Try to receive without blocking.
+/*!
+ * \param[in]   phw         Pointer to hw handle.
+ *
+ * \return Number of received frames which answered sent frames.
+ */
+typedef osal_size_t (*hw_device_rx_once_t)(struct hw_common *phw);
+
+//! Receive wait predictor of polling devices.
+typedef struct hw_rx_predict {
+    osal_uint64_t srtt_ns;          //!< \brief Smoothed time until first reply arrives.
+    osal_uint64_t rttvar_ns;        //!< \brief Mean deviation of \link srtt_ns \endlink.
+    osal_uint64_t oversleep_ns;     //!< \brief Smoothed time woken up too late by sleep.
+} hw_rx_predict_t;
+
+//! Receive replies on the caller's thread.
+/*!
+ * Used by devices in polling mode from their send_finished. Once a round
+ * trip time was measured the caller sleeps until shortly before the first 
+ * reply is expected (smoothed round trip time minus twice its deviation 
+ * and the learned sleep overshoot) and only spins on \p rx_once from there.
+ * If the predicted idle time is below \link LEC_HW_RX_MIN_SLEEP_NS \endlink
+ * it spins right away. Late replies are waited for in poll() on \p fd
+ * while at least 1 ms is left, otherwise (or if \p fd is negative) by 
+ * spinning. Gives up after \p rx_timeout_ns or when the next cycle is due,
+ * whichever comes first.
+ *
+ * \param[in]   phw             Pointer to hw handle.
+ * \param[in]   fd              File descriptor to poll for incoming frames
+ *                              or -1 if device cannot be polled.
+ * \param[in]   expected        Number of frames sent.
+ * \param[in]   rx_timeout_ns   Maximum time to wait for all replies.
+ * \param[in,out] predict       Receive wait predictor, updated on reception.
+ * \param[in]   rx_once         Non-blocking receive function of device.
+ *
+ * \return Number of received replies.
+ */
+osal_size_t hw_device_poll_rx(struct hw_common *phw, int fd, osal_size_t expected, 
+        osal_uint64_t rx_timeout_ns, hw_rx_predict_t *predict, hw_device_rx_once_t rx_once);
+#endif
+
 //! Enqueue frame to send queue.
 /*!
  * \param[in]   phw         Pointer to hw handle.
@@ -209,6 +413,17 @@ osal_bool_t hw_process_rx_frame(struct hw_common *phw, ec_frame_t *pframe);
  */
 void hw_enqueue(struct hw_common *phw, pool_entry_t *p_entry, pooltype_t pool_type);
 
+//! Remove frame from send queue if it was not sent yet.
+/*!
+ * \param[in]   phw         Pointer to hw handle.
+ * \param[in]   p_entry     Entry to be removed.
+ * \param[in]   pool_type   Remove from high prio or low prio queue.
+ *
+ * \retval EC_OK                   Entry was still queued and is removed.
+ * \retval EC_ERROR_UNAVAILABLE    Entry was not queued (anymore).
+ */
+int hw_dequeue(struct hw_common *phw, pool_entry_t *p_entry, pooltype_t pool_type);
+
 #ifdef __cplusplus
 }
 #endif
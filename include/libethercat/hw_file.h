@@ -59,6 +59,7 @@ typedef struct hw_file {
     int frames_send;
 
     uint64_t rx_timeout_ns;
+    hw_rx_predict_t rx_predict;             //!< \brief Receive wait predictor in polling mode.
     pooltype_t last_pool_type;
 } hw_file_t;
 
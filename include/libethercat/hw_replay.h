@@ -0,0 +1,120 @@
+/**
+ * \file hw_replay.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief recorded session replay hardware access functions
+ *
+ */
+
+/*
+ * This file is part of libethercat.
+ *
+ * libethercat is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * libethercat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with libethercat (LICENSE.LGPL-V3); if not, write 
+ * to the Free Software Foundation, Inc., 51 Franklin Street, Fifth 
+ * Floor, Boston, MA  02110-1301, USA.
+ * 
+ * Please note that the use of the EtherCAT technology, the EtherCAT 
+ * brand name and the EtherCAT logo is only permitted if the property 
+ * rights of Beckhoff Automation GmbH are observed. For further 
+ * information please contact Beckhoff Automation GmbH & Co. KG, 
+ * Hülshorstweg 20, D-33415 Verl, Germany (www.beckhoff.com) or the 
+ * EtherCAT Technology Group, Ostendstraße 196, D-90482 Nuremberg, 
+ * Germany (ETG, www.ethercat.org).
+ *
+ */
+
+#ifndef LIBETHERCAT_HW_REPLAY_H
+#define LIBETHERCAT_HW_REPLAY_H
+
+#include <libethercat/ec.h>
+#include <libethercat/hw.h>
+
+#define HW_REPLAY_FRAME_SIZE    2048u   //!< \brief Size of one frame buffer.
+#define HW_REPLAY_MAX_PENDING   16u     //!< \brief Replies buffered until \link hw_rx \endlink.
+#define HW_REPLAY_LOOKAHEAD     64u     //!< \brief Recorded datagrams searched for a match.
+#define HW_REPLAY_MAX_IN_FLIGHT 32u     //!< \brief Recorded packets searched for the reply of a request, on open.
+
+struct hw_replay_dg;
+struct hw_replay_key;
+
+typedef struct hw_replay {
+    struct hw_common common;
+
+    const osal_uint8_t *rec;        //!< \brief Mapped recording.
+    osal_size_t rec_size;           //!< \brief Size of recording.
+    osal_size_t rec_first;          //!< \brief Offset of first packet record.
+    osal_bool_t rec_pcapng;         //!< \brief Recording is pcapng, otherwise pcap.
+
+    struct hw_replay_dg *dgs;       //!< \brief Recorded datagrams with reply, in recorded order.
+    osal_size_t dg_cnt;             //!< \brief Number of recorded datagrams with reply.
+    struct hw_replay_key *keys;     //!< \brief Hash table of dgs by command, address and length.
+    osal_size_t key_mask;           //!< \brief Number of hash table slots minus 1.
+    osal_size_t index_size;         //!< \brief Mapped size of dgs and keys.
+
+    osal_size_t cursor;             //!< \brief Oldest datagram in search window.
+    osal_uint32_t pass;             //!< \brief Pass over the recording, incremented when starting over.
+
+    osal_uint8_t send_frame[HW_REPLAY_FRAME_SIZE];                      //!< \brief Static send frame.
+    osal_uint8_t pending[HW_REPLAY_MAX_PENDING][HW_REPLAY_FRAME_SIZE];  //!< \brief Replies to sent frames.
+    osal_size_t pending_cnt;        //!< \brief Number of replies in pending.
+    pooltype_t last_pool_type;      //!< \brief Pool type of last sent frame.
+
+    osal_uint64_t replayed;         //!< \brief Datagrams answered from recording.
+    osal_uint64_t mismatches;       //!< \brief Datagrams not found in recording, answered with wkc 0.
+    osal_uint64_t wraps;            //!< \brief Times the recording was restarted.
+} hw_replay_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Opens recorded session as EtherCAT hw device.
+/*!
+ * Every sent datagram is answered with the reply to the next recorded 
+ * request having the same command, address and length. Requests are 
+ * paired with their replies by index, so addresses changed by the slaves
+ * (auto increment, broadcast) still match as sent. Payload, interrupt 
+ * field and working counter are taken from the recording, the index is 
+ * kept from the sent datagram. Datagrams not found within \link 
+ * HW_REPLAY_LOOKAHEAD \endlink recorded datagrams are returned unchanged 
+ * (working counter 0). At the end the recording starts over. All 
+ * requests are paired with their replies once on open, a sent datagram is 
+ * then looked up in that index.
+ *
+ * The recording may be pcap or pcapng in host byte order, e.g. written by
+ * \link ec_capture_start \endlink or tcpdump, and has to contain both 
+ * directions. Replies are recognized by the pcapng direction flag, or by
+ * the locally administered bit in the source address, which EtherCAT 
+ * slaves set.
+ *
+ * The device works in polling mode, replies are processed by \link 
+ * hw_rx \endlink.
+ *
+ * \param[in]   phw_replay  Pointer to replay hw handle. 
+ * \param[in]   pec         Pointer to master structure.
+ * \param[in]   path        Null-terminated path to recording.
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_replay_open(struct hw_replay *phw_replay, struct ec *pec, const osal_char_t *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBETHERCAT_HW_REPLAY_H
+
@@ -52,7 +52,12 @@ typedef struct hw_sock_raw {
     osal_uint8_t send_frame[EC_ETH_FRAME_LEN]; //!< \brief Static send frame.
     osal_uint8_t recv_frame[EC_ETH_FRAME_LEN]; //!< \brief Static receive frame.
 
-    // receiver thread settings
+    osal_bool_t polling_mode;       //!< \brief Receive inline in send_finished, no receiver thread.
+    osal_uint64_t rx_timeout_ns;    //!< \brief Maximum time to wait for replies in polling mode.
+    hw_rx_predict_t rx_predict;     //!< \brief Receive wait predictor in polling mode.
+    osal_size_t frames_send;        //!< \brief Frames sent since last send_finished in polling mode.
+
+    // receiver thread settings in non-polling mode
     osal_task_t rxthread;           //!< receiver thread handle
     int rxthreadrunning;            //!< receiver thread running flag
 } hw_sock_raw_t;
@@ -65,7 +70,9 @@ extern "C" {
 /*!
  * \param[in]   phw         Pointer to hw handle. 
  * \param[in]   pec                 Pointer to master structure.
- * \param[in]   devname     Null-terminated string to EtherCAT hw device name.
+ * \param[in]   devname     Null-terminated string to EtherCAT hw device name, 
+ *                          optionally followed by options, e.g. "eth0:polling"
+ *                          (see \link hw_device_parse_options \endlink).
  * \param[in]   prio        Priority for receiver thread.
  * \param[in]   cpu_mask    CPU mask for receiver thread.
  *
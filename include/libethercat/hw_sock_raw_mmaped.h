@@ -52,14 +52,29 @@ typedef struct hw_sock_raw_mmaped {
     osal_uint8_t send_frame[EC_ETH_FRAME_LEN]; //!< \brief Static send frame.
     osal_uint8_t recv_frame[EC_ETH_FRAME_LEN]; //!< \brief Static receive frame.
     
-    int mmap_packets;               //!< \brief Doing mmap packets.
+    int mmap_packets;               //!< \brief Number of frames in TX ring.
+    osal_size_t mmap_size;          //!< \brief Size of mapped rings.
     osal_char_t *rx_ring;           //!< kernel mmap receive buffers
     osal_char_t *tx_ring;           //!< kernel mmap send buffers
 
-    osal_off_t rx_ring_offset;      //!< \brief Offset in RX ring.
+    osal_uint32_t rx_block_size;    //!< \brief Size of a block in RX ring.
+    osal_uint32_t rx_block_nr;      //!< \brief Number of blocks in RX ring.
+    osal_uint32_t rx_frame_size;    //!< \brief Size of a frame in RX ring.
+    osal_uint32_t rx_frame_nr;      //!< \brief Number of frames in RX ring.
+    osal_uint32_t tx_frame_size;    //!< \brief Size of a frame in TX ring.
+
+    osal_off_t rx_ring_offset;      //!< \brief Current frame (or block) in RX ring.
     osal_off_t tx_ring_offset;      //!< \brief Offset in TX ring.
+    osal_uint32_t tx_pending;       //!< \brief Frames queued to TX ring since last kick.
+
+    osal_bool_t rx_busy_poll;       //!< \brief Busy-poll RX ring without syscalls.
+
+    osal_bool_t polling_mode;       //!< \brief Receive inline in send_finished, no receiver thread.
+    osal_uint64_t rx_timeout_ns;    //!< \brief Maximum time to wait for replies in polling mode.
+    hw_rx_predict_t rx_predict;     //!< \brief Receive wait predictor in polling mode.
+    osal_size_t frames_send;        //!< \brief Frames sent since last send_finished.
 
-    // receiver thread settings
+    // receiver thread settings in non-polling mode
     osal_task_t rxthread;           //!< receiver thread handle
     int rxthreadrunning;            //!< receiver thread running flag
 } hw_sock_raw_mmaped_t;
@@ -72,7 +87,9 @@ extern "C" {
 /*!
  * \param[in]   phw_sock_raw_mmaped     Pointer to sock_raw_mmmaped hw handle. 
  * \param[in]   pec                     Pointer to master struct.
- * \param[in]   devname                 Null-terminated string to EtherCAT hw device name.
+ * \param[in]   devname                 Null-terminated string to EtherCAT hw device name, 
+ *                                      optionally followed by options, e.g. "eth0:polling"
+ *                                      (see \link hw_device_parse_options \endlink).
  * \param[in]   prio                    Priority for receiver thread.
  * \param[in]   cpu_mask                CPU mask for receiver thread.
  *
@@ -0,0 +1,122 @@
+/**
+ * \file hw_uring.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief io_uring hardware access functions
+ *
+ */
+
+/*
+ * This file is part of libethercat.
+ *
+ * libethercat is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * libethercat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with libethercat (LICENSE.LGPL-V3); if not, write 
+ * to the Free Software Foundation, Inc., 51 Franklin Street, Fifth 
+ * Floor, Boston, MA  02110-1301, USA.
+ * 
+ * Please note that the use of the EtherCAT technology, the EtherCAT 
+ * brand name and the EtherCAT logo is only permitted if the property 
+ * rights of Beckhoff Automation GmbH are observed. For further 
+ * information please contact Beckhoff Automation GmbH & Co. KG, 
+ * Hülshorstweg 20, D-33415 Verl, Germany (www.beckhoff.com) or the 
+ * EtherCAT Technology Group, Ostendstraße 196, D-90482 Nuremberg, 
+ * Germany (ETG, www.ethercat.org).
+ *
+ */
+
+#ifndef LIBETHERCAT_HW_URING_H
+#define LIBETHERCAT_HW_URING_H
+
+#include <libethercat/ec.h>
+#include <libethercat/hw.h>
+#include <libosal/task.h>
+#include <libosal/mutex.h>
+
+#define HW_URING_FRAME_SIZE     2048u   //!< \brief Size of one frame buffer.
+#define HW_URING_RX_FRAMES      16u     //!< \brief Number of reads kept armed in the ring.
+#define HW_URING_TX_FRAMES      32u     //!< \brief Number of frames which may be in flight for sending.
+#define HW_URING_ENTRIES        64u     //!< \brief Number of submission queue entries (power of 2).
+
+//! io_uring submission and completion queue mapped from kernel.
+typedef struct hw_uring_queue {
+    osal_uint32_t *head;            //!< \brief Consumer index.
+    osal_uint32_t *tail;            //!< \brief Producer index.
+    osal_uint32_t *flags;           //!< \brief Queue flags, e.g. IORING_SQ_NEED_WAKEUP.
+    osal_uint32_t *array;           //!< \brief Submission queue index array (SQ only).
+    void *entries;                  //!< \brief Completion queue entries (CQ only).
+    osal_uint32_t mask;             //!< \brief Number of entries - 1.
+    void *map;                      //!< \brief Mapped area.
+    osal_size_t map_size;           //!< \brief Size of mapped area.
+} hw_uring_queue_t;
+
+typedef struct hw_uring {
+    struct hw_common common;
+
+    int fd;                         //!< \brief Raw socket or device file descriptor.
+    int ring_fd;                    //!< \brief io_uring file descriptor.
+
+    hw_uring_queue_t sq;            //!< \brief Submission queue.
+    hw_uring_queue_t cq;            //!< \brief Completion queue.
+    void *sqes;                     //!< \brief Submission queue entries.
+    osal_size_t sqes_size;          //!< \brief Size of mapped submission queue entries.
+
+    osal_mutex_t sq_lock;           //!< \brief Serializes access to submission queue.
+    osal_uint32_t sq_tail;          //!< \brief Local submission queue tail, published on flush.
+    osal_uint32_t sq_pending;       //!< \brief Entries queued since last flush.
+    osal_uint32_t rx_queued;        //!< \brief Reads queued but not yet submitted.
+    osal_bool_t sqpoll;             //!< \brief Kernel thread polls submission queue.
+
+    osal_uint8_t *buffers;          //!< \brief RX and TX frame buffers.
+    osal_uint32_t tx_busy[HW_URING_TX_FRAMES];  //!< \brief TX buffer in flight.
+    osal_uint32_t tx_next;                      //!< \brief Next TX buffer to check.
+
+    // receiver thread settings
+    osal_task_t rxthread;           //!< receiver thread handle
+    int rxthreadrunning;            //!< receiver thread running flag
+} hw_uring_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Opens EtherCAT hw device.
+/*!
+ * All frames sent during one cycle and the reads re-armed by the receiver 
+ * thread are submitted with one io_uring_enter call when sending is 
+ * finished. With \p sqpoll set a kernel thread polls the submission queue 
+ * and the cyclic path does not need any syscall. The polling thread spins
+ * on a cpu of its own, so SQPOLL only pays off if one is spare.
+ *
+ * \param[in]   phw_uring   Pointer to uring hw handle. 
+ * \param[in]   pec         Pointer to master struct.
+ * \param[in]   devname     Null-terminated string to EtherCAT hw device name. 
+ *                          Either a network interface (used via raw socket)
+ *                          or the path to a device file starting with '/'.
+ * \param[in]   prio        Priority for receiver thread.
+ * \param[in]   cpu_mask    CPU mask for receiver thread.
+ * \param[in]   sqpoll      Use kernel submission queue polling thread.
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_uring_open(struct hw_uring *phw_uring, ec_t *pec, const osal_char_t *devname, 
+        int prio, int cpumask, osal_bool_t sqpoll);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBETHERCAT_HW_URING_H
+
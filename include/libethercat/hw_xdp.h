@@ -0,0 +1,118 @@
+/**
+ * \file hw_xdp.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief AF_XDP hardware access functions
+ *
+ */
+
+/*
+ * This file is part of libethercat.
+ *
+ * libethercat is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * libethercat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with libethercat (LICENSE.LGPL-V3); if not, write 
+ * to the Free Software Foundation, Inc., 51 Franklin Street, Fifth 
+ * Floor, Boston, MA  02110-1301, USA.
+ * 
+ * Please note that the use of the EtherCAT technology, the EtherCAT 
+ * brand name and the EtherCAT logo is only permitted if the property 
+ * rights of Beckhoff Automation GmbH are observed. For further 
+ * information please contact Beckhoff Automation GmbH & Co. KG, 
+ * Hülshorstweg 20, D-33415 Verl, Germany (www.beckhoff.com) or the 
+ * EtherCAT Technology Group, Ostendstraße 196, D-90482 Nuremberg, 
+ * Germany (ETG, www.ethercat.org).
+ *
+ */
+
+#ifndef LIBETHERCAT_HW_XDP_H
+#define LIBETHERCAT_HW_XDP_H
+
+#include <libethercat/ec.h>
+#include <libethercat/hw.h>
+#include <libosal/task.h>
+
+#define HW_XDP_FRAME_SIZE   2048u   //!< \brief Size of one UMEM frame.
+#define HW_XDP_RX_FRAMES    256u    //!< \brief Number of UMEM frames used for receiving (power of 2).
+#define HW_XDP_TX_FRAMES    256u    //!< \brief Number of UMEM frames used for sending (power of 2).
+
+//! AF_XDP ring mapped from kernel.
+typedef struct hw_xdp_ring {
+    osal_uint32_t *producer;        //!< \brief Producer index.
+    osal_uint32_t *consumer;        //!< \brief Consumer index.
+    osal_uint32_t *flags;           //!< \brief Ring flags, e.g. XDP_RING_NEED_WAKEUP.
+    void *ring;                     //!< \brief Descriptors or UMEM addresses.
+    osal_uint32_t mask;             //!< \brief Number of entries - 1.
+    void *map;                      //!< \brief Mapped area.
+    osal_size_t map_size;           //!< \brief Size of mapped area.
+} hw_xdp_ring_t;
+
+typedef struct hw_xdp {
+    struct hw_common common;
+
+    int sockfd;                     //!< \brief AF_XDP socket file descriptor.
+    int prog_fd;                    //!< \brief XDP program redirecting EtherCAT frames.
+    int map_fd;                     //!< \brief XSKMAP holding sockfd.
+    int link_fd;                    //!< \brief Link of XDP program to interface.
+    int ifindex;                    //!< \brief Interface index.
+    osal_uint32_t queue_id;         //!< \brief Interface queue bound to socket.
+
+    osal_uint8_t *umem;             //!< \brief UMEM shared by RX and TX frames.
+    osal_size_t umem_size;          //!< \brief Size of UMEM.
+
+    hw_xdp_ring_t fill;             //!< \brief UMEM fill ring, RX frames given to kernel.
+    hw_xdp_ring_t comp;             //!< \brief UMEM completion ring, TX frames returned by kernel.
+    hw_xdp_ring_t rx;               //!< \brief RX ring.
+    hw_xdp_ring_t tx;               //!< \brief TX ring.
+
+    osal_uint64_t tx_free[HW_XDP_TX_FRAMES];    //!< \brief Free TX frame addresses in UMEM.
+    osal_uint32_t tx_free_cnt;                  //!< \brief Number of free TX frames.
+    osal_uint32_t tx_pending;                   //!< \brief Frames queued to TX ring since last kick.
+
+    osal_bool_t zero_copy;          //!< \brief Socket bound in zero-copy mode.
+    osal_bool_t need_wakeup;        //!< \brief Kernel signals when it needs a wakeup syscall.
+    osal_bool_t rx_busy_poll;       //!< \brief Busy-poll RX ring.
+
+    // receiver thread settings
+    osal_task_t rxthread;           //!< receiver thread handle
+    int rxthreadrunning;            //!< receiver thread running flag
+} hw_xdp_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Opens EtherCAT hw device.
+/*!
+ * Loads a small XDP program to the interface which redirects EtherCAT 
+ * frames from queue 0 to an AF_XDP socket. Native XDP with zero-copy is 
+ * tried first, generic XDP in copy mode is used as fallback (e.g. veth).
+ *
+ * \param[in]   phw_xdp     Pointer to xdp hw handle. 
+ * \param[in]   pec         Pointer to master struct.
+ * \param[in]   devname     Null-terminated string to EtherCAT hw device name.
+ * \param[in]   prio        Priority for receiver thread.
+ * \param[in]   cpu_mask    CPU mask for receiver thread.
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_xdp_open(struct hw_xdp *phw_xdp, ec_t *pec, const osal_char_t *devname, int prio, int cpumask);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBETHERCAT_HW_XDP_H
+
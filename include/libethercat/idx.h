@@ -40,30 +40,55 @@
 #ifndef LIBETHERCAT_IDX_H
 #define LIBETHERCAT_IDX_H
 
-#include <libosal/queue.h>
-
 #include <libosal/types.h>
 #include <libosal/binary_semaphore.h>
-#include <libosal/mutex.h>
+#include <libosal/timer.h>
 
 #include "libethercat/common.h"
 
 #define LEC_MAX_INDEX   256
+#define LEC_INDEX_WORDS (LEC_MAX_INDEX / 64)    //!< \brief 64-bit words in index bitmaps.
+#define LEC_MIN_INDEX_COMMON    (64u)           //!< \brief Indices never reserved for cyclic datagrams.
+
+_Static_assert(LEC_MAX_INDEX_CYCLIC <= (LEC_MAX_INDEX - LEC_MIN_INDEX_COMMON), 
+        "LEC_MAX_INDEX_CYCLIC leaves too few indices for acyclic datagrams");
+
+//! Completion waiter for synchronous access.
+/*!
+ * On Linux this is a futex word which is posted from the receive thread 
+ * with a single atomic exchange. The waiting thread spins for an adaptive 
+ * time before it goes to sleep in the kernel. On other platforms a libosal 
+ * binary semaphore is used.
+ */
+typedef struct idx_waiter {
+#if defined(__linux__)
+    osal_uint32_t state;                //!< \brief Futex word, idle, posted or sleeping.
+#else
+    osal_binary_semaphore_t sem;        //!< \brief Waiter semaphore.
+#endif
+} idx_waiter_t;
 
 //! index entry
 typedef struct idx_entry {
     osal_uint8_t idx;                   //!< \brief Datagram index.
-    osal_binary_semaphore_t waiter;     //!< \brief Waiter semaphore for synchronous access.
-
-    TAILQ_ENTRY(idx_entry) qh;          //!< \brief Queue handle
+    idx_waiter_t waiter;                //!< \brief Completion waiter for synchronous access.
 } idx_entry_t;
-TAILQ_HEAD(idx_entry_queue, idx_entry);
 
 //! index queue
+/*!
+ * The free indices are kept in a bitmap which is modified with atomic 
+ * operations only, so getting and returning indices never blocks. The 
+ * first \link LEC_MAX_INDEX_CYCLIC \endlink indices are reserved for 
+ * cyclic datagrams. The search for a free index starts behind the one 
+ * handed out last, so a returned index is not reused before all others 
+ * of its range and late replies can not complete a newer datagram.
+ */
 typedef struct idx_queue {
-    osal_mutex_t lock;                  //!< \brief Queue lock, prevent concurrent queue access.
-    idx_entry_t entries[LEC_MAX_INDEX]; //!< \brief Static queue entries, do not use directly.
-    struct idx_entry_queue q;           //!< \brief The head of the index queue.
+    osal_uint64_t free_map[LEC_INDEX_WORDS];    //!< \brief Bitmap of free indices, bit set if free.
+    osal_uint64_t cyclic_map[LEC_INDEX_WORDS];  //!< \brief Bitmap of indices reserved for cyclic datagrams.
+    osal_uint32_t next[2];                      //!< \brief Index to start search at, common and cyclic range.
+    idx_entry_t entries[LEC_MAX_INDEX];         //!< \brief Static queue entries, do not use directly.
+    osal_uint64_t spin_ns;                      //!< \brief Current adaptive spin time of \link ec_index_wait \endlink.
 } idx_queue_t;
 
 #ifdef __cplusplus
@@ -90,6 +115,8 @@ void ec_index_deinit(idx_queue_t *idx_q);
 
 //! Get next free index entry.
 /*!
+ * Indices reserved for cyclic datagrams are never returned.
+ *
  * \param[in]   idx_q   Pointer to index queue.
  * \param[out]  entry   Return entry of next free index.
  *
@@ -97,6 +124,18 @@ void ec_index_deinit(idx_queue_t *idx_q);
  */
 int ec_index_get(idx_queue_t *idx_q, struct idx_entry **entry);
 
+//! Get next free index entry for a cyclic datagram.
+/*!
+ * Takes an index from the reserved range first and falls back to the 
+ * common range if all reserved indices are in use.
+ *
+ * \param[in]   idx_q   Pointer to index queue.
+ * \param[out]  entry   Return entry of next free index.
+ *
+ * \return EC_OK on succes, otherwise error code
+ */
+int ec_index_get_cyclic(idx_queue_t *idx_q, struct idx_entry **entry);
+
 //! Returns index entry
 /*!
  * \param[in]  idx_q    Pointer to index queue.
@@ -104,6 +143,28 @@ int ec_index_get(idx_queue_t *idx_q, struct idx_entry **entry);
  */
 void ec_index_put(idx_queue_t *idx_q, struct idx_entry *entry);
 
+//! Signal completion of index entry.
+/*!
+ * Called from the receive path when the answer for a synchronous 
+ * datagram has arrived. Wakes up a thread in \link ec_index_wait \endlink.
+ *
+ * \param[in]  entry    Index entry to signal.
+ */
+void ec_index_complete(struct idx_entry *entry);
+
+//! Wait for completion of index entry.
+/*!
+ * Spins up to the adaptive spin time of the index queue and then sleeps 
+ * until \link ec_index_complete \endlink is called or the timeout expires.
+ *
+ * \param[in]  idx_q    Pointer to index queue.
+ * \param[in]  entry    Index entry to wait for.
+ * \param[in]  timeout  Absolute timeout.
+ *
+ * \return EC_OK on completion, EC_ERROR_TIMEOUT on timeout, otherwise error code
+ */
+int ec_index_wait(idx_queue_t *idx_q, struct idx_entry *entry, osal_timer_t *timeout);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,146 @@
+/**
+ * \file log.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief deferred logging
+ *
+ */
+
+/*
+ * This file is part of libethercat.
+ *
+ * libethercat is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * libethercat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with libethercat (LICENSE.LGPL-V3); if not, write 
+ * to the Free Software Foundation, Inc., 51 Franklin Street, Fifth 
+ * Floor, Boston, MA  02110-1301, USA.
+ * 
+ * Please note that the use of the EtherCAT technology, the EtherCAT 
+ * brand name and the EtherCAT logo is only permitted if the property 
+ * rights of Beckhoff Automation GmbH are observed. For further 
+ * information please contact Beckhoff Automation GmbH & Co. KG, 
+ * Hülshorstweg 20, D-33415 Verl, Germany (www.beckhoff.com) or the 
+ * EtherCAT Technology Group, Ostendstraße 196, D-90482 Nuremberg, 
+ * Germany (ETG, www.ethercat.org).
+ *
+ */
+
+#ifndef LIBETHERCAT_LOG_H
+#define LIBETHERCAT_LOG_H
+
+#include <stdarg.h>
+
+#include <libosal/types.h>
+#include <libosal/task.h>
+
+#include "libethercat/common.h"
+#include "libethercat/ring.h"
+
+#define EC_LOG_MAX_ARGS     (12u)   //!< \brief Arguments stored per deferred message.
+#define EC_LOG_STR_SIZE     (256u)  //!< \brief Bytes for copied string arguments per deferred message.
+#define EC_LOG_PRE_SIZE     (21u)   //!< \brief Bytes for message prefix.
+
+struct ec;
+
+//! Deferred log message.
+/*!
+ * Holds the format pointer and the raw arguments, formatting is done by
+ * the drain task. String arguments are copied, as they may not live 
+ * long enough. Messages which can not be stored this way are formatted 
+ * right away into \link str \endlink.
+ */
+typedef struct ec_log_record {
+    osal_uint64_t seq;                      //!< \brief Sequence number of ring slot, has to be first.
+    int lvl;                                //!< \brief Log level.
+    osal_bool_t rendered;                   //!< \brief Message already formatted into str.
+    const osal_char_t *format;              //!< \brief Format string, has to be static.
+    osal_char_t pre[EC_LOG_PRE_SIZE];       //!< \brief Message prefix.
+    osal_uint64_t args[EC_LOG_MAX_ARGS];    //!< \brief Raw argument values.
+    osal_char_t str[EC_LOG_STR_SIZE];       //!< \brief Copied strings or formatted message.
+} ec_log_record_t;
+
+//! Ring of deferred log messages.
+/*!
+ * Bounded lock-free ring, any thread may add messages without blocking, 
+ * if full the message is dropped and counted. One drain task formats and 
+ * outputs them.
+ */
+typedef struct ec_log_ring {
+    ec_ring_t ring;                                 //!< \brief Positions of producers and drain task.
+    osal_uint64_t dropped;                          //!< \brief Messages dropped since last drained.
+    int running;                                    //!< \brief Messages are deferred.
+    osal_task_t drain_tid;                          //!< \brief Drain task.
+    ec_log_record_t records[LEC_LOG_RING_SIZE];     //!< \brief Message slots.
+} ec_log_ring_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Start deferred logging.
+/*!
+ * From now on \link ec_log \endlink only stores the format pointer and 
+ * the arguments, a low priority task formats and outputs the messages. 
+ * Format strings have to be static.
+ *
+ * \param[in] pec           Pointer to EtherCAT master structure, 
+ *                          which you got from \link ec_open \endlink.
+ *
+ * \retval EC_OK                    On success.
+ * \retval EC_ERROR_UNAVAILABLE     Drain task could not be created.
+ */
+int ec_log_deferred_start(struct ec *pec);
+
+//! Stop deferred logging.
+/*!
+ * Outputs all pending messages, afterwards messages are formatted 
+ * synchronously again.
+ *
+ * \param[in] pec           Pointer to EtherCAT master structure, 
+ *                          which you got from \link ec_open \endlink.
+ */
+void ec_log_deferred_stop(struct ec *pec);
+
+//! Store message in ring.
+/*!
+ * \param[in] pec           Pointer to EtherCAT master structure.
+ * \param[in] lvl           Log level of message.
+ * \param[in] pre           String prepended to message.
+ * \param[in] format        Static format string.
+ * \param[in] args          Format arguments.
+ *
+ * \retval EC_OK                    Message stored or dropped.
+ * \retval EC_ERROR_UNAVAILABLE     Deferred logging not running.
+ */
+int ec_log_deferred_push(struct ec *pec, int lvl, const osal_char_t *pre, 
+        const osal_char_t *format, va_list args);
+
+//! Output formatted message.
+/*!
+ * Passes the message to \link ec::ec_log_func \endlink or the default 
+ * log function.
+ *
+ * \param[in] pec           Pointer to EtherCAT master structure.
+ * \param[in] lvl           Log level of message.
+ * \param[in] msg           Message including prefix.
+ */
+void ec_log_output(struct ec *pec, int lvl, const osal_char_t *msg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBETHERCAT_LOG_H
+
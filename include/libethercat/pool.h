@@ -58,11 +58,17 @@
  */
 
 #define LEC_MAX_POOL_DATA_SIZE      (1600)      //!< \brief Maximum data size of ony pool entry.
+#define LEC_POOL_CACHELINE_SIZE     (64)        //!< \brief Cache line size used to separate producer and consumer side.
 
 // forward declaration
 struct ec; 
 struct ec_datagram;
 
+//! \brief Link handle of lock-free MPSC queues.
+typedef struct pool_mpsc_node {
+    struct pool_mpsc_node *next;                            //!< \brief Next node in queue.
+} pool_mpsc_node_t;                                         //!< \brief MPSC node type.
+
 //! \brief Pool queue entry. 
 typedef struct pool_entry {
     void (*user_cb)(struct ec *pec, struct pool_entry *p_entry, struct ec_datagram *p_dg);  //!< \brief User callback.
@@ -71,8 +77,10 @@ typedef struct pool_entry {
                                                             
     osal_uint64_t send_idx;
     osal_timer_t send_timestamp;
+    osal_uint64_t window_cycle_ns;                          //!< \brief Next cycle start if sent between cycles, else 0.
 
     TAILQ_ENTRY(pool_entry) qh;                             //!< \brief Queue handle of pool objects.
+    pool_mpsc_node_t mpsc_qh;                               //!< \brief Queue handle of lock-free MPSC queues.
     
     osal_uint8_t data[LEC_MAX_POOL_DATA_SIZE];              //!< \brief Data entry.
 } pool_entry_t;                                             //!< \breif Pool entry type.
@@ -87,6 +95,22 @@ typedef struct pool {
     osal_mutex_t _pool_lock;                                //!< \brief Pool lock.
 } pool_t;                                                   //!< \brief Pool type.
 
+//! \brief Lock-free multi-producer/single-consumer queue.
+/*!
+ * Intrusive queue of pool entries. Producers only need one atomic exchange 
+ * to enqueue an entry and never block, so it is safe to feed it from any 
+ * number of threads while the (single) consumer drains it. Consumer side
+ * functions (\link pool_mpsc_get \endlink, \link pool_mpsc_remove \endlink) 
+ * have to be serialized by the caller.
+ */
+typedef struct pool_mpsc {
+    pool_mpsc_node_t *head                                  //!< \brief Last enqueued node, written by producers.
+        __attribute__((aligned(LEC_POOL_CACHELINE_SIZE)));
+    pool_mpsc_node_t *tail                                  //!< \brief Next node to dequeue, owned by consumer.
+        __attribute__((aligned(LEC_POOL_CACHELINE_SIZE)));
+    pool_mpsc_node_t stub;                                  //!< \brief Stub node, queue is never empty.
+} pool_mpsc_t;                                              //!< \brief MPSC queue type.
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -153,6 +177,68 @@ void pool_put(pool_t *pp, pool_entry_t *entry);
  */
 void pool_put_head(pool_t *pp, pool_entry_t *entry);
 
+//! \brief Initialize a lock-free MPSC queue.
+/*!
+ * \param[in]   pq          Pointer to queue.
+ *
+ * \retval  EC_OK           On success.
+ */
+int pool_mpsc_open(pool_mpsc_t *pq);
+
+//! \brief Destroys a lock-free MPSC queue.
+/*!
+ * Entries still queued are dropped, the queue does not own them.
+ *
+ * \param[in]   pq          Pointer to queue.
+ *
+ * \retval  EC_OK           On success.
+ */
+int pool_mpsc_close(pool_mpsc_t *pq);
+
+//! \brief Enqueue entry, may be called concurrently from any thread.
+/*!
+ * \param[in]   pq          Pointer to queue.
+ * \param[in]   entry       Entry to enqueue.
+ */
+void pool_mpsc_put(pool_mpsc_t *pq, pool_entry_t *entry);
+
+//! \brief Dequeue oldest entry, consumer side only.
+/*!
+ * \param[in]   pq          Pointer to queue.
+ * \param[out]  entry       Returns pointer to pool entry.
+ *
+ * \retval  EC_OK                   On success.
+ * \retval  EC_ERROR_UNAVAILABLE    Queue is empty (or the only remaining 
+ *                                  entry is still being linked by a producer).
+ */
+int pool_mpsc_get(pool_mpsc_t *pq, pool_entry_t **entry);
+
+//! \brief Get oldest entry without dequeuing it, consumer side only.
+/*!
+ * A following \link pool_mpsc_get \endlink returns the same entry unless 
+ * it fails because a producer is still linking a new entry.
+ *
+ * \param[in]   pq          Pointer to queue.
+ * \param[out]  entry       Returns pointer to pool entry.
+ *
+ * \retval  EC_OK                   On success.
+ * \retval  EC_ERROR_UNAVAILABLE    Queue is empty.
+ */
+int pool_mpsc_peek(pool_mpsc_t *pq, pool_entry_t **entry);
+
+//! \brief Remove entry from queue if it is still queued, consumer side only.
+/*!
+ * Drains the queue and re-enqueues all other entries. This is meant for 
+ * rare error paths only (e.g. cancelling a datagram after a timeout).
+ *
+ * \param[in]   pq          Pointer to queue.
+ * \param[in]   entry       Entry to remove.
+ *
+ * \retval  EC_OK                   Entry was found and removed.
+ * \retval  EC_ERROR_UNAVAILABLE    Entry was not queued.
+ */
+int pool_mpsc_remove(pool_mpsc_t *pq, pool_entry_t *entry);
+
 #ifdef __cplusplus
 }
 #endif
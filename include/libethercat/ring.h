@@ -0,0 +1,116 @@
+/**
+ * \file ring.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief bounded lock-free ring of fixed size slots
+ *
+ */
+
+/*
+ * This file is part of libethercat.
+ *
+ * libethercat is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * libethercat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with libethercat (LICENSE.LGPL-V3); if not, write 
+ * to the Free Software Foundation, Inc., 51 Franklin Street, Fifth 
+ * Floor, Boston, MA  02110-1301, USA.
+ * 
+ * Please note that the use of the EtherCAT technology, the EtherCAT 
+ * brand name and the EtherCAT logo is only permitted if the property 
+ * rights of Beckhoff Automation GmbH are observed. For further 
+ * information please contact Beckhoff Automation GmbH & Co. KG, 
+ * Hülshorstweg 20, D-33415 Verl, Germany (www.beckhoff.com) or the 
+ * EtherCAT Technology Group, Ostendstraße 196, D-90482 Nuremberg, 
+ * Germany (ETG, www.ethercat.org).
+ *
+ */
+
+#ifndef LIBETHERCAT_RING_H
+#define LIBETHERCAT_RING_H
+
+#include <libosal/types.h>
+
+//! Bounded multi producer, single consumer ring.
+/*!
+ * The slots are kept by the user, each slot has to start with an 
+ * osal_uint64_t sequence number. A producer claims the slot at the 
+ * enqueue position by advancing it, fills it and publishes it by 
+ * bumping the sequence number. The consumer takes published slots in 
+ * order and hands them back to the producers of the next round. If the 
+ * consumer lags a whole ring behind, claiming fails and the producer 
+ * drops its data instead of blocking.
+ */
+typedef struct ec_ring {
+    osal_uint64_t enqueue_pos                       //!< \brief Next slot to fill, written by producers.
+        __attribute__((aligned(64)));
+    osal_uint64_t dequeue_pos                       //!< \brief Next slot to consume, owned by consumer.
+        __attribute__((aligned(64)));
+    osal_uint8_t *slots;                            //!< \brief First slot.
+    osal_size_t slot_size;                          //!< \brief Size of one slot in bytes.
+    osal_uint64_t size;                             //!< \brief Number of slots, power of 2.
+} ec_ring_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Initialize empty ring.
+/*!
+ * Must not be called while producers or consumer are active.
+ *
+ * \param[out] ring       Pointer to ring.
+ * \param[in] slots       Slot array, each slot starting with its sequence number.
+ * \param[in] slot_size   Size of one slot in bytes.
+ * \param[in] size        Number of slots, power of 2.
+ */
+void ec_ring_init(ec_ring_t *ring, void *slots, osal_size_t slot_size, osal_uint64_t size);
+
+//! Claim next free slot (producer).
+/*!
+ * \param[in,out] ring    Pointer to ring.
+ *
+ * \return Claimed slot to be filled and passed to \link ec_ring_publish 
+ * \endlink, NULL if the ring is full.
+ */
+void *ec_ring_claim(ec_ring_t *ring);
+
+//! Hand filled slot to consumer (producer).
+/*!
+ * \param[in,out] slot    Slot returned by \link ec_ring_claim \endlink.
+ */
+void ec_ring_publish(void *slot);
+
+//! Get oldest published slot (consumer).
+/*!
+ * \param[in] ring        Pointer to ring.
+ *
+ * \return Slot to be passed to \link ec_ring_release \endlink, NULL if 
+ * the next slot is not yet published.
+ */
+void *ec_ring_peek(ec_ring_t *ring);
+
+//! Give consumed slot back to producers (consumer).
+/*!
+ * \param[in,out] ring    Pointer to ring.
+ * \param[in,out] slot    Slot returned by \link ec_ring_peek \endlink.
+ */
+void ec_ring_release(ec_ring_t *ring, void *slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBETHERCAT_RING_H
+
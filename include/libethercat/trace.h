@@ -0,0 +1,157 @@
+/**
+ * \file trace.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief cycle timeline tracer
+ *
+ * Records timestamped events of the cyclic path into one ring per thread. 
+ * The rings are dumped as Chrome/Perfetto trace JSON to find out which 
+ * part of a cycle overran. Built only with LIBETHERCAT_TRACE, otherwise 
+ * all trace points compile to nothing.
+ */
+
+/*
+ * This file is part of libethercat.
+ *
+ * libethercat is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * libethercat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with libethercat (LICENSE.LGPL-V3); if not, write 
+ * to the Free Software Foundation, Inc., 51 Franklin Street, Fifth 
+ * Floor, Boston, MA  02110-1301, USA.
+ * 
+ * Please note that the use of the EtherCAT technology, the EtherCAT 
+ * brand name and the EtherCAT logo is only permitted if the property 
+ * rights of Beckhoff Automation GmbH are observed. For further 
+ * information please contact Beckhoff Automation GmbH & Co. KG, 
+ * Hülshorstweg 20, D-33415 Verl, Germany (www.beckhoff.com) or the 
+ * EtherCAT Technology Group, Ostendstraße 196, D-90482 Nuremberg, 
+ * Germany (ETG, www.ethercat.org).
+ *
+ */
+
+#ifndef LIBETHERCAT_TRACE_H
+#define LIBETHERCAT_TRACE_H
+
+#include <libosal/types.h>
+
+#include "libethercat/common.h"
+
+#define EC_TRACE_MAX_THREADS    (16u)   //!< \brief Number of threads which may register for recording.
+
+_Static_assert((LEC_MAX_TRACE_EVENTS & (LEC_MAX_TRACE_EVENTS - 1u)) == 0u, 
+        "LEC_MAX_TRACE_EVENTS has to be a power of two");
+_Static_assert(EC_TRACE_MAX_THREADS < 32u, 
+        "EC_TRACE_MAX_THREADS exceeds the ring bitmask");
+
+//! Traced events.
+typedef enum ec_trace_type {
+    EC_TRACE_CYCLE = 0,         //!< \brief Cycle start, ec_send_process_data.
+    EC_TRACE_SEND_GROUP,        //!< \brief Process data group enqueued, arg is group.
+    EC_TRACE_SEND_DC,           //!< \brief Distributed clocks datagram enqueued.
+    EC_TRACE_FRAME_TX,          //!< \brief Frame sent, arg is frame length.
+    EC_TRACE_FRAME_RX,          //!< \brief Received frame processed, arg is frame length.
+    EC_TRACE_DATAGRAM_CB,       //!< \brief Datagram callback, arg is datagram index.
+    EC_TRACE_USER_CB,           //!< \brief Group user callback, arg is group.
+    EC_TRACE_TYPE_CNT           //!< \brief Number of event types.
+} ec_trace_type_t;
+
+//! Recorded event.
+typedef struct ec_trace_event {
+    osal_uint64_t timestamp;    //!< \brief Time of event [ns].
+    osal_uint32_t arg;          //!< \brief Event argument.
+    osal_uint8_t type;          //!< \brief Event type, see \link ec_trace_type_t \endlink.
+    osal_uint8_t phase;         //!< \brief 'B' begin, 'E' end, 'i' instant.
+} ec_trace_event_t;
+
+//! Event ring of one thread.
+typedef struct ec_trace_ring {
+    osal_uint32_t tid;          //!< \brief Thread id shown in trace.
+    osal_uint64_t head;         //!< \brief Number of events recorded.
+    ec_trace_event_t events[LEC_MAX_TRACE_EVENTS];  //!< \brief Newest events.
+} ec_trace_ring_t;
+
+#if LIBETHERCAT_TRACE == 1
+#define ec_trace_begin(type, arg)   ec_trace_record((type), 'B', (osal_uint32_t)(arg))  //!< \brief Record begin of event.
+#define ec_trace_end(type, arg)     ec_trace_record((type), 'E', (osal_uint32_t)(arg))  //!< \brief Record end of event.
+#define ec_trace_instant(type, arg) ec_trace_record((type), 'i', (osal_uint32_t)(arg))  //!< \brief Record instant event.
+#else
+#define ec_trace_begin(type, arg)
+#define ec_trace_end(type, arg)
+#define ec_trace_instant(type, arg)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Register calling thread for recording.
+/*!
+ * Only events of registered threads are recorded, so short lived or 
+ * per-slave threads (mailbox handlers, startup workers) do not use up 
+ * rings. The receive threads of the hw devices register themselves, the 
+ * application registers its cyclic task. A ring stays with its thread 
+ * until \link ec_trace_unregister_thread \endlink, calling this again is 
+ * a no-op.
+ *
+ * \retval EC_OK                   On success.
+ * \retval EC_ERROR_UNAVAILABLE    Tracer not built in or all \link 
+ *                                 EC_TRACE_MAX_THREADS \endlink rings taken.
+ */
+int ec_trace_register_thread(void);
+
+//! Release ring of calling thread.
+/*!
+ * Has to be called before a registered thread exits, otherwise its ring 
+ * is lost for threads started later (e.g. the receive thread of the next 
+ * hw device opened). The recorded events stay until they are overwritten 
+ * by the next thread using the ring.
+ */
+void ec_trace_unregister_thread(void);
+
+//! Record event.
+/*!
+ * Appends the event to the calling thread's ring, overwriting the oldest 
+ * one if full. Events of threads not registered with \link 
+ * ec_trace_register_thread \endlink are dropped. Use the trace macros 
+ * instead of calling this directly.
+ *
+ * \param[in] type     Event type.
+ * \param[in] phase    'B' begin, 'E' end, 'i' instant.
+ * \param[in] arg      Event argument.
+ */
+void ec_trace_record(ec_trace_type_t type, osal_uint8_t phase, osal_uint32_t arg);
+
+//! Drop all recorded events.
+void ec_trace_reset(void);
+
+//! Write recorded events as Chrome trace JSON.
+/*!
+ * The file can be loaded with chrome://tracing or ui.perfetto.dev. Events 
+ * recorded while dumping may be missing or, if a ring wraps around, 
+ * replaced by newer ones.
+ *
+ * \param[in] path     File to write.
+ *
+ * \retval EC_OK                   On success.
+ * \retval EC_ERROR_UNAVAILABLE    Tracer not built in or file not writable.
+ */
+int ec_trace_dump(const osal_char_t *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBETHERCAT_TRACE_H
+
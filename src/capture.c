@@ -0,0 +1,310 @@
+/**
+ * \file capture.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief frame capture
+ *
+ * Copies all transmitted and received frames into a ring, a background 
+ * task writes them to a pcapng file.
+ */
+
+/*
+ * This file is part of libethercat.
+ *
+ * libethercat is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * libethercat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with libethercat (LICENSE.LGPL-V3); if not, write 
+ * to the Free Software Foundation, Inc., 51 Franklin Street, Fifth 
+ * Floor, Boston, MA  02110-1301, USA.
+ * 
+ * Please note that the use of the EtherCAT technology, the EtherCAT 
+ * brand name and the EtherCAT logo is only permitted if the property 
+ * rights of Beckhoff Automation GmbH are observed. For further 
+ * information please contact Beckhoff Automation GmbH & Co. KG, 
+ * Hülshorstweg 20, D-33415 Verl, Germany (www.beckhoff.com) or the 
+ * EtherCAT Technology Group, Ostendstraße 196, D-90482 Nuremberg, 
+ * Germany (ETG, www.ethercat.org).
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libethercat/config.h>
+#endif
+
+#include "libethercat/capture.h"
+#include "libethercat/hw.h"
+#include "libethercat/ec.h"
+#include "libethercat/error_codes.h"
+
+#include <libosal/timer.h>
+
+#include <assert.h>
+#include <inttypes.h>
+#include <string.h>
+
+#if LIBETHERCAT_BUILD_POSIX == 1
+// cppcheck-suppress misra-c2012-21.6
+#include <stdio.h>
+#endif
+
+#define EC_CAPTURE_WRITER_IDLE_NS   (1000000u)  //!< \brief Writer task sleep time if ring is empty.
+
+#define PCAPNG_BLOCK_SHB            (0x0A0D0D0Au)   //!< \brief Section header block.
+#define PCAPNG_BLOCK_IDB            (0x00000001u)   //!< \brief Interface description block.
+#define PCAPNG_BLOCK_ISB            (0x00000005u)   //!< \brief Interface statistics block.
+#define PCAPNG_BLOCK_EPB            (0x00000006u)   //!< \brief Enhanced packet block.
+#define PCAPNG_BYTE_ORDER_MAGIC     (0x1A2B3C4Du)   //!< \brief Byte order magic.
+#define PCAPNG_LINKTYPE_ETHERNET    (1u)            //!< \brief Link type ethernet.
+#define PCAPNG_OPT_ENDOFOPT         (0u)            //!< \brief End of options.
+#define PCAPNG_OPT_IF_TSRESOL       (9u)            //!< \brief Timestamp resolution.
+#define PCAPNG_OPT_EPB_FLAGS        (2u)            //!< \brief Packet flags, bits 0-1 direction.
+#define PCAPNG_OPT_ISB_IFDROP       (5u)            //!< \brief Packets dropped by interface.
+
+// Copy frame into capture ring.
+void ec_capture_frame(ec_capture_t *cap, const ec_frame_t *pframe, ec_capture_dir_t dir) {
+    assert(cap != NULL);
+    assert(pframe != NULL);
+
+    if (__atomic_load_n(&cap->running, __ATOMIC_ACQUIRE) != 0) {
+        // claim slot, drop frame if ring is full
+        // cppcheck-suppress misra-c2012-11.5
+        ec_capture_record_t *rec = (ec_capture_record_t *)ec_ring_claim(&cap->ring);
+
+        if (rec == NULL) {
+            (void)__atomic_add_fetch(&cap->dropped, 1u, __ATOMIC_RELAXED);
+        } else {
+            rec->timestamp = osal_timer_gettime_nsec();
+            rec->len = pframe->len;
+            rec->caplen = (pframe->len > EC_CAPTURE_SNAPLEN) ? (osal_uint16_t)EC_CAPTURE_SNAPLEN : pframe->len;
+            rec->dir = dir;
+            (void)memcpy(&rec->data[0], pframe, rec->caplen);
+
+            ec_ring_publish(rec);
+        }
+    }
+}
+
+#if LIBETHERCAT_BUILD_POSIX == 1
+//! Write pcapng section header and interface description.
+/*!
+ * \param[in] fp            Output file.
+ *
+ * \retval EC_OK                    On success.
+ * \retval EC_ERROR_UNAVAILABLE     Write failed.
+ */
+static int ec_capture_write_header(FILE *fp) {
+    osal_uint32_t shb[7];
+    shb[0] = PCAPNG_BLOCK_SHB;
+    shb[1] = sizeof(shb);
+    shb[2] = PCAPNG_BYTE_ORDER_MAGIC;
+    shb[3] = 1u;                // major 1, minor 0
+    shb[4] = 0xFFFFFFFFu;       // section length unknown
+    shb[5] = 0xFFFFFFFFu;
+    shb[6] = sizeof(shb);
+
+    osal_uint32_t idb[8];
+    idb[0] = PCAPNG_BLOCK_IDB;
+    idb[1] = sizeof(idb);
+    idb[2] = PCAPNG_LINKTYPE_ETHERNET;
+    idb[3] = EC_CAPTURE_SNAPLEN;
+    idb[4] = PCAPNG_OPT_IF_TSRESOL | (1u << 16u);
+    idb[5] = 9u;                // 10^-9 s
+    idb[6] = PCAPNG_OPT_ENDOFOPT;
+    idb[7] = sizeof(idb);
+
+    int ret = EC_OK;
+    if ((fwrite(shb, sizeof(shb), 1u, fp) != 1u) || (fwrite(idb, sizeof(idb), 1u, fp) != 1u)) {
+        ret = EC_ERROR_UNAVAILABLE;
+    }
+
+    return ret;
+}
+
+//! Write pcapng enhanced packet block.
+/*!
+ * \param[in] fp            Output file.
+ * \param[in] rec           Captured frame.
+ */
+static void ec_capture_write_record(FILE *fp, const ec_capture_record_t *rec) {
+    static const osal_uint8_t pad[4] = { 0u, 0u, 0u, 0u };
+    osal_uint32_t padded = (rec->caplen + 3u) & ~3u;
+
+    osal_uint32_t hdr[7];
+    hdr[0] = PCAPNG_BLOCK_EPB;
+    hdr[1] = sizeof(hdr) + padded + (4u * 4u);
+    hdr[2] = 0u;                // interface id
+    hdr[3] = (osal_uint32_t)(rec->timestamp >> 32u);
+    hdr[4] = (osal_uint32_t)rec->timestamp;
+    hdr[5] = rec->caplen;
+    hdr[6] = rec->len;
+
+    osal_uint32_t trailer[4];
+    trailer[0] = PCAPNG_OPT_EPB_FLAGS | (4u << 16u);
+    trailer[1] = (osal_uint32_t)rec->dir;
+    trailer[2] = PCAPNG_OPT_ENDOFOPT;
+    trailer[3] = hdr[1];
+
+    (void)fwrite(hdr, sizeof(hdr), 1u, fp);
+    (void)fwrite(&rec->data[0], rec->caplen, 1u, fp);
+    if (padded != rec->caplen) {
+        (void)fwrite(pad, padded - rec->caplen, 1u, fp);
+    }
+    (void)fwrite(trailer, sizeof(trailer), 1u, fp);
+}
+
+//! Write pcapng interface statistics with dropped frames.
+/*!
+ * \param[in] fp            Output file.
+ * \param[in] dropped       Frames dropped.
+ */
+static void ec_capture_write_stats(FILE *fp, osal_uint64_t dropped) {
+    osal_uint64_t now = osal_timer_gettime_nsec();
+
+    osal_uint32_t isb[10];
+    isb[0] = PCAPNG_BLOCK_ISB;
+    isb[1] = sizeof(isb);
+    isb[2] = 0u;                // interface id
+    isb[3] = (osal_uint32_t)(now >> 32u);
+    isb[4] = (osal_uint32_t)now;
+    isb[5] = PCAPNG_OPT_ISB_IFDROP | (8u << 16u);
+    (void)memcpy(&isb[6], &dropped, sizeof(dropped));
+    isb[8] = PCAPNG_OPT_ENDOFOPT;
+    isb[9] = sizeof(isb);
+
+    (void)fwrite(isb, sizeof(isb), 1u, fp);
+}
+
+//! Write all pending frames.
+/*!
+ * \param[in] cap           Pointer to capture.
+ *
+ * \return Number of frames written.
+ */
+static osal_size_t ec_capture_drain(ec_capture_t *cap) {
+    FILE *fp = (FILE *)cap->file;
+    osal_size_t cnt = 0u;
+
+    // cppcheck-suppress misra-c2012-11.5
+    ec_capture_record_t *rec = (ec_capture_record_t *)ec_ring_peek(&cap->ring);
+    while (rec != NULL) {
+        ec_capture_write_record(fp, rec);
+        ec_ring_release(&cap->ring, rec);
+        cnt++;
+
+        // cppcheck-suppress misra-c2012-11.5
+        rec = (ec_capture_record_t *)ec_ring_peek(&cap->ring);
+    }
+
+    if (cnt > 0u) {
+        cap->written += cnt;
+        (void)fflush(fp);
+    }
+
+    return cnt;
+}
+
+//! Writer task.
+static void *ec_capture_writer_thread(void *arg) {
+    ec_capture_t *cap = (ec_capture_t *)arg;
+
+    while (__atomic_load_n(&cap->running, __ATOMIC_ACQUIRE) != 0) {
+        if (ec_capture_drain(cap) == 0u) {
+            (void)osal_sleep(EC_CAPTURE_WRITER_IDLE_NS);
+        }
+    }
+
+    return NULL;
+}
+#endif
+
+// Start capturing frames.
+int ec_capture_start(struct hw_common *phw, const osal_char_t *path) {
+    assert(phw != NULL);
+    assert(path != NULL);
+    assert((LEC_CAPTURE_RING_SIZE & (LEC_CAPTURE_RING_SIZE - 1u)) == 0u);
+
+    ec_capture_t *cap = &phw->capture;
+    struct ec *pec = phw->pec;
+    int ret = EC_ERROR_UNAVAILABLE;
+
+#if LIBETHERCAT_BUILD_POSIX == 1
+    if (__atomic_load_n(&cap->running, __ATOMIC_ACQUIRE) != 0) {
+        ret = EC_OK;
+    } else {
+        FILE *fp = fopen(path, "wb");
+        if (fp == NULL) {
+            ec_log(1, "CAPTURE", "cannot open %s\n", path);
+        } else if (ec_capture_write_header(fp) != EC_OK) {
+            ec_log(1, "CAPTURE", "cannot write %s\n", path);
+            (void)fclose(fp);
+        } else {
+            ec_ring_init(&cap->ring, &cap->records[0], sizeof(cap->records[0]), LEC_CAPTURE_RING_SIZE);
+            cap->dropped = 0u;
+            cap->written = 0u;
+            cap->file = fp;
+            __atomic_store_n(&cap->running, 1, __ATOMIC_RELEASE);
+
+            osal_task_attr_t attr;
+            attr.policy = OSAL_SCHED_POLICY_OTHER;
+            attr.priority = 0;
+            attr.affinity = 0xFF;
+            (void)memset(&attr.task_name[0], 0, sizeof(attr.task_name));
+            (void)memcpy(&attr.task_name[0], "ecat.capture", strlen("ecat.capture"));
+            if (osal_task_create(&cap->writer_tid, &attr, ec_capture_writer_thread, cap) != OSAL_OK) {
+                __atomic_store_n(&cap->running, 0, __ATOMIC_RELEASE);
+                ec_log(1, "CAPTURE", "error creating capture writer task!\n");
+                (void)fclose(fp);
+                cap->file = NULL;
+            } else {
+                ec_log(10, "CAPTURE", "capturing frames to %s\n", path);
+                ret = EC_OK;
+            }
+        }
+    }
+#else
+    (void)cap;
+    ec_log(1, "CAPTURE", "frame capture not supported on this platform\n");
+#endif
+
+    return ret;
+}
+
+// Stop capturing frames.
+void ec_capture_stop(struct hw_common *phw) {
+    assert(phw != NULL);
+
+    ec_capture_t *cap = &phw->capture;
+    struct ec *pec = phw->pec;
+
+#if LIBETHERCAT_BUILD_POSIX == 1
+    if (__atomic_load_n(&cap->running, __ATOMIC_ACQUIRE) != 0) {
+        __atomic_store_n(&cap->running, 0, __ATOMIC_RELEASE);
+        (void)osal_task_join(&cap->writer_tid, NULL);
+
+        (void)ec_capture_drain(cap);
+
+        osal_uint64_t dropped = __atomic_load_n(&cap->dropped, __ATOMIC_RELAXED);
+        ec_capture_write_stats((FILE *)cap->file, dropped);
+        (void)fclose((FILE *)cap->file);
+        cap->file = NULL;
+
+        ec_log(10, "CAPTURE", "%" PRIu64 " frames written, %" PRIu64 " dropped\n", cap->written, dropped);
+    }
+#else
+    (void)cap;
+    (void)pec;
+#endif
+}
+
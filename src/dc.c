@@ -67,7 +67,7 @@
 static void anon_cb(struct ec *cb_pec, pool_entry_t *cb_p_entry, ec_datagram_t *cb_p_dg) {      
     (void)cb_pec;
     (void)cb_p_dg;
-    osal_binary_semaphore_post(&cb_p_entry->p_idx->waiter);
+    ec_index_complete(cb_p_entry->p_idx);
 };
 
 // mesaure packet duration (important in case of master_as_ref_clock !)
@@ -92,7 +92,7 @@ static inline osal_uint64_t get_packet_duration(ec_t *pec) {
 
         (void)memset(p_dg, 0, sizeof(ec_datagram_t) + 2u + 2u);
         p_dg->cmd = EC_CMD_BRD;
-        p_dg->idx = 0;
+        p_dg->idx = p_idx->idx;
         p_dg->adr = 0;
         p_dg->len = 2;
         p_dg->irq = 0;
@@ -101,7 +101,7 @@ static inline osal_uint64_t get_packet_duration(ec_t *pec) {
         p_entry->user_cb = anon_cb;
 
         // queue frame and trigger tx
-        pool_put(&pec->phw->tx_high, p_entry);
+        pool_mpsc_put(&pec->phw->tx_high, p_entry);
 
         osal_uint64_t start = osal_timer_gettime_nsec();
         if (hw_tx(pec->phw) == OSAL_TRUE) hw_rx(pec->phw);
@@ -109,8 +109,8 @@ static inline osal_uint64_t get_packet_duration(ec_t *pec) {
         // wait for completion
         osal_timer_t to;
         osal_timer_init(&to, 100000000);
-        int local_ret = osal_binary_semaphore_timedwait(&p_idx->waiter, &to);
-        if (local_ret == OSAL_OK) {
+        int local_ret = ec_index_wait(&pec->idx_q, p_idx, &to);
+        if (local_ret == EC_OK) {
             duration = osal_timer_gettime_nsec() - start;
         } else {
             duration = 0;
@@ -85,6 +85,8 @@ static const char *ec_datagram_cmd_to_string(osal_uint8_t cmd);
 static void ec_decode_datagram_to_string(ec_datagram_t *p_dg, char *out, osal_ssize_t out_len);
 static int64_t signed64_diff(osal_uint64_t a, osal_uint64_t b) __attribute__((unused));
 static int32_t signed32_diff(osal_uint32_t a, osal_uint32_t b) __attribute__((unused));
+static void ec_pd_group_compile(ec_t *pec, osal_uint32_t group);
+static void ec_cyclic_datagram_free(ec_t *pec, ec_cyclic_datagram_t *cdg);
 
 //! calculate signed difference of 64-bit unsigned int's
 /*!
@@ -161,14 +163,19 @@ void _ec_log(ec_t *pec, int lvl, const osal_char_t *pre, const osal_char_t *form
     // format argument list
     va_list args;                   // cppcheck-suppress misra-c2012-17.1
     va_start(args, format);         // cppcheck-suppress misra-c2012-17.1
-    int ret = snprintf(tmp, 512, "%-20.20s: ", pre);
-    (void)vsnprintf(&tmp[ret], 512-ret, format, args);
+    if (ec_log_deferred_push(pec, lvl, pre, format, args) != EC_OK) {
+        int ret = snprintf(tmp, 512, "%-20.20s: ", pre);
+        (void)vsnprintf(&tmp[ret], 512-ret, format, args);
+        ec_log_output(pec, lvl, buf);
+    }
     va_end(args);                   // cppcheck-suppress misra-c2012-17.1
+}
 
+void ec_log_output(ec_t *pec, int lvl, const osal_char_t *msg) {
     if (pec->ec_log_func != NULL) {
-        pec->ec_log_func(pec, lvl, "%s", buf);
+        pec->ec_log_func(pec, lvl, "%s", msg);
     } else {
-        default_log_func(pec, lvl, "%s", buf);
+        default_log_func(pec, lvl, "%s", msg);
     }
 }
 
@@ -184,11 +191,21 @@ int ec_create_pd_groups(ec_t *pec, osal_uint32_t pd_group_cnt) {
 
     (void)ec_destroy_pd_groups(pec);
 
-    pec->pd_group_cnt = pd_group_cnt;
+    // groups are published after init, a running cyclic task may already 
+    // iterate over them
     // cppcheck-suppress misra-c2012-21.3
-    for (osal_uint16_t i = 0; i < pec->pd_group_cnt; ++i) {
+    for (osal_uint16_t i = 0; i < pd_group_cnt; ++i) {
         (void)ec_cyclic_datagram_init(&pec->pd_groups[i].cdg, 10000000);
+        (void)ec_cyclic_datagram_init(&pec->pd_groups[i].cdg_lrd, 10000000);
+        (void)ec_cyclic_datagram_init(&pec->pd_groups[i].cdg_lwr, 10000000);
         (void)ec_cyclic_datagram_init(&pec->pd_groups[i].cdg_lrd_mbx_state, 10000000);
+        for (osal_size_t slot = 0u; slot < LEC_MAX_PD_PIPELINE_DEPTH; ++slot) {
+            (void)ec_cyclic_datagram_init(&pec->pd_groups[i].cdg_pipeline[slot], 10000000);
+            pec->pd_groups[i].pipeline_cycle[slot] = 0u;
+        }
+        for (osal_size_t chunk = 0u; chunk < LEC_MAX_PD_CHUNKS; ++chunk) {
+            (void)ec_cyclic_datagram_init(&pec->pd_groups[i].chunks[chunk].cdg, 10000000);
+        }
 
         pec->pd_groups[i].group             = i;
         pec->pd_groups[i].log               = 0x10000u * ((osal_uint32_t)i+1u);
@@ -210,8 +227,20 @@ int ec_create_pd_groups(ec_t *pec, osal_uint32_t pd_group_cnt) {
         pec->pd_groups[i].wkc_mismatch_cnt_mbx_state = 0;
         pec->pd_groups[i].divisor           = 1;
         pec->pd_groups[i].divisor_cnt       = 0;
+        pec->pd_groups[i].tx_template_len   = 0u;
+        pec->pd_groups[i].tx_template_cnt   = 0u;
+        pec->pd_groups[i].chunk_cnt         = 0u;
+        pec->pd_groups[i].chunk_rx_cnt      = 0u;
+        pec->pd_groups[i].chunk_tx_cycle    = 0u;
+        pec->pd_groups[i].pipeline_depth    = 1u;
+        pec->pd_groups[i].pipeline_slot     = 0u;
+        pec->pd_groups[i].pipeline_tx_cycle = 0u;
+        pec->pd_groups[i].pipeline_rx_cycle = 0u;
+        pec->pd_groups[i].use_triple_buffer = 0;
     }
 
+    pec->pd_group_cnt = pd_group_cnt;
+
     return 0;
 }
 
@@ -237,6 +266,134 @@ void ec_configure_pd_group(ec_t *pec, osal_uint16_t group, int clock_divisor,
     pec->pd_groups[group].cdg.user_cb_arg = user_cb_arg;
 }
 
+//! \brief Configure overlapped cycles of process data group.
+/*!
+ * \param[in] pec           Pointer to EtherCAT master structure.
+ * \param[in] group         Number of group to configure.
+ * \param[in] depth         Number of cycles on the wire at once, 1 disables 
+ *                          overlapped cycles.
+ *
+ * \retval EC_OK                on success
+ * \retval EC_ERROR_UNAVAILABLE if \p depth exceeds \link LEC_MAX_PD_PIPELINE_DEPTH \endlink.
+ */
+int ec_configure_pd_group_pipeline(ec_t *pec, osal_uint16_t group, osal_size_t depth) {
+    assert(pec != NULL);
+    assert(group < pec->pd_group_cnt);
+
+    int ret = EC_OK;
+    ec_pd_group_t *pd = &pec->pd_groups[group];
+
+    if ((depth == 0u) || (depth > LEC_MAX_PD_PIPELINE_DEPTH)) {
+        ec_log(1, "MASTER_CONFIGURE_PD", "group %2d: pipeline depth %" PRIu64 " not supported, "
+                "maximum is %" PRIu64 "\n", group, (osal_uint64_t)depth, (osal_uint64_t)LEC_MAX_PD_PIPELINE_DEPTH);
+        ret = EC_ERROR_UNAVAILABLE;
+    } else {
+        // return datagrams of slots no longer used
+        for (osal_size_t slot = depth; slot < pd->pipeline_depth; ++slot) {
+            ec_cyclic_datagram_free(pec, &pd->cdg_pipeline[slot]);
+        }
+
+        osal_mutex_lock(&pd->cdg.lock);
+        pd->pipeline_depth = depth;
+        pd->pipeline_slot = 0u;
+        osal_mutex_unlock(&pd->cdg.lock);
+    }
+
+    return ret;
+}
+
+//! Reset triple buffer to image.
+static void ec_pd_triple_buffer_init(ec_pd_triple_buffer_t *tb, const osal_uint8_t *pd, osal_size_t len) {
+    for (osal_size_t i = 0u; i < 3u; ++i) {
+        (void)memcpy(&tb->buf[i][0], pd, len);
+    }
+
+    tb->front = 0u;
+    tb->back = 2u;
+    __atomic_store_n(&tb->middle, 1u, __ATOMIC_RELEASE);
+}
+
+//! Publish back buffer of triple buffer, called by producer.
+static void ec_pd_triple_buffer_publish(ec_pd_triple_buffer_t *tb) {
+    osal_uint32_t prev = __atomic_exchange_n(&tb->middle, tb->back | 4u, __ATOMIC_ACQ_REL);
+    tb->back = prev & 3u;
+}
+
+//! Take newest published buffer of triple buffer, called by consumer.
+/*!
+ * \return OSAL_TRUE if front buffer was replaced by a newer one.
+ */
+static osal_bool_t ec_pd_triple_buffer_acquire(ec_pd_triple_buffer_t *tb) {
+    osal_bool_t ret = OSAL_FALSE;
+
+    if ((__atomic_load_n(&tb->middle, __ATOMIC_ACQUIRE) & 4u) != 0u) {
+        osal_uint32_t prev = __atomic_exchange_n(&tb->middle, tb->front, __ATOMIC_ACQ_REL);
+        tb->front = prev & 3u;
+        ret = OSAL_TRUE;
+    }
+
+    return ret;
+}
+
+//! Publish inputs of group to its triple buffer.
+/*!
+ * The caller has to hold the lock of \link ec_pd_group::cdg \endlink.
+ */
+static void ec_pd_group_publish_inputs(ec_pd_group_t *pd) {
+    if (pd->use_triple_buffer != 0) {
+        (void)memcpy(&pd->tb_in.buf[pd->tb_in.back][pd->pdout_len], &pd->pd[pd->pdout_len], pd->pdin_len);
+        ec_pd_triple_buffer_publish(&pd->tb_in);
+    }
+}
+
+// configure triple buffered process data of group
+void ec_configure_pd_group_triple_buffer(ec_t *pec, osal_uint16_t group, int enable) {
+    assert(pec != NULL);
+    assert(group < pec->pd_group_cnt);
+
+    ec_pd_group_t *pd = &pec->pd_groups[group];
+
+    osal_mutex_lock(&pd->cdg.lock);
+    if (enable != 0) {
+        ec_pd_triple_buffer_init(&pd->tb_in, pd->pd, LEC_MAX_PDLEN);
+        ec_pd_triple_buffer_init(&pd->tb_out, pd->pd, LEC_MAX_PDLEN);
+    }
+    pd->use_triple_buffer = enable;
+    osal_mutex_unlock(&pd->cdg.lock);
+}
+
+// get newest input image of triple buffered group
+const osal_uint8_t *ec_pd_group_get_inputs(ec_t *pec, osal_uint16_t group) {
+    assert(pec != NULL);
+    assert(group < pec->pd_group_cnt);
+
+    ec_pd_group_t *pd = &pec->pd_groups[group];
+    (void)ec_pd_triple_buffer_acquire(&pd->tb_in);
+    return &pd->tb_in.buf[pd->tb_in.front][0];
+}
+
+// get output image of triple buffered group to write to
+osal_uint8_t *ec_pd_group_get_outputs(ec_t *pec, osal_uint16_t group) {
+    assert(pec != NULL);
+    assert(group < pec->pd_group_cnt);
+
+    ec_pd_group_t *pd = &pec->pd_groups[group];
+    return &pd->tb_out.buf[pd->tb_out.back][0];
+}
+
+// publish outputs of triple buffered group
+void ec_pd_group_publish_outputs(ec_t *pec, osal_uint16_t group) {
+    assert(pec != NULL);
+    assert(group < pec->pd_group_cnt);
+
+    ec_pd_group_t *pd = &pec->pd_groups[group];
+    osal_uint32_t published = pd->tb_out.back;
+    ec_pd_triple_buffer_publish(&pd->tb_out);
+
+    // published buffer is only read from now on, continue with its outputs
+    (void)memcpy(&pd->tb_out.buf[pd->tb_out.back][0], &pd->tb_out.buf[published][0], pd->pdout_len);
+}
+
 //! destroy process data groups
 /*!
  * \param pec ethercat master pointer
@@ -245,12 +402,22 @@ void ec_configure_pd_group(ec_t *pec, osal_uint16_t group, int clock_divisor,
 int ec_destroy_pd_groups(ec_t *pec) {
     assert(pec != NULL);
 
-    for (osal_uint16_t i = 0; i < pec->pd_group_cnt; ++i) {
+    osal_uint16_t pd_group_cnt = pec->pd_group_cnt;
+    pec->pd_group_cnt = 0;
+
+    for (osal_uint16_t i = 0; i < pd_group_cnt; ++i) {
         (void)ec_cyclic_datagram_destroy(&pec->pd_groups[i].cdg);
+        (void)ec_cyclic_datagram_destroy(&pec->pd_groups[i].cdg_lrd);
+        (void)ec_cyclic_datagram_destroy(&pec->pd_groups[i].cdg_lwr);
+        (void)ec_cyclic_datagram_destroy(&pec->pd_groups[i].cdg_lrd_mbx_state);
+        for (osal_size_t slot = 0u; slot < LEC_MAX_PD_PIPELINE_DEPTH; ++slot) {
+            (void)ec_cyclic_datagram_destroy(&pec->pd_groups[i].cdg_pipeline[slot]);
+        }
+        for (osal_size_t chunk = 0u; chunk < LEC_MAX_PD_CHUNKS; ++chunk) {
+            (void)ec_cyclic_datagram_destroy(&pec->pd_groups[i].chunks[chunk].cdg);
+        }
     }
 
-    pec->pd_group_cnt = 0;
-
     return 0;
 }
 
@@ -753,8 +920,61 @@ static void ec_state_transition_loop(ec_t *pec, ec_state_t state, osal_uint8_t w
     osal_sleep(100000000); // sleep 100 ms to complete state transition in slaves
 }
 
+//! Same register access on many slaves with batched datagrams.
+/*!
+ * \param[in]     pec           Pointer to ethercat master structure.
+ * \param[in]     cmd           EtherCAT command, auto increment or configured address.
+ * \param[in]     ado           Register address.
+ * \param[in,out] data          Data of first slave.
+ * \param[in]     data_stride   Bytes between data of consecutive slaves, 0 if all share data.
+ * \param[in]     datalen       Length of data.
+ * \param[out]    wkc           Working counter of each slave.
+ * \param[in]     cnt           Number of slaves starting with slave 0.
+ *
+ * \return EC_OK or error code
+ */
+static int ec_scan_batch(ec_t *pec, osal_uint8_t cmd, osal_uint16_t ado, osal_uint8_t *data, 
+        osal_size_t data_stride, osal_size_t datalen, osal_uint16_t *wkc, osal_uint16_t cnt) 
+{
+    int ret = EC_OK;
+    ec_batch_req_t reqs[LEC_MAX_BATCH_DATAGRAMS];
+    osal_bool_t auto_inc = ((cmd == EC_CMD_APRD) || (cmd == EC_CMD_APWR)) ? OSAL_TRUE : OSAL_FALSE;
+    osal_uint16_t first = 0u;
+
+    while (first < cnt) {
+        osal_uint16_t n = (osal_uint16_t)LEC_MIN((osal_size_t)cnt - first, LEC_MAX_BATCH_DATAGRAMS);
+
+        for (osal_uint16_t k = 0u; k < n; ++k) {
+            osal_uint16_t slave = first + k;
+            osal_uint16_t adp = (auto_inc == OSAL_TRUE) ? 
+                (osal_uint16_t)(0u - (osal_uint32_t)slave) : pec->slaves[slave].fixed_address;
+
+            reqs[k].cmd = cmd;
+            reqs[k].adr = ((osal_uint32_t)ado << 16u) | adp;
+            reqs[k].data = &data[slave * data_stride];
+            reqs[k].datalen = datalen;
+        }
+
+        int local_ret = ec_batch_transceive(pec, reqs, n);
+        if (ret == EC_OK) {
+            ret = local_ret;
+        }
+
+        for (osal_uint16_t k = 0u; k < n; ++k) {
+            wkc[first + k] = reqs[k].wkc;
+        }
+
+        first += n;
+    }
+
+    return ret;
+}
+
 //! scan ethercat bus for slaves and create strucutres
 /*! 
+ * All slaves are addressed with batched datagrams, so the scan takes a 
+ * few frames per step instead of one round trip per slave.
+ *
  * \param pec ethercat master pointer
  */
 static void ec_scan(ec_t *pec) {
@@ -764,6 +984,7 @@ static void ec_scan(ec_t *pec) {
     osal_uint16_t wkc = 0u;
     osal_uint16_t val = 0u;
     osal_uint16_t i;
+    osal_uint16_t slave_wkc[LEC_MAX_SLAVES];
 
     ec_state_t init_state = EC_STATE_INIT | EC_STATE_RESET;
     (void)ec_bwr(pec, EC_REG_ALCTL, &init_state, sizeof(init_state), &wkc); 
@@ -784,70 +1005,88 @@ static void ec_scan(ec_t *pec) {
     } else {
         assert(wkc < LEC_MAX_SLAVES);
 
-        pec->slave_cnt = wkc;
+        osal_uint16_t found = wkc;
+
+        for (i = 0; i < found; ++i) {
+            memset(&pec->slaves[i], 0, sizeof(ec_slave_t));
+
+            pec->slaves[i].slave = i;
+            pec->slaves[i].assigned_pd_group = -1;
+            pec->slaves[i].auto_inc_address = (int16_t)-1 * (int16_t)i;
+            pec->slaves[i].fixed_address = fixed + i;
+            pec->slaves[i].dc.use_dc = 1;
+            pec->slaves[i].sm_set_by_user = 0;
+            pec->slaves[i].subdev_cnt = 0;
+            pec->slaves[i].eeprom.read_eeprom = 0;
+            TAILQ_INIT(&pec->slaves[i].eeprom.txpdos);
+            TAILQ_INIT(&pec->slaves[i].eeprom.rxpdos);
+            LIST_INIT(&pec->slaves[i].init_cmds);
+        }
 
-        for (i = 0; i < pec->slave_cnt; ++i) {
-            int16_t auto_inc = (int16_t)-1 * (int16_t)i;
+        int local_ret = ec_scan_batch(pec, EC_CMD_APRD, EC_REG_TYPE, (osal_uint8_t *)&pec->slaves[0].type, 
+                sizeof(ec_slave_t), sizeof(pec->slaves[0].type), slave_wkc, found);
+        if (local_ret != EC_OK) {
+            ec_log(1, "MASTER_SCAN", "master  : reading slave types returned %d\n", local_ret);
+        }
 
-            int local_ret = ec_aprd(pec, auto_inc, EC_REG_TYPE, (osal_uint8_t *)&val, sizeof(val), &wkc);
+        for (i = 0; i < found; ++i) {
+            if (slave_wkc[i] == 0u) {
+                break;  // break here, cause there seems to be no more slave
+            }
 
-            if (local_ret == EC_OK) {
-                if (wkc == 0u) {
-                    break;  // break here, cause there seems to be no more slave
-                }
+            ec_log(100, "MASTER_SCAN", "slave %2d: auto inc %3d, fixed %d\n", 
+                    i, pec->slaves[i].auto_inc_address, pec->slaves[i].fixed_address);
+        }
 
-                ec_log(100, "MASTER_SCAN", "slave %2d: auto inc %3d, fixed %d\n", 
-                        i, auto_inc, fixed);
-
-                memset(&pec->slaves[i], 0, sizeof(ec_slave_t));
-
-                pec->slaves[i].slave = i;
-                pec->slaves[i].assigned_pd_group = -1;
-                pec->slaves[i].auto_inc_address = auto_inc;
-                pec->slaves[i].fixed_address = fixed;
-                pec->slaves[i].dc.use_dc = 1;
-                pec->slaves[i].sm_set_by_user = 0;
-                pec->slaves[i].subdev_cnt = 0;
-                pec->slaves[i].eeprom.read_eeprom = 0;
-                pec->slaves[i].type = val;
-                TAILQ_INIT(&pec->slaves[i].eeprom.txpdos);
-                TAILQ_INIT(&pec->slaves[i].eeprom.rxpdos);
-                LIST_INIT(&pec->slaves[i].init_cmds);
-
-                local_ret = ec_apwr(pec, auto_inc, EC_REG_STADR, (osal_uint8_t *)&fixed, sizeof(fixed), &wkc); 
-                if ((local_ret != EC_OK) || (wkc == 0u)) {
-                    ec_log(1, "MASTER_SCAN", "slave %2d: error writing fixed address %d\n", i, fixed);
-                }
+        pec->slave_cnt = i;
 
-                // set eeprom to pdi, some slaves need this
-                (void)ec_eeprom_to_pdi(pec, i);
-                init_state = EC_STATE_INIT | EC_STATE_RESET;
-                local_ret = ec_fpwr(pec, fixed, EC_REG_ALCTL, &init_state, sizeof(init_state), &wkc); 
-                if (local_ret != EC_OK) {
-                    ec_log(1, "MASTER_SCAN", "slave %2d: reading al control failed with %d\n", i, local_ret);
-                }
+        (void)ec_scan_batch(pec, EC_CMD_APWR, EC_REG_STADR, (osal_uint8_t *)&pec->slaves[0].fixed_address, 
+                sizeof(ec_slave_t), sizeof(pec->slaves[0].fixed_address), slave_wkc, pec->slave_cnt);
+        for (i = 0; i < pec->slave_cnt; ++i) {
+            if (slave_wkc[i] == 0u) {
+                ec_log(1, "MASTER_SCAN", "slave %2d: error writing fixed address %d\n", 
+                        i, pec->slaves[i].fixed_address);
+            }
+        }
 
-                fixed++;
-            } else {
-                ec_log(1, "MASTER_SCAN", "master  : ec_aprd %d returned %d\n", auto_inc, local_ret);
+        // set eeprom to pdi, some slaves need this
+        osal_uint8_t eepcfg = 1u;
+        (void)ec_scan_batch(pec, EC_CMD_FPWR, EC_REG_EEPCFG, &eepcfg, 0u, sizeof(eepcfg), slave_wkc, pec->slave_cnt);
+        for (i = 0; i < pec->slave_cnt; ++i) {
+            if (slave_wkc[i] != 1u) {
+                (void)ec_eeprom_to_pdi(pec, i);
             }
         }
 
+        init_state = EC_STATE_INIT | EC_STATE_RESET;
+        local_ret = ec_scan_batch(pec, EC_CMD_FPWR, EC_REG_ALCTL, (osal_uint8_t *)&init_state, 0u, 
+                sizeof(init_state), slave_wkc, pec->slave_cnt);
+        if (local_ret != EC_OK) {
+            ec_log(1, "MASTER_SCAN", "master  : writing al control failed with %d\n", local_ret);
+        }
+
         ec_log(10, "MASTER_SCAN", "master  : found %d ethercat slaves\n", i);
 
+        // read link status and physical type of all slaves
+        osal_uint16_t dlstat[LEC_MAX_SLAVES];
+        osal_uint16_t ptype_wkc[LEC_MAX_SLAVES];
+        (void)ec_scan_batch(pec, EC_CMD_FPRD, EC_REG_DLSTAT, (osal_uint8_t *)&dlstat[0], 
+                sizeof(dlstat[0]), sizeof(dlstat[0]), slave_wkc, pec->slave_cnt);
+        (void)ec_scan_batch(pec, EC_CMD_FPRD, EC_REG_PORTDES, (osal_uint8_t *)&pec->slaves[0].ptype, 
+                sizeof(ec_slave_t), sizeof(pec->slaves[0].ptype), ptype_wkc, pec->slave_cnt);
+
         for (osal_uint16_t slave = 0; slave < pec->slave_cnt; ++slave) {
             ec_slave_ptr(slv, pec, slave); 
             slv->link_cnt = 0;
             slv->active_ports = 0;
             slv->mbx.handler_running = 0;
 
-            osal_uint16_t dlstat = 0;
-            int local_ret = ec_fprd(pec, slv->fixed_address, EC_REG_DLSTAT, &dlstat, sizeof(dlstat), &wkc);
+            osal_bool_t read_ok = (slave_wkc[slave] != 0u) ? OSAL_TRUE : OSAL_FALSE;
 
-            if (local_ret == EC_OK) {
+            if (read_ok == OSAL_TRUE) {
                 // check if loop is not closed and communication established
                 for (osal_uint16_t port = 0u; port < 4u; ++port) {
-                    if (((dlstat >> (8u + (2u * port))) & 0x03) == 0x02) {
+                    if (((dlstat[slave] >> (8u + (2u * port))) & 0x03) == 0x02) {
                         slv->link_cnt++; 
                         slv->active_ports |= (osal_uint8_t)1u << port; 
                     }
@@ -881,12 +1120,11 @@ static void ec_scan(ec_t *pec) {
 
                 ec_log(100, "MASTER_SCAN", "slave %2d is directly connected to slave %d\n", slave, slv->parent);
 
-                // read out physical type
-                slv->ptype = 0;
-                local_ret = ec_fprd(pec, slv->fixed_address, EC_REG_PORTDES, &slv->ptype, sizeof(slv->ptype), &wkc);
+                // physical type was read together with link status
+                read_ok = (ptype_wkc[slave] != 0u) ? OSAL_TRUE : OSAL_FALSE;
             }
 
-            if (local_ret == EC_OK) {
+            if (read_ok == OSAL_TRUE) {
                 for (int port = 0; port < 4; ++port) {
                     osal_uint8_t port_val = (slv->ptype >> (port * 2u)) & 0x03;
                     switch (port_val) {
@@ -949,6 +1187,7 @@ int ec_set_state(ec_t *pec, ec_state_t state) {
             if (pec->slave_cnt == 0) {
                 ret = EC_ERROR_UNAVAILABLE;
             } else {
+                (void)ec_eeprom_prefetch(pec);
                 ec_state_transition_loop(pec, EC_STATE_INIT, 0);
             }
 
@@ -1009,6 +1248,8 @@ int ec_set_state(ec_t *pec, ec_state_t state) {
                             "master  : not all slaves support LRW in group or disabled\n", group);
                     ec_create_logical_mapping(pec, group);
                 }
+
+                ec_pd_group_compile(pec, group);
             }
 
             ec_state_transition_loop(pec, EC_STATE_SAFEOP, 1);
@@ -1063,16 +1304,34 @@ int ec_set_state(ec_t *pec, ec_state_t state) {
             for (int i = 0; i < pec->pd_group_cnt; ++i) {
                 ec_pd_group_t *pd = &pec->pd_groups[i];
 
-                if (pd->cdg.p_idx != NULL) {
-                    pec->phw->tx_send[pd->cdg.p_idx->idx] = NULL;
-                    ec_index_put(&pec->idx_q, pd->cdg.p_idx);
-                    pd->cdg.p_idx = NULL;
+                // drop compiled cycle and chunks first, they reference the datagrams
+                osal_mutex_lock(&pd->cdg.lock);
+                pd->tx_template_len = 0u;
+                pd->tx_template_cnt = 0u;
+                osal_size_t chunk_cnt = pd->chunk_cnt;
+                pd->chunk_cnt = 0u;
+                osal_mutex_unlock(&pd->cdg.lock);
+
+                for (osal_size_t chunk = 0u; chunk < chunk_cnt; ++chunk) {
+                    ec_cyclic_datagram_free(pec, &pd->chunks[chunk].cdg);
                 }
 
-                if (pd->cdg.p_entry != NULL) {
-                    pool_put(&pec->pool, pd->cdg.p_entry);
-                    pd->cdg.p_entry = NULL;
+                ec_cyclic_datagram_free(pec, &pd->cdg);
+                ec_cyclic_datagram_free(pec, &pd->cdg_lwr);
+                ec_cyclic_datagram_free(pec, &pd->cdg_lrd);
+                ec_cyclic_datagram_free(pec, &pd->cdg_lrd_mbx_state);
+
+                for (osal_size_t slot = 1u; slot < LEC_MAX_PD_PIPELINE_DEPTH; ++slot) {
+                    ec_cyclic_datagram_free(pec, &pd->cdg_pipeline[slot]);
+                    pd->pipeline_cycle[slot] = 0u;
                 }
+
+                osal_mutex_lock(&pd->cdg.lock);
+                pd->pipeline_cycle[0] = 0u;
+                pd->pipeline_slot = 0u;
+                pd->pipeline_tx_cycle = 0u;
+                pd->pipeline_rx_cycle = 0u;
+                osal_mutex_unlock(&pd->cdg.lock);
             }
 
             // return distributed clocks datagram
@@ -1113,6 +1372,7 @@ int ec_set_state(ec_t *pec, ec_state_t state) {
             pec->master_state = EC_STATE_INIT;
             ec_log(10, get_state_string(pec->master_state), "master  : doing rescan\n");
             ec_scan(pec);
+            (void)ec_eeprom_prefetch(pec);
             ec_state_transition_loop(pec, EC_STATE_INIT, 0);
 
             if (state == EC_STATE_INIT) {
@@ -1149,12 +1409,26 @@ int ec_open(ec_t *pec, struct hw_common *phw, int eeprom_log) {
 
     int ret = EC_OK;
 
+    // messages are formatted synchronously until ec_log_deferred_start
+    pec->log_ring.running = 0;
+
     ret = ec_index_init(&pec->idx_q);
     
     if (ret == EC_OK) {
         pec->master_state       = EC_STATE_UNKNOWN;
 
         pec->stats.lost_datagrams = 0;
+        pec->stats.tx_window_datagrams = 0u;
+        pec->stats.tx_window_saved_ns = 0u;
+        pec->stats.tx_window_late = 0u;
+        pec->stats.tx_window_missed = 0u;
+        ec_histogram_reset(&pec->stats.tx_duration);
+        ec_histogram_reset(&pec->stats.rx_duration);
+        ec_histogram_reset(&pec->stats.round_trip);
+        ec_histogram_reset(&pec->stats.cycle_jitter);
+        ec_histogram_reset(&pec->stats.dc_diff);
+        (void)memset(&pec->stats.wkc_mismatch[0], 0, sizeof(pec->stats.wkc_mismatch));
+        pec->last_cycle_start = 0u;
 
         pec->user_cb_state_transition = NULL;
         pec->user_cb_state_transition_arg = NULL;
@@ -1191,6 +1465,7 @@ int ec_open(ec_t *pec, struct hw_common *phw, int eeprom_log) {
 
         // eeprom logging level
         pec->eeprom_log         = eeprom_log;
+        pec->eeprom_cache_dir[0] = '\0';
 
         (void)memset(&pec->dg_entries[0], 0, sizeof(pool_entry_t) * (osal_size_t)LEC_MAX_DATAGRAMS);
         ret = pool_open(&pec->pool, LEC_MAX_DATAGRAMS, &pec->dg_entries[0]);
@@ -1297,6 +1572,7 @@ int ec_close(ec_t *pec) {
     (void)ec_cyclic_datagram_destroy(&pec->cdg_state);
 
     ec_log(10, "MASTER_CLOSE", "all done!\n");
+    ec_log_deferred_stop(pec);
     return 0;
 }
 
@@ -1307,7 +1583,7 @@ static void cb_block(struct ec *pec, pool_entry_t *p_entry, ec_datagram_t *p_dg)
     osal_size_t size = ec_datagram_length(p_dg);
     (void)memcpy(p_entry->data, (osal_uint8_t *)p_dg, LEC_MIN(size, LEC_MAX_POOL_DATA_SIZE));
 
-    osal_binary_semaphore_post(&p_entry->p_idx->waiter);
+    ec_index_complete(p_entry->p_idx);
 }
 
 
@@ -1464,30 +1740,28 @@ int ec_transceive(ec_t *pec, osal_uint8_t cmd, osal_uint32_t adr,
             if (    (pec->master_state != EC_STATE_SAFEOP) &&
                     (pec->master_state != EC_STATE_OP)) {
                 if (hw_tx_low(pec->phw) == OSAL_TRUE) hw_rx(pec->phw);
-//            } else {
-//                osal_timer_t test;
-//                // max mtu frame, 10 [ns] per bit on 100 Mbit/s, 150% threshold
-//                osal_timer_init(&test, (10 * 8 * pec->phw->mtu_size) * 1.5);  
-//                if (osal_timer_cmp(&test, &pec->phw->next_cylce_start, <)) {
-//                    if (hw_tx_low(pec->phw) == OSAL_TRUE) hw_rx(pec->phw);
-//                }
+            } else {
+                // in cyclic mode only if it returns before the next cycle
+                if (hw_tx_low_window(pec->phw) == OSAL_TRUE) hw_rx(pec->phw);
             }
 
             // wait for completion
             osal_timer_t to;
             osal_timer_init(&to, EC_TIMEOUT_FRAME);
-            int local_ret = osal_binary_semaphore_timedwait(&p_idx->waiter, &to);
-            if (local_ret != OSAL_OK) {
-                if (local_ret == OSAL_ERR_TIMEOUT) {
+            int local_ret = ec_index_wait(&pec->idx_q, p_idx, &to);
+            if (local_ret != EC_OK) {
+                if (local_ret == EC_ERROR_TIMEOUT) {
                     char tmp[128];
                     ec_decode_datagram_to_string(p_dg, tmp, 128);
                     ec_log(1, "MASTER_TRANSCEIVE", "timeout on %s\n", tmp);
                 } else {
-                    ec_log(1, "MASTER_TRANSCEIVE", "osal_binary_semaphore_wait returned: %d, cmd 0x%X, adr 0x%X\n", 
+                    ec_log(1, "MASTER_TRANSCEIVE", "ec_index_wait returned: %d, cmd 0x%X, adr 0x%X\n", 
                             local_ret, cmd, adr);
                 }
 
-                pool_remove(&pec->phw->tx_low, p_entry);
+                // a late reply must not complete the next user of this index
+                (void)hw_dequeue(pec->phw, p_entry, POOL_LOW);
+                pec->phw->tx_send[p_dg->idx] = NULL;
                 *wkc = 0u;
                 ret = EC_ERROR_TIMEOUT;
             } else {
@@ -1509,9 +1783,6 @@ int ec_transceive(ec_t *pec, osal_uint8_t cmd, osal_uint32_t adr,
                     "This should usually not happen on an EtherCAT fieldbus because the sent frames must always return to the master.\n"
                     "There's either something wrong with your configuration or there is a hardware issue on your bus topology!\n"
                     "Lost datagram during transceive though it was sent multiple times! Check your configuration!\n", cmd, adr);
-
-            // remove sent mark
-            pec->phw->tx_send[p_dg->idx] = NULL;
         }
 
         pool_put(&pec->pool, p_entry);
@@ -1521,6 +1792,189 @@ int ec_transceive(ec_t *pec, osal_uint8_t cmd, osal_uint32_t adr,
     return ret;
 }
 
+//! Initialize a batched transfer.
+/*!
+ * \param[out] batch        Batch handle.
+ * \param[in]  reqs         Datagrams to transfer.
+ * \param[in]  cnt          Number of datagrams.
+ */
+void ec_batch_init(ec_batch_t *batch, ec_batch_req_t *reqs, osal_size_t cnt) {
+    assert(batch != NULL);
+    assert((reqs != NULL) || (cnt == 0u));
+
+    batch->reqs = reqs;
+    batch->cnt = cnt;
+    batch->pos = 0u;
+    batch->end = 0u;
+    batch->sent = OSAL_FALSE;
+
+    for (osal_size_t i = 0u; i < cnt; ++i) {
+        reqs[i].wkc = 0u;
+        reqs[i].ret = EC_ERROR_UNAVAILABLE;
+        reqs[i].p_entry = NULL;
+        reqs[i].p_idx = NULL;
+    }
+}
+
+//! Queue next datagrams of a batch without waiting.
+/*!
+ * \param[in]     pec       Pointer to ethercat master structure.
+ * \param[in,out] batch     Batch handle.
+ *
+ * \return EC_OK or error code
+ */
+int ec_batch_submit(ec_t *pec, ec_batch_t *batch) {
+    assert(pec != NULL);
+    assert(batch != NULL);
+
+    int ret = EC_OK;
+    osal_size_t i = batch->pos;
+
+    if ((batch->end != batch->pos) || (batch->pos >= batch->cnt)) {
+        ret = EC_ERROR_UNAVAILABLE;
+    } else {
+        for (; (i < batch->cnt) && ((i - batch->pos) < LEC_MAX_BATCH_DATAGRAMS); ++i) {
+            ec_batch_req_t *req = &batch->reqs[i];
+            assert(req->data != NULL);
+
+            if (ec_index_get(&pec->idx_q, &req->p_idx) != EC_OK) {
+                ret = EC_ERROR_OUT_OF_INDICES;
+                break;
+            } 
+            
+            if (pool_get(&pec->pool, &req->p_entry, NULL) != EC_OK) {
+                ec_index_put(&pec->idx_q, req->p_idx);
+                req->p_idx = NULL;
+                ret = EC_ERROR_OUT_OF_DATAGRAMS;
+                break;
+            }
+
+            ec_datagram_t *p_dg = ec_datagram_cast(req->p_entry->data);
+            (void)memset(p_dg, 0, sizeof(ec_datagram_t) + req->datalen + 2u);
+            p_dg->cmd = req->cmd;
+            p_dg->idx = req->p_idx->idx;
+            p_dg->adr = req->adr;
+            p_dg->len = req->datalen;
+            p_dg->irq = 0;
+            (void)memcpy(ec_datagram_payload(p_dg), req->data, req->datalen);
+
+            req->p_entry->p_idx = req->p_idx;
+            req->p_entry->user_cb = cb_block;
+
+            hw_enqueue(pec->phw, req->p_entry, POOL_LOW);
+        }
+
+        batch->end = i;
+
+        if (i > batch->pos) {
+            // partial batches are fine, the rest is sent in the next round
+            ret = EC_OK;
+
+            if (    (pec->master_state != EC_STATE_SAFEOP) &&
+                    (pec->master_state != EC_STATE_OP)) {
+                batch->sent = (hw_tx_low(pec->phw) == OSAL_TRUE) ? OSAL_TRUE : OSAL_FALSE;
+            } else {
+                batch->sent = hw_tx_low_window(pec->phw);
+            }
+        } else {
+            ec_log(1, "MASTER_BATCH", "error getting %s\n", 
+                    (ret == EC_ERROR_OUT_OF_INDICES) ? "ethercat index" : "datagram from pool");
+        }
+    }
+
+    return ret;
+}
+
+//! Wait for all submitted datagrams of a batch.
+/*!
+ * \param[in]     pec       Pointer to ethercat master structure.
+ * \param[in,out] batch     Batch handle.
+ * \param[in]     timeout   Absolute timeout for the whole batch.
+ *
+ * \return EC_OK or error code
+ */
+int ec_batch_wait(ec_t *pec, ec_batch_t *batch, osal_timer_t *timeout) {
+    assert(pec != NULL);
+    assert(batch != NULL);
+    assert(timeout != NULL);
+
+    int ret = EC_OK;
+
+    if (batch->sent == OSAL_TRUE) {
+        (void)hw_rx(pec->phw);
+        batch->sent = OSAL_FALSE;
+    }
+
+    for (osal_size_t i = batch->pos; i < batch->end; ++i) {
+        ec_batch_req_t *req = &batch->reqs[i];
+        ec_datagram_t *p_dg = ec_datagram_cast(req->p_entry->data);
+
+        if (ec_index_wait(&pec->idx_q, req->p_idx, timeout) != EC_OK) {
+            char tmp[128];
+            ec_decode_datagram_to_string(p_dg, tmp, 128);
+            ec_log(1, "MASTER_BATCH", "timeout on %s\n", tmp);
+
+            (void)hw_dequeue(pec->phw, req->p_entry, POOL_LOW);
+            pec->phw->tx_send[p_dg->idx] = NULL;
+
+            req->wkc = 0u;
+            req->ret = EC_ERROR_TIMEOUT;
+            ret = EC_ERROR_TIMEOUT;
+        } else {
+            req->wkc = ec_datagram_wkc(p_dg);
+            if (req->wkc != 0u) {
+                (void)memcpy(req->data, ec_datagram_payload(p_dg), req->datalen);
+            }
+
+            req->ret = EC_OK;
+        }
+
+        pool_put(&pec->pool, req->p_entry);
+        ec_index_put(&pec->idx_q, req->p_idx);
+        req->p_entry = NULL;
+        req->p_idx = NULL;
+    }
+
+    batch->pos = batch->end;
+
+    return ret;
+}
+
+//! Transfer many datagrams with as few frames as possible.
+/*!
+ * \param[in]     pec       Pointer to ethercat master structure.
+ * \param[in,out] reqs      Datagrams to transfer.
+ * \param[in]     cnt       Number of datagrams.
+ *
+ * \return EC_OK or error code
+ */
+int ec_batch_transceive(ec_t *pec, ec_batch_req_t *reqs, osal_size_t cnt) {
+    assert(pec != NULL);
+
+    int ret = EC_OK;
+    ec_batch_t batch;
+
+    ec_batch_init(&batch, reqs, cnt);
+
+    while (batch.pos < batch.cnt) {
+        int local_ret = ec_batch_submit(pec, &batch);
+        if (local_ret != EC_OK) {
+            ret = local_ret;
+            break;
+        }
+
+        // without a window the datagrams go out with the next cycle
+        osal_timer_t to;
+        osal_timer_init(&to, EC_TIMEOUT_FRAME);
+        local_ret = ec_batch_wait(pec, &batch, &to);
+        if (ret == EC_OK) {
+            ret = local_ret;
+        }
+    }
+
+    return ret;
+}
+
 //! local callack for syncronous read/write
 static void cb_no_reply(struct ec *pec, pool_entry_t *p_entry, ec_datagram_t *p_dg) {
     (void)p_dg;
@@ -1565,6 +2019,7 @@ static void cb_process_data_group_lwr(struct ec *pec, pool_entry_t *p_entry, ec_
         }
 
         if (!pec->state_transition_pending && (do_check_group == OSAL_TRUE)) {
+            (void)__atomic_fetch_add(&pec->stats.wkc_mismatch[pd->group], 1u, __ATOMIC_RELAXED);
             if ((pd->wkc_mismatch_cnt_lwr++%1000) == 0) {
                 ec_log(1, "MASTER_RECV_PD_LWR", 
                         "group %2d: working counter mismatch got %u, "
@@ -1580,6 +2035,32 @@ static void cb_process_data_group_lwr(struct ec *pec, pool_entry_t *p_entry, ec_
     }
 }
 
+//! Get cycle number of group LRW datagram.
+/*!
+ * The caller has to hold the lock of \link ec_pd_group::cdg \endlink.
+ *
+ * \param[in]   pd          Process data group.
+ * \param[in]   p_entry     Pool entry of received datagram.
+ *
+ * \return Cycle number or 0 if group is not pipelined or \p p_entry is 
+ * no LRW of group.
+ */
+static osal_uint64_t ec_pd_group_pipeline_cycle(ec_pd_group_t *pd, pool_entry_t *p_entry) {
+    osal_uint64_t cycle = 0u;
+
+    if (pd->pipeline_depth > 1u) {
+        for (osal_size_t slot = 0u; slot < pd->pipeline_depth; ++slot) {
+            ec_cyclic_datagram_t *cdg = (slot == 0u) ? &pd->cdg : &pd->cdg_pipeline[slot];
+            if (cdg->p_entry == p_entry) {
+                cycle = pd->pipeline_cycle[slot];
+                break;
+            }
+        }
+    }
+
+    return cycle;
+}
+
 //! datagram callack for receiving process data group answer
 static void cb_process_data_group(struct ec *pec, pool_entry_t *p_entry, ec_datagram_t *p_dg) {
     assert(pec != NULL);
@@ -1590,6 +2071,7 @@ static void cb_process_data_group(struct ec *pec, pool_entry_t *p_entry, ec_data
     osal_uint16_t wkc = 0;
     osal_uint16_t wkc_expected = pd->use_lrw == 0 ? pd->wkc_expected_lrd : pd->wkc_expected_lrw;
     int wkc_mismatch;
+    osal_bool_t stale = OSAL_FALSE;
 
 #ifdef LIBETHERCAT_DEBUG
     ec_log(100, "MASTER_RECV_PD_GROUP", "group %2d: received process data\n", p_entry->user_arg);
@@ -1600,29 +2082,44 @@ static void cb_process_data_group(struct ec *pec, pool_entry_t *p_entry, ec_data
     // reset consecutive missed counter
     pd->recv_missed_lrw = 0;
 
+    // overlapped cycles, never replace inputs with those of an older cycle
+    osal_uint64_t cycle = ec_pd_group_pipeline_cycle(pd, p_entry);
+    if (cycle != 0u) {
+        if (cycle <= pd->pipeline_rx_cycle) {
+            stale = OSAL_TRUE;
+        } else {
+            pd->pipeline_rx_cycle = cycle;
+        }
+    }
+
     wkc = ec_datagram_wkc(p_dg);
 
     wkc_mismatch = wkc != wkc_expected;
     // Copy if pdin_len > 0 and no wkc_missmatch occurs when skip_pd_on_wkc_mismatch is set
-    if (pd->pdin_len > 0 && (pd->skip_pd_on_wkc_mismatch ? !wkc_mismatch: OSAL_TRUE)) {
+    if ((stale == OSAL_FALSE) && pd->pdin_len > 0 && (pd->skip_pd_on_wkc_mismatch ? !wkc_mismatch: OSAL_TRUE)) {
         if ((pd->use_lrw != 0) || (pd->overlapping)) {
             // use this if lrw overlapping or lrd command
             (void)memcpy(&pd->pd[pd->pdout_len], ec_datagram_payload(p_dg), pd->pdin_len);
         } else {
             (void)memcpy(&pd->pd[pd->pdout_len], &ec_datagram_payload(p_dg)[pd->pdout_len], pd->pdin_len);
         }
+
+        ec_pd_group_publish_inputs(pd);
     }
     
     osal_mutex_unlock(&pd->cdg.lock);
 
-    if (pd->cdg.user_cb != NULL) {
+    if ((stale == OSAL_FALSE) && (pd->cdg.user_cb != NULL)) {
+        ec_trace_begin(EC_TRACE_USER_CB, pd->group);
         (*pd->cdg.user_cb)(pd->cdg.user_cb_arg, pd->group);
+        ec_trace_end(EC_TRACE_USER_CB, pd->group);
     }
 
     if (    !pec->state_transition_pending &&
             (   (pec->master_state == EC_STATE_SAFEOP) || 
                 (pec->master_state == EC_STATE_OP)  ) && 
             (wkc_mismatch)) {
+        (void)__atomic_fetch_add(&pec->stats.wkc_mismatch[pd->group], 1u, __ATOMIC_RELAXED);
         if ((pd->wkc_mismatch_cnt_lrw++%1000) == 0) {
             ec_log(1, "MASTER_RECV_PD_GROUP", 
                     "group %2" PRIu32 ": working counter mismatch got %u, "
@@ -1637,41 +2134,116 @@ static void cb_process_data_group(struct ec *pec, pool_entry_t *p_entry, ec_data
     }
 }
 
-//! datagram callack for receiving mbx_state answer
-static void cb_lrd_mbx_state(struct ec *pec, pool_entry_t *p_entry, ec_datagram_t *p_dg) {
+//! datagram callack for receiving one chunk of a split process data group
+static void cb_process_data_group_chunk(struct ec *pec, pool_entry_t *p_entry, ec_datagram_t *p_dg) {
     assert(pec != NULL);
     assert(p_entry != NULL);
     assert(p_dg != NULL);
 
-    osal_uint16_t wkc = 0u;
-    osal_uint8_t *buf = NULL;
-    ec_pd_group_t *pd = &pec->pd_groups[p_entry->user_arg];
+    ec_pd_group_t *pd = &pec->pd_groups[p_entry->user_arg % (int)LEC_MAX_GROUPS];
+    osal_size_t chunk_no = (osal_size_t)p_entry->user_arg / LEC_MAX_GROUPS;
+    ec_pd_group_chunk_t *chunk = &pd->chunks[chunk_no];
+    osal_uint16_t wkc = 0;
+    int wkc_mismatch;
+    osal_bool_t cycle_complete = OSAL_FALSE;
+    osal_bool_t stale = OSAL_FALSE;
 
 #ifdef LIBETHERCAT_DEBUG
-    ec_log(100, "MASTER_RECV_MBX_STATE", "slave %2d: received mbx state\n", p_entry->user_arg);
+    ec_log(100, "MASTER_RECV_PD_GROUP", "group %2d: received process data chunk %d\n", 
+            pd->group, (int)chunk_no);
 #endif
 
-    osal_mutex_lock(&pd->cdg_lrd_mbx_state.lock);
+    osal_mutex_lock(&pd->cdg.lock);
+    
+    // reset consecutive missed counter
+    pd->recv_missed_lrw = 0;
 
     wkc = ec_datagram_wkc(p_dg);
-    if (wkc == pd->wkc_expected_mbx_state) {
-        buf = (osal_uint8_t *)ec_datagram_payload(p_dg);	
+    wkc_mismatch = wkc != chunk->wkc_expected;
 
-        for (osal_uint16_t slave = 0; slave < pec->slave_cnt; ++slave) {
-            ec_slave_ptr(slv, pec, slave);
-            if ((slv->assigned_pd_group != (int)pd->group) || (slv->eeprom.mbx_supported == 0u)) { 
-                continue; // skip this slave, not in our group or no mailbox support.
-            }
+    // chunks keep their index, a late reply of the former cycle completes 
+    // the entry sent in this cycle, take only one reply per chunk and cycle
+    if (chunk->rx_cycle == pd->chunk_tx_cycle) {
+        stale = OSAL_TRUE;
+    } else {
+        chunk->rx_cycle = pd->chunk_tx_cycle;
 
-            if ((buf[slv->mbx.sm_state_bitno/8] & (1 << (slv->mbx.sm_state_bitno % 8))) != 0u) { 
-                if (slv->mbx.sm_state != NULL) {
-                    *slv->mbx.sm_state = 0x08u;
-                }
+        // reassemble inputs of group
+        if ((chunk->in_len > 0u) && (pd->skip_pd_on_wkc_mismatch ? !wkc_mismatch : OSAL_TRUE)) {
+            (void)memcpy(&pd->pd[chunk->pd_in_off], &ec_datagram_payload(p_dg)[chunk->in_off], chunk->in_len);
+        }
 
-#ifdef LIBETHERCAT_DEBUG
-                ec_log(100, "MASTER_RECV_MBX_STATE", "slave %2d: got something in mailbox\n", slave);
-#endif
-                ec_mbx_sched_read(pec, slave);
+        pd->chunk_rx_cnt++;
+        cycle_complete = (pd->chunk_rx_cnt == pd->chunk_cnt) ? OSAL_TRUE : OSAL_FALSE;
+        if (cycle_complete == OSAL_TRUE) {
+            ec_pd_group_publish_inputs(pd);
+        }
+    }
+    
+    osal_mutex_unlock(&pd->cdg.lock);
+
+    if ((cycle_complete == OSAL_TRUE) && (pd->cdg.user_cb != NULL)) {
+        ec_trace_begin(EC_TRACE_USER_CB, pd->group);
+        (*pd->cdg.user_cb)(pd->cdg.user_cb_arg, pd->group);
+        ec_trace_end(EC_TRACE_USER_CB, pd->group);
+    }
+
+    if (stale == OSAL_TRUE) {
+        // counted once already
+    } else if (    !pec->state_transition_pending &&
+            (   (pec->master_state == EC_STATE_SAFEOP) || 
+                (pec->master_state == EC_STATE_OP)  ) && 
+            (wkc_mismatch)) {
+        (void)__atomic_fetch_add(&pec->stats.wkc_mismatch[pd->group], 1u, __ATOMIC_RELAXED);
+        if ((chunk->wkc_mismatch_cnt++%1000) == 0) {
+            ec_log(1, "MASTER_RECV_PD_GROUP", 
+                    "group %2" PRIu32 ": chunk %d working counter mismatch got %u, "
+                    "expected %u, slave_cnt %d, mismatch_cnt %d\n", 
+                    pd->group, (int)chunk_no, wkc, chunk->wkc_expected, 
+                    pec->slave_cnt, chunk->wkc_mismatch_cnt);
+        }
+
+        ec_async_check_group(&pec->async_loop, pd->group);
+    } else {
+        chunk->wkc_mismatch_cnt = 0;
+    }
+}
+
+//! datagram callack for receiving mbx_state answer
+static void cb_lrd_mbx_state(struct ec *pec, pool_entry_t *p_entry, ec_datagram_t *p_dg) {
+    assert(pec != NULL);
+    assert(p_entry != NULL);
+    assert(p_dg != NULL);
+
+    osal_uint16_t wkc = 0u;
+    osal_uint8_t *buf = NULL;
+    ec_pd_group_t *pd = &pec->pd_groups[p_entry->user_arg];
+
+#ifdef LIBETHERCAT_DEBUG
+    ec_log(100, "MASTER_RECV_MBX_STATE", "slave %2d: received mbx state\n", p_entry->user_arg);
+#endif
+
+    osal_mutex_lock(&pd->cdg_lrd_mbx_state.lock);
+
+    wkc = ec_datagram_wkc(p_dg);
+    if (wkc == pd->wkc_expected_mbx_state) {
+        buf = (osal_uint8_t *)ec_datagram_payload(p_dg);	
+
+        for (osal_uint16_t slave = 0; slave < pec->slave_cnt; ++slave) {
+            ec_slave_ptr(slv, pec, slave);
+            if ((slv->assigned_pd_group != (int)pd->group) || (slv->eeprom.mbx_supported == 0u)) { 
+                continue; // skip this slave, not in our group or no mailbox support.
+            }
+
+            if ((buf[slv->mbx.sm_state_bitno/8] & (1 << (slv->mbx.sm_state_bitno % 8))) != 0u) { 
+                if (slv->mbx.sm_state != NULL) {
+                    *slv->mbx.sm_state = 0x08u;
+                }
+
+#ifdef LIBETHERCAT_DEBUG
+                ec_log(100, "MASTER_RECV_MBX_STATE", "slave %2d: got something in mailbox\n", slave);
+#endif
+                ec_mbx_sched_read(pec, slave);
             }
         }
 
@@ -1693,190 +2265,559 @@ static void cb_lrd_mbx_state(struct ec *pec, pool_entry_t *p_entry, ec_datagram_
     osal_mutex_unlock(&pd->cdg_lrd_mbx_state.lock);
 }
 
+//! Return index and pool entry of cyclic datagram.
+/*!
+ * The caller has to hold the lock of \p cdg.
+ *
+ * \param[in]   pec         Pointer to EtherCAT master struct.
+ * \param[in]   cdg         Cyclic datagram.
+ */
+static void ec_cyclic_datagram_release(ec_t *pec, ec_cyclic_datagram_t *cdg) {
+    if (cdg->p_idx != NULL) {
+        pec->phw->tx_send[cdg->p_idx->idx] = NULL;
+        ec_index_put(&pec->idx_q, cdg->p_idx);
+        cdg->p_idx = NULL;
+    }
 
-//! send process data for specific group with logical commands
+    if (cdg->p_entry != NULL) {
+        pool_put(&pec->pool, cdg->p_entry);
+        cdg->p_entry = NULL;
+    }
+}
+
+//! Fill cyclic datagram and queue it for sending.
 /*!
- * \param pec ethercat master pointer
- * \param group group number
- * \return 0 on success
+ * If the cyclic frame was opened with \link hw_tx_frame_open \endlink, the 
+ * datagram is built in place in the device's tx buffer. Otherwise it is 
+ * built in the pool entry and enqueued to the high priority queue.
+ *
+ * \param[in]   pec         Pointer to EtherCAT master struct.
+ * \param[in]   cdg         Cyclic datagram with assigned index and pool entry.
+ * \param[in]   cmd         EtherCAT command.
+ * \param[in]   adr         Datagram address.
+ * \param[in]   len         Datagram payload length.
+ * \param[in]   out         Output data copied to the start of the payload, 
+ *                          the rest of the payload is zeroed.
+ * \param[in]   out_len     Length of \p out.
+ *
+ * \return EC_OK or error code
  */
-static int ec_send_process_data_group(ec_t *pec, int group) {
+static int ec_cyclic_datagram_send(ec_t *pec, ec_cyclic_datagram_t *cdg, osal_uint8_t cmd, 
+        osal_uint32_t adr, osal_size_t len, const osal_uint8_t *out, osal_size_t out_len) 
+{
     assert(pec != NULL);
-    assert(group < pec->pd_group_cnt);
+    assert(cdg != NULL);
+    assert(out_len <= len);
 
     int ret = EC_OK;
-    ec_pd_group_t *pd = &pec->pd_groups[group];
-    ec_datagram_t *p_dg;
+    ec_datagram_t *p_dg = NULL;
+    osal_bool_t in_place = pec->phw->tx_frame_in_place;
 
-#ifdef LIBETHERCAT_DEBUG
-    ec_log(100, "MASTER_SEND_PD_GROUP", "group %2d: sending process data\n", group);
-#endif
+    if (in_place == OSAL_TRUE) {
+        ret = hw_tx_frame_reserve(pec->phw, cdg->p_entry, len, &p_dg);
+        if (ret != EC_OK) {
+            // not sent, do not keep the index reserved, next alloc gets a new one
+            ec_cyclic_datagram_release(pec, cdg);
+        }
+    } else {
+        p_dg = ec_datagram_cast(cdg->p_entry->data);
 
-    if (pd->use_lrw == OSAL_TRUE) {
-        osal_mutex_lock(&pd->cdg.lock);
+        (void)memset(p_dg, 0, sizeof(ec_datagram_t));
+        p_dg->idx = cdg->p_idx->idx;
+        p_dg->len = len;
+        (void)memset(&ec_datagram_payload(p_dg)[len], 0, 2u);
+    }
 
-        if (pd->cdg.p_idx == NULL) {
-            if (ec_index_get(&pec->idx_q, &pd->cdg.p_idx) != EC_OK) {
-                ec_log(1, "MASTER_SEND_PD_GROUP", "error getting ethercat index\n");
-                ret = EC_ERROR_OUT_OF_INDICES;
-            }
+    if (ret == EC_OK) {
+        p_dg->cmd = cmd;
+        p_dg->adr = adr;
+
+        if (out_len > 0u) {
+            (void)memcpy(ec_datagram_payload(p_dg), out, out_len);
         }
 
-        if ((ret == EC_OK) && (pd->cdg.p_entry == NULL)) {
-            if (pool_get(&pec->pool, &pd->cdg.p_entry, NULL) != EC_OK) {
-                ec_index_put(&pec->idx_q, pd->cdg.p_idx);
-                pd->cdg.p_idx = NULL;
-                ec_log(1, "MASTER_SEND_PD_GROUP", "error getting datagram from pool\n");
-                ret = EC_ERROR_OUT_OF_DATAGRAMS;
-            } else {
-                pd->cdg.p_entry->p_idx = pd->cdg.p_idx;
-                pd->cdg.p_entry->user_cb = cb_process_data_group;
-                pd->cdg.p_entry->user_arg = pd->group;
-            }
+        if (len > out_len) {
+            (void)memset(&ec_datagram_payload(p_dg)[out_len], 0, len - out_len);
         }
 
-        if (ret == EC_OK) {
-            if (pd->log_len > 0u) {
-                p_dg = ec_datagram_cast(pd->cdg.p_entry->data);
+        if (in_place == OSAL_FALSE) {
+            // queue frame and trigger tx
+            hw_enqueue(pec->phw, cdg->p_entry, POOL_HIGH);           
+        }
+    }
 
-                (void)memset(p_dg, 0, sizeof(ec_datagram_t) + pd->log_len + 2u);
-                p_dg->cmd = EC_CMD_LRW;
-                p_dg->idx = pd->cdg.p_idx->idx;
-                p_dg->adr = pd->log;
-                p_dg->len = pd->log_len;
+    return ret;
+}
 
-                if (pd->pdout_len > 0) {
-                    (void)memcpy(ec_datagram_payload(p_dg), pd->pd, pd->pdout_len);
-                }
+//! Assign index and pool entry to cyclic datagram if not done yet.
+/*!
+ * The caller has to hold the lock of \p cdg.
+ *
+ * \param[in]   pec         Pointer to EtherCAT master struct.
+ * \param[in]   cdg         Cyclic datagram.
+ * \param[in]   user_cb     Receive callback of datagram.
+ * \param[in]   user_arg    Argument of receive callback.
+ *
+ * \return EC_OK or error code
+ */
+static int ec_cyclic_datagram_alloc(ec_t *pec, ec_cyclic_datagram_t *cdg, 
+        void (*user_cb)(struct ec *, pool_entry_t *, ec_datagram_t *), int user_arg) 
+{
+    int ret = EC_OK;
 
-                // queue frame and trigger tx
-                hw_enqueue(pec->phw, pd->cdg.p_entry, POOL_HIGH);           
-            }
+    if (cdg->p_idx == NULL) {
+        if (ec_index_get_cyclic(&pec->idx_q, &cdg->p_idx) != EC_OK) {
+            ec_log(1, "MASTER_SEND_PD_GROUP", "error getting ethercat index\n");
+            ret = EC_ERROR_OUT_OF_INDICES;
         }
+    }
 
-        osal_mutex_unlock(&pd->cdg.lock);
-    } else { // use_lrw == OSAL_FALSE
-        osal_mutex_lock(&pd->cdg_lwr.lock);
+    if ((ret == EC_OK) && (cdg->p_entry == NULL)) {
+        if (pool_get(&pec->pool, &cdg->p_entry, NULL) != EC_OK) {
+            ec_index_put(&pec->idx_q, cdg->p_idx);
+            cdg->p_idx = NULL;
+            ec_log(1, "MASTER_SEND_PD_GROUP", "error getting datagram from pool\n");
+            ret = EC_ERROR_OUT_OF_DATAGRAMS;
+        } else {
+            cdg->p_entry->p_idx = cdg->p_idx;
+            cdg->p_entry->user_cb = user_cb;
+            cdg->p_entry->user_arg = user_arg;
+        }
+    }
 
-        if (pd->cdg_lwr.p_idx == NULL) {
-            if (ec_index_get(&pec->idx_q, &pd->cdg_lwr.p_idx) != EC_OK) {
-                ec_log(1, "MASTER_SEND_PD_GROUP", "error getting ethercat index\n");
-                ret = EC_ERROR_OUT_OF_INDICES;
+    return ret;
+}
+
+//! Return index and pool entry of cyclic datagram.
+/*!
+ * \param[in]   pec         Pointer to EtherCAT master struct.
+ * \param[in]   cdg         Cyclic datagram.
+ */
+static void ec_cyclic_datagram_free(ec_t *pec, ec_cyclic_datagram_t *cdg) {
+    osal_mutex_lock(&cdg->lock);
+    ec_cyclic_datagram_release(pec, cdg);
+    osal_mutex_unlock(&cdg->lock);
+}
+
+//! Expected working counter of logical datagram.
+/*!
+ * Every slave of the group whose fmmus overlap the datagram counts once,
+ * reading adds 1 and writing adds 2 (LRW) or 1 (LWR).
+ *
+ * \param[in]   pec         Pointer to EtherCAT master struct.
+ * \param[in]   group       Number of group.
+ * \param[in]   cmd         Logical command, LRW, LRD or LWR.
+ * \param[in]   log         Logical start address of datagram.
+ * \param[in]   len         Payload length of datagram.
+ *
+ * \return Expected working counter.
+ */
+static osal_uint16_t ec_pd_group_chunk_wkc(ec_t *pec, osal_uint32_t group, osal_uint8_t cmd, 
+        osal_uint32_t log, osal_size_t len) 
+{
+    osal_uint16_t wkc = 0u;
+
+    for (osal_uint16_t slave = 0u; slave < pec->slave_cnt; ++slave) {
+        ec_slave_t *slv = &pec->slaves[slave];
+        osal_bool_t rd = OSAL_FALSE;
+        osal_bool_t wr = OSAL_FALSE;
+
+        if (slv->assigned_pd_group != (int)group) {
+            continue;
+        }
+
+        for (osal_uint32_t f = 0u; f < slv->fmmu_ch; ++f) {
+            ec_slave_fmmu_t *fmmu = &slv->fmmu[f];
+
+            if (    (fmmu->active != 0u) && (fmmu->log < (log + len)) && 
+                    ((fmmu->log + fmmu->log_len) > log)) {
+                if (fmmu->type == 1u) {
+                    rd = OSAL_TRUE;
+                } else if (fmmu->type == 2u) {
+                    wr = OSAL_TRUE;
+                } else {}
             }
         }
 
-        if ((ret == EC_OK) && (pd->cdg_lwr.p_entry == NULL)) {
-            if (pool_get(&pec->pool, &pd->cdg_lwr.p_entry, NULL) != EC_OK) {
-                ec_index_put(&pec->idx_q, pd->cdg_lwr.p_idx);
-                pd->cdg_lwr.p_idx = NULL;
-                ec_log(1, "MASTER_SEND_PD_GROUP", "error getting datagram from pool\n");
-                ret = EC_ERROR_OUT_OF_DATAGRAMS;
-            } else {
-                pd->cdg_lwr.p_entry->p_idx = pd->cdg_lwr.p_idx;
-                pd->cdg_lwr.p_entry->user_cb = cb_process_data_group_lwr;
-                pd->cdg_lwr.p_entry->user_arg = pd->group;
+        if (cmd == EC_CMD_LRW) {
+            wkc += ((rd == OSAL_TRUE) ? 1u : 0u) + ((wr == OSAL_TRUE) ? 2u : 0u);
+        } else if (cmd == EC_CMD_LRD) {
+            wkc += (rd == OSAL_TRUE) ? 1u : 0u;
+        } else {
+            wkc += (wr == OSAL_TRUE) ? 1u : 0u;
+        }
+    }
+
+    return wkc;
+}
+
+//! Split logical area of group into chunks.
+/*!
+ * Outputs are at logical offset 0 and map to process data offset 0, 
+ * inputs start at logical offset \p in_start and map to process data 
+ * offset \link ec_pd_group::pdout_len \endlink.
+ *
+ * \param[in]   pec         Pointer to EtherCAT master struct.
+ * \param[in]   pd          Process data group.
+ * \param[in]   cmd         Logical command, LRW, LRD or LWR.
+ * \param[in]   off         Logical offset of area to split.
+ * \param[in]   len         Length of area to split.
+ * \param[in]   in_start    Logical offset of inputs.
+ * \param[in]   max_len     Maximum payload length of one chunk.
+ *
+ * \return EC_OK or EC_ERROR_OUT_OF_DATAGRAMS if \link LEC_MAX_PD_CHUNKS \endlink is too small.
+ */
+static int ec_pd_group_chunks_add(ec_t *pec, ec_pd_group_t *pd, osal_uint8_t cmd, 
+        osal_size_t off, osal_size_t len, osal_size_t in_start, osal_size_t max_len) 
+{
+    int ret = EC_OK;
+    osal_size_t end = off + len;
+
+    while ((ret == EC_OK) && (off < end)) {
+        if (pd->chunk_cnt >= LEC_MAX_PD_CHUNKS) {
+            ret = EC_ERROR_OUT_OF_DATAGRAMS;
+        } else {
+            ec_pd_group_chunk_t *chunk = &pd->chunks[pd->chunk_cnt];
+            osal_size_t chunk_len = LEC_MIN(max_len, end - off);
+
+            chunk->cmd = cmd;
+            chunk->log = pd->log + off;
+            chunk->len = chunk_len;
+            chunk->pd_out_off = off;
+            chunk->out_len = 0u;
+            chunk->in_off = 0u;
+            chunk->pd_in_off = 0u;
+            chunk->in_len = 0u;
+            chunk->wkc_mismatch_cnt = 0;
+            chunk->rx_cycle = 0u;
+
+            if ((cmd != EC_CMD_LRD) && (off < pd->pdout_len)) {
+                chunk->out_len = LEC_MIN(off + chunk_len, pd->pdout_len) - off;
+            }
+
+            osal_size_t in_from = (off > in_start) ? off : in_start;
+            osal_size_t in_to = LEC_MIN(off + chunk_len, in_start + pd->pdin_len);
+            if ((cmd != EC_CMD_LWR) && (in_to > in_from)) {
+                chunk->in_off = in_from - off;
+                chunk->pd_in_off = pd->pdout_len + (in_from - in_start);
+                chunk->in_len = in_to - in_from;
             }
+
+            chunk->wkc_expected = ec_pd_group_chunk_wkc(pec, pd->group, cmd, chunk->log, chunk_len);
+
+            pd->chunk_cnt++;
+            off += chunk_len;
         }
+    }
+
+    return ret;
+}
+
+//! Split process data group which does not fit into one frame.
+/*!
+ * \param[in]   pec         Pointer to EtherCAT master struct.
+ * \param[in]   group       Number of group.
+ */
+static void ec_pd_group_split(ec_t *pec, osal_uint32_t group) {
+    int ret = EC_OK;
+    ec_pd_group_t *pd = &pec->pd_groups[group];
+    osal_size_t max_len = LEC_MAX_POOL_DATA_SIZE - ec_datagram_hdr_length - EC_WKC_SIZE;
+    osal_size_t frame_overhead = ec_frame_hdr_length + ec_datagram_hdr_length + EC_WKC_SIZE;
 
+    if (pec->phw->mtu_size > frame_overhead) {
+        max_len = LEC_MIN(max_len, pec->phw->mtu_size - frame_overhead);
+    }
+
+    osal_mutex_lock(&pd->cdg.lock);
+    pd->chunk_cnt = 0u;
+    pd->chunk_rx_cnt = 0u;
+
+    if ((pd->pdout_len + pd->pdin_len) > LEC_MAX_PDLEN) {
+        ec_log(1, "MASTER_COMPILE_PD", "group %2" PRIu32 ": process data of %" PRIu64 " bytes "
+                "exceeds LEC_MAX_PDLEN\n", group, (osal_uint64_t)(pd->pdout_len + pd->pdin_len));
+    } else if (pd->use_lrw != 0) {
+        if (pd->log_len > max_len) {
+            ret = ec_pd_group_chunks_add(pec, pd, EC_CMD_LRW, 0u, pd->log_len, 
+                    (pd->overlapping != 0) ? 0u : pd->pdout_len, max_len);
+        }
+    } else if ((pd->pdout_len > max_len) || (pd->pdin_len > max_len)) {
+        ret = ec_pd_group_chunks_add(pec, pd, EC_CMD_LWR, 0u, pd->pdout_len, pd->pdout_len, max_len);
         if (ret == EC_OK) {
-            if (pd->log_len > 0u) {
-                p_dg = ec_datagram_cast(pd->cdg_lwr.p_entry->data);
+            ret = ec_pd_group_chunks_add(pec, pd, EC_CMD_LRD, pd->pdout_len, pd->pdin_len, pd->pdout_len, max_len);
+        }
+    } else {}
 
-                (void)memset(p_dg, 0, sizeof(ec_datagram_t) + pd->log_len + 2u);
-                p_dg->cmd = EC_CMD_LWR;
-                p_dg->idx = pd->cdg_lwr.p_idx->idx;
-                p_dg->adr = pd->log;
-                p_dg->len = pd->pdout_len;
+    if (ret != EC_OK) {
+        ec_log(1, "MASTER_COMPILE_PD", "group %2" PRIu32 ": more than %" PRIu64 " datagrams "
+                "needed, increase LEC_MAX_PD_CHUNKS\n", group, (osal_uint64_t)LEC_MAX_PD_CHUNKS);
+        pd->chunk_cnt = 0u;
+    }
 
-                if (pd->pdout_len > 0) {
-                    (void)memcpy(ec_datagram_payload(p_dg), pd->pd, pd->pdout_len);
-                }
+    osal_mutex_unlock(&pd->cdg.lock);
+}
 
-                // queue frame and trigger tx
-                hw_enqueue(pec->phw, pd->cdg_lwr.p_entry, POOL_HIGH);           
-            }
+//! Send all chunks of split process data group.
+/*!
+ * The caller has to hold the lock of \link ec_pd_group::cdg \endlink.
+ *
+ * \param[in]   pec         Pointer to EtherCAT master struct.
+ * \param[in]   pd          Process data group.
+ *
+ * \return EC_OK or error code
+ */
+static int ec_pd_group_send_chunks(ec_t *pec, ec_pd_group_t *pd) {
+    int ret = EC_OK;
+
+    pd->chunk_rx_cnt = 0u;
+    pd->chunk_tx_cycle++;
+
+    for (osal_size_t i = 0u; (ret == EC_OK) && (i < pd->chunk_cnt); ++i) {
+        ec_pd_group_chunk_t *chunk = &pd->chunks[i];
+
+        osal_mutex_lock(&chunk->cdg.lock);
+
+        ret = ec_cyclic_datagram_alloc(pec, &chunk->cdg, cb_process_data_group_chunk, 
+                (int)(pd->group + (i * LEC_MAX_GROUPS)));
+        if (ret == EC_OK) {
+            ret = ec_cyclic_datagram_send(pec, &chunk->cdg, chunk->cmd, chunk->log, chunk->len, 
+                    &pd->pd[chunk->pd_out_off], chunk->out_len);
         }
 
-        osal_mutex_unlock(&pd->cdg_lwr.lock);
-        
-        osal_mutex_lock(&pd->cdg_lrd.lock);
+        osal_mutex_unlock(&chunk->cdg.lock);
+    }
 
-        if (pd->cdg_lrd.p_idx == NULL) {
-            if (ec_index_get(&pec->idx_q, &pd->cdg_lrd.p_idx) != EC_OK) {
-                ec_log(1, "MASTER_SEND_PD_GROUP", "error getting ethercat index\n");
-                ret = EC_ERROR_OUT_OF_INDICES;
-            }
+    return ret;
+}
+
+//! Append one datagram to group template.
+static void ec_pd_group_template_add(ec_pd_group_t *pd, ec_cyclic_datagram_t *cdg, 
+        osal_uint8_t cmd, osal_uint32_t adr, osal_size_t len) 
+{
+    ec_datagram_t *p_dg = ec_datagram_cast(&pd->tx_template[pd->tx_template_len]);
+
+    if (pd->tx_template_cnt > 0u) {
+        ec_datagram_t *p_dg_prev = ec_datagram_cast(&pd->tx_template[0]);
+        for (osal_size_t i = 1u; i < pd->tx_template_cnt; ++i) {
+            p_dg_prev = ec_datagram_next(p_dg_prev);
         }
+        ec_datagram_mark_next(p_dg_prev);
+    }
 
-        if ((ret == EC_OK) && (pd->cdg_lrd.p_entry == NULL)) {
-            if (pool_get(&pec->pool, &pd->cdg_lrd.p_entry, NULL) != EC_OK) {
-                ec_index_put(&pec->idx_q, pd->cdg_lrd.p_idx);
-                pd->cdg_lrd.p_idx = NULL;
-                ec_log(1, "MASTER_SEND_PD_GROUP", "error getting datagram from pool\n");
-                ret = EC_ERROR_OUT_OF_DATAGRAMS;
-            } else {
-                pd->cdg_lrd.p_entry->p_idx = pd->cdg_lrd.p_idx;
-                pd->cdg_lrd.p_entry->user_cb = cb_process_data_group;
-                pd->cdg_lrd.p_entry->user_arg = pd->group;
+    (void)memset(p_dg, 0, ec_datagram_hdr_length + len + EC_WKC_SIZE);
+    p_dg->cmd = cmd;
+    p_dg->idx = cdg->p_idx->idx;
+    p_dg->adr = adr;
+    p_dg->len = len;
+
+    pd->tx_template_entries[pd->tx_template_cnt] = cdg->p_entry;
+    pd->tx_template_cnt++;
+    pd->tx_template_len += ec_datagram_length(p_dg);
+}
+
+//! Build cyclic frame template of process data group.
+/*!
+ * Assigns indices and pool entries to all group datagrams and prebuilds
+ * their headers. Groups which do not fit into one frame keep using the
+ * per datagram path.
+ *
+ * \param[in]   pec         Pointer to EtherCAT master struct.
+ * \param[in]   group       Number of group.
+ */
+static void ec_pd_group_compile(ec_t *pec, osal_uint32_t group) {
+    assert(pec != NULL);
+    assert(group < pec->pd_group_cnt);
+
+    int ret = EC_OK;
+    ec_pd_group_t *pd = &pec->pd_groups[group];
+    osal_size_t len = 0u;
+
+    osal_mutex_lock(&pd->cdg.lock);
+    pd->tx_template_len = 0u;
+    pd->tx_template_cnt = 0u;
+    osal_mutex_unlock(&pd->cdg.lock);
+
+    ec_pd_group_split(pec, group);
+
+    if ((pd->chunk_cnt == 0u) && (pd->log_len > 0u)) {
+        if (pd->use_lrw != 0) {
+            osal_mutex_lock(&pd->cdg.lock);
+            ret = ec_cyclic_datagram_alloc(pec, &pd->cdg, cb_process_data_group, pd->group);
+            osal_mutex_unlock(&pd->cdg.lock);
+            len += ec_datagram_hdr_length + pd->log_len + EC_WKC_SIZE;
+        } else {
+            osal_mutex_lock(&pd->cdg_lwr.lock);
+            ret = ec_cyclic_datagram_alloc(pec, &pd->cdg_lwr, cb_process_data_group_lwr, pd->group);
+            osal_mutex_unlock(&pd->cdg_lwr.lock);
+
+            if (ret == EC_OK) {
+                osal_mutex_lock(&pd->cdg_lrd.lock);
+                ret = ec_cyclic_datagram_alloc(pec, &pd->cdg_lrd, cb_process_data_group, pd->group);
+                osal_mutex_unlock(&pd->cdg_lrd.lock);
             }
+            
+            len += (2u * (ec_datagram_hdr_length + EC_WKC_SIZE)) + pd->pdout_len + pd->pdin_len;
         }
+    }
 
-        if (ret == EC_OK) {
-            if (pd->log_len > 0u) {
-                p_dg = ec_datagram_cast(pd->cdg_lrd.p_entry->data);
+    if ((ret == EC_OK) && (pd->log_mbx_state_len > 0u)) {
+        osal_mutex_lock(&pd->cdg_lrd_mbx_state.lock);
+        ret = ec_cyclic_datagram_alloc(pec, &pd->cdg_lrd_mbx_state, cb_lrd_mbx_state, pd->group);
+        osal_mutex_unlock(&pd->cdg_lrd_mbx_state.lock);
+        len += ec_datagram_hdr_length + pd->log_mbx_state_len + EC_WKC_SIZE;
+    }
 
-                (void)memset(p_dg, 0, sizeof(ec_datagram_t) + pd->log_len + 2u);
-                p_dg->cmd = EC_CMD_LRD;
-                p_dg->idx = pd->cdg_lrd.p_idx->idx;
-                p_dg->adr = pd->log + pd->pdout_len;
-                p_dg->len = pd->pdin_len;
+    if (ret != EC_OK) {
+        ec_log(1, "MASTER_COMPILE_PD", "group %2" PRIu32 ": could not allocate datagrams, "
+                "using uncompiled cycle\n", group);
+    } else if (pd->chunk_cnt > 0u) {
+        ec_log(10, "MASTER_COMPILE_PD", "group %2" PRIu32 ": split into %" PRIu64 " datagrams, "
+                "using uncompiled cycle\n", group, (osal_uint64_t)pd->chunk_cnt);
+    } else if ((pd->pipeline_depth > 1u) && (pd->use_lrw != 0)) {
+        ec_log(10, "MASTER_COMPILE_PD", "group %2" PRIu32 ": %" PRIu64 " overlapped cycles, "
+                "using uncompiled cycle\n", group, (osal_uint64_t)pd->pipeline_depth);
+    } else if ((len == 0u) || (len > sizeof(pd->tx_template)) || 
+            ((len + ec_frame_hdr_length) > pec->phw->mtu_size)) {
+        ec_log(10, "MASTER_COMPILE_PD", "group %2" PRIu32 ": %" PRIu64 " bytes do not fit into "
+                "one frame, using uncompiled cycle\n", group, (osal_uint64_t)len);
+    } else {
+        osal_mutex_lock(&pd->cdg.lock);
 
-                // queue frame and trigger tx
-                hw_enqueue(pec->phw, pd->cdg_lrd.p_entry, POOL_HIGH);           
+        if (pd->log_len > 0u) {
+            if (pd->use_lrw != 0) {
+                pd->tx_template_out_off = ec_datagram_hdr_length;
+                ec_pd_group_template_add(pd, &pd->cdg, EC_CMD_LRW, pd->log, pd->log_len);
+            } else {
+                pd->tx_template_out_off = ec_datagram_hdr_length;
+                ec_pd_group_template_add(pd, &pd->cdg_lwr, EC_CMD_LWR, pd->log, pd->pdout_len);
+                ec_pd_group_template_add(pd, &pd->cdg_lrd, EC_CMD_LRD, pd->log + pd->pdout_len, pd->pdin_len);
             }
         }
 
-        osal_mutex_unlock(&pd->cdg_lrd.lock);
+        if (pd->log_mbx_state_len > 0u) {
+            ec_pd_group_template_add(pd, &pd->cdg_lrd_mbx_state, EC_CMD_LRD, 
+                    pd->log_mbx_state, pd->log_mbx_state_len);
+        }
+
+        ec_log(10, "MASTER_COMPILE_PD", "group %2" PRIu32 ": compiled cycle with %" PRIu64 
+                " datagrams, %" PRIu64 " bytes\n", group, (osal_uint64_t)pd->tx_template_cnt, 
+                (osal_uint64_t)pd->tx_template_len);
+
+        osal_mutex_unlock(&pd->cdg.lock);
     }
-        
-    osal_mutex_lock(&pd->cdg_lrd_mbx_state.lock);
+}
 
-    if (pd->cdg_lrd_mbx_state.p_idx == NULL) {
-        if (ec_index_get(&pec->idx_q, &pd->cdg_lrd_mbx_state.p_idx) != EC_OK) {
-            ec_log(1, "MASTER_SEND_PD_GROUP", "error getting ethercat index\n");
-            ret = EC_ERROR_OUT_OF_INDICES;
+//! send process data for specific group with logical commands
+/*!
+ * \param pec ethercat master pointer
+ * \param group group number
+ * \return 0 on success
+ */
+static int ec_send_process_data_group(ec_t *pec, int group) {
+    assert(pec != NULL);
+    assert(group < pec->pd_group_cnt);
+
+    int ret = EC_OK;
+    ec_pd_group_t *pd = &pec->pd_groups[group];
+    osal_bool_t compiled = OSAL_FALSE;
+    osal_bool_t chunked = OSAL_FALSE;
+
+#ifdef LIBETHERCAT_DEBUG
+    ec_log(100, "MASTER_SEND_PD_GROUP", "group %2d: sending process data\n", group);
+#endif
+
+    osal_mutex_lock(&pd->cdg.lock);
+
+    if ((pd->use_triple_buffer != 0) && (ec_pd_triple_buffer_acquire(&pd->tb_out) == OSAL_TRUE)) {
+        // take over outputs published by application
+        (void)memcpy(&pd->pd[0], &pd->tb_out.buf[pd->tb_out.front][0], pd->pdout_len);
+    }
+
+    if (pd->chunk_cnt > 0u) {
+        // group larger than one frame, send all chunks in one burst
+        chunked = OSAL_TRUE;
+        ret = ec_pd_group_send_chunks(pec, pd);
+    } else if ((pd->tx_template_len > 0u) && (pec->phw->tx_frame_in_place == OSAL_TRUE)) {
+        // compiled cycle, copy prebuilt datagrams and patch outputs
+        osal_uint8_t *p_data = NULL;
+
+        compiled = OSAL_TRUE;
+        ret = hw_tx_frame_add_template(pec->phw, pd->tx_template, pd->tx_template_len, 
+                pd->tx_template_entries, pd->tx_template_cnt, &p_data);
+        if ((ret == EC_OK) && (pd->log_len > 0u) && (pd->pdout_len > 0u)) {
+            (void)memcpy(&p_data[pd->tx_template_out_off], pd->pd, pd->pdout_len);
         }
     }
 
-    if ((ret == EC_OK) && (pd->cdg_lrd_mbx_state.p_entry == NULL)) {
-        if (pool_get(&pec->pool, &pd->cdg_lrd_mbx_state.p_entry, NULL) != EC_OK) {
-            ec_index_put(&pec->idx_q, pd->cdg_lrd_mbx_state.p_idx);
-            pd->cdg_lrd_mbx_state.p_idx = NULL;
-            ec_log(1, "MASTER_SEND_PD_GROUP", "error getting datagram from pool\n");
-            ret = EC_ERROR_OUT_OF_DATAGRAMS;
-        } else {
-            pd->cdg_lrd_mbx_state.p_entry->p_idx = pd->cdg_lrd_mbx_state.p_idx;
-            pd->cdg_lrd_mbx_state.p_entry->user_cb = cb_lrd_mbx_state;
-            pd->cdg_lrd_mbx_state.p_entry->user_arg = pd->group;
+    if ((compiled == OSAL_FALSE) && (chunked == OSAL_FALSE) && (pd->use_lrw == OSAL_TRUE)) {
+        // overlapped cycles use the next slot with its own datagram index
+        osal_size_t slot = pd->pipeline_slot;
+        ec_cyclic_datagram_t *cdg = (slot == 0u) ? &pd->cdg : &pd->cdg_pipeline[slot];
+        pd->pipeline_slot = ((slot + 1u) < pd->pipeline_depth) ? (slot + 1u) : 0u;
+        pd->pipeline_cycle[slot] = ++pd->pipeline_tx_cycle;
+
+        if (slot != 0u) {
+            osal_mutex_lock(&cdg->lock);
+        }
+
+        ret = ec_cyclic_datagram_alloc(pec, cdg, cb_process_data_group, pd->group);
+
+        if ((ret == EC_OK) && (pd->log_len > 0u)) {
+            ret = ec_cyclic_datagram_send(pec, cdg, EC_CMD_LRW, pd->log, 
+                    pd->log_len, pd->pd, pd->pdout_len);
+        }
+
+        if (slot != 0u) {
+            osal_mutex_unlock(&cdg->lock);
         }
     }
 
-    if (ret == EC_OK) {
-        if (pd->log_mbx_state_len > 0u) {
-            p_dg = ec_datagram_cast(pd->cdg_lrd_mbx_state.p_entry->data);
+    osal_mutex_unlock(&pd->cdg.lock);
 
-            (void)memset(p_dg, 0, sizeof(ec_datagram_t) + pd->log_mbx_state_len + 2u);
-            p_dg->cmd = EC_CMD_LRD;
-            p_dg->idx = pd->cdg_lrd_mbx_state.p_idx->idx;
-            p_dg->adr = pd->log_mbx_state;
-            p_dg->len = pd->log_mbx_state_len;
+    if (compiled == OSAL_FALSE) {
+        if ((chunked == OSAL_FALSE) && (pd->use_lrw != OSAL_TRUE)) {
+            osal_mutex_lock(&pd->cdg_lwr.lock);
 
-            // queue frame and trigger tx
-            hw_enqueue(pec->phw, pd->cdg_lrd_mbx_state.p_entry, POOL_HIGH);           
+            ret = ec_cyclic_datagram_alloc(pec, &pd->cdg_lwr, cb_process_data_group_lwr, pd->group);
+            if ((ret == EC_OK) && (pd->log_len > 0u)) {
+                ret = ec_cyclic_datagram_send(pec, &pd->cdg_lwr, EC_CMD_LWR, pd->log, 
+                        pd->pdout_len, pd->pd, pd->pdout_len);
+            }
+
+            osal_mutex_unlock(&pd->cdg_lwr.lock);
+            
+            osal_mutex_lock(&pd->cdg_lrd.lock);
+
+            if (ret == EC_OK) {
+                ret = ec_cyclic_datagram_alloc(pec, &pd->cdg_lrd, cb_process_data_group, pd->group);
+            }
+
+            if ((ret == EC_OK) && (pd->log_len > 0u)) {
+                ret = ec_cyclic_datagram_send(pec, &pd->cdg_lrd, EC_CMD_LRD, pd->log + pd->pdout_len, 
+                        pd->pdin_len, NULL, 0u);
+            }
+
+            osal_mutex_unlock(&pd->cdg_lrd.lock);
+        }
+            
+        osal_mutex_lock(&pd->cdg_lrd_mbx_state.lock);
+
+        if (ret == EC_OK) {
+            ret = ec_cyclic_datagram_alloc(pec, &pd->cdg_lrd_mbx_state, cb_lrd_mbx_state, pd->group);
+        }
+
+        // overlapped cycles, skip mailbox state while last one is on the wire
+        osal_bool_t mbx_state_busy = OSAL_FALSE;
+        if ((pd->pipeline_depth > 1u) && (pd->cdg_lrd_mbx_state.p_idx != NULL)) {
+            mbx_state_busy = (pec->phw->tx_send[pd->cdg_lrd_mbx_state.p_idx->idx] != NULL) ? OSAL_TRUE : OSAL_FALSE;
+        }
+
+        if ((ret == EC_OK) && (mbx_state_busy == OSAL_FALSE) && (pd->log_mbx_state_len > 0u)) {
+            ret = ec_cyclic_datagram_send(pec, &pd->cdg_lrd_mbx_state, EC_CMD_LRD, pd->log_mbx_state, 
+                    pd->log_mbx_state_len, NULL, 0u);
         }
+        
+        osal_mutex_unlock(&pd->cdg_lrd_mbx_state.lock);
     }
-    
-    osal_mutex_unlock(&pd->cdg_lrd_mbx_state.lock);
 
     return ret;
 }
@@ -1890,13 +2831,24 @@ int ec_send_process_data(ec_t *pec) {
     int ret = EC_OK;
     int i;
 
+    ec_trace_instant(EC_TRACE_CYCLE, 0);
+
+    osal_uint64_t now = osal_timer_gettime_nsec();
+    if ((pec->last_cycle_start != 0u) && (pec->main_cycle_interval > 0)) {
+        osal_int64_t jitter = (osal_int64_t)(now - pec->last_cycle_start) - pec->main_cycle_interval;
+        ec_histogram_add(&pec->stats.cycle_jitter, (osal_uint64_t)((jitter < 0) ? -jitter : jitter));
+    }
+    pec->last_cycle_start = now;
+
     for (i = 0; i < pec->pd_group_cnt; ++i) {
         ec_pd_group_t *pd = &pec->pd_groups[i];
 
         if ((++pd->divisor_cnt % pd->divisor) == 0) {
             // reset divisor cnt and queue datagram
             pd->divisor_cnt = 0;
+            ec_trace_begin(EC_TRACE_SEND_GROUP, i);
             ret = ec_send_process_data_group(pec, i);
+            ec_trace_end(EC_TRACE_SEND_GROUP, i);
         }
 
         if (ret != EC_OK) {
@@ -1907,6 +2859,40 @@ int ec_send_process_data(ec_t *pec) {
     return ret;
 }
 
+// get cycle statistics
+void ec_get_statistics(ec_t *pec, ec_statistics_t *stats, int reset) {
+    assert(pec != NULL);
+    assert(stats != NULL);
+
+    ec_statistics_t *s = &pec->stats;
+
+    if (reset != 0) {
+        stats->lost_datagrams = __atomic_exchange_n(&s->lost_datagrams, 0u, __ATOMIC_RELAXED);
+        stats->tx_window_datagrams = __atomic_exchange_n(&s->tx_window_datagrams, 0u, __ATOMIC_RELAXED);
+        stats->tx_window_saved_ns = __atomic_exchange_n(&s->tx_window_saved_ns, 0u, __ATOMIC_RELAXED);
+        stats->tx_window_late = __atomic_exchange_n(&s->tx_window_late, 0u, __ATOMIC_RELAXED);
+        stats->tx_window_missed = __atomic_exchange_n(&s->tx_window_missed, 0u, __ATOMIC_RELAXED);
+        for (osal_size_t i = 0u; i < LEC_MAX_GROUPS; ++i) {
+            stats->wkc_mismatch[i] = __atomic_exchange_n(&s->wkc_mismatch[i], 0u, __ATOMIC_RELAXED);
+        }
+    } else {
+        stats->lost_datagrams = __atomic_load_n(&s->lost_datagrams, __ATOMIC_RELAXED);
+        stats->tx_window_datagrams = __atomic_load_n(&s->tx_window_datagrams, __ATOMIC_RELAXED);
+        stats->tx_window_saved_ns = __atomic_load_n(&s->tx_window_saved_ns, __ATOMIC_RELAXED);
+        stats->tx_window_late = __atomic_load_n(&s->tx_window_late, __ATOMIC_RELAXED);
+        stats->tx_window_missed = __atomic_load_n(&s->tx_window_missed, __ATOMIC_RELAXED);
+        for (osal_size_t i = 0u; i < LEC_MAX_GROUPS; ++i) {
+            stats->wkc_mismatch[i] = __atomic_load_n(&s->wkc_mismatch[i], __ATOMIC_RELAXED);
+        }
+    }
+
+    ec_histogram_snapshot(&s->tx_duration, &stats->tx_duration, reset);
+    ec_histogram_snapshot(&s->rx_duration, &stats->rx_duration, reset);
+    ec_histogram_snapshot(&s->round_trip, &stats->round_trip, reset);
+    ec_histogram_snapshot(&s->cycle_jitter, &stats->cycle_jitter, reset);
+    ec_histogram_snapshot(&s->dc_diff, &stats->dc_diff, reset);
+}
+
 //! local callack for syncronous read/write
 static void cb_distributed_clocks(struct ec *pec, pool_entry_t *p_entry, ec_datagram_t *p_dg) {
     assert(pec != NULL);
@@ -1938,6 +2924,7 @@ static void cb_distributed_clocks(struct ec *pec, pool_entry_t *p_entry, ec_data
 
         // get clock difference
         pec->dc.act_diff = signed64_diff((pec->dc.rtc_time % UINT64_MAX), pec->dc.dc_time); 
+        ec_histogram_add(&pec->stats.dc_diff, (osal_uint64_t)((pec->dc.act_diff < 0) ? -pec->dc.act_diff : pec->dc.act_diff));
 
         if (pec->dc.mode == dc_mode_ref_clock) {
             // calc proportional part
@@ -1983,7 +2970,7 @@ static void cb_distributed_clocks(struct ec *pec, pool_entry_t *p_entry, ec_data
                 p_entry_dc_sto->user_cb = cb_no_reply;
 
                 // queue frame and trigger tx
-                pool_put(&pec->phw->tx_low, p_entry_dc_sto);
+                pool_mpsc_put(&pec->phw->tx_low, p_entry_dc_sto);
             }
         } else {}
     }
@@ -2009,19 +2996,19 @@ int ec_send_distributed_clocks_sync_intern(ec_t *pec, osal_uint64_t act_rtc_time
     assert(pec != NULL);
 
     int ret = EC_OK;
-    ec_datagram_t *p_dg = NULL;
 
 #ifdef LIBETHERCAT_DEBUG
     ec_log(100, "MASTER_SEND_DC", "sending distributed clock\n");
 #endif
 
+    ec_trace_begin(EC_TRACE_SEND_DC, 0);
     osal_mutex_lock(&pec->dc.cdg.lock);
 
     if (!pec->dc.have_dc) {
         ret = EC_ERROR_UNAVAILABLE;
     } else {
         if (pec->dc.cdg.p_idx == NULL) {
-            if (ec_index_get(&pec->idx_q, &pec->dc.cdg.p_idx) != EC_OK) {
+            if (ec_index_get_cyclic(&pec->idx_q, &pec->dc.cdg.p_idx) != EC_OK) {
                 ec_log(1, "MASTER_SEND_DC", "error getting ethercat index\n");
                 ret = EC_ERROR_OUT_OF_INDICES;
             } 
@@ -2039,36 +3026,25 @@ int ec_send_distributed_clocks_sync_intern(ec_t *pec, osal_uint64_t act_rtc_time
         }
 
         if (ret == EC_OK) {
-            p_dg = ec_datagram_cast(pec->dc.cdg.p_entry->data);
-            (void)memset(p_dg, 0, sizeof(ec_datagram_t) + 8u + 2u);
+            pec->dc.rtc_time = (int64_t)act_rtc_time;
 
-            p_dg->idx = pec->dc.cdg.p_idx->idx;
-            p_dg->len = 8;
+            // queue frame and trigger tx
+            pec->dc.sent_time_nsec = osal_timer_gettime_nsec();
 
             if (pec->dc.mode == dc_mode_master_as_ref_clock) {
-                p_dg->cmd = EC_CMD_BWR;
-                p_dg->adr = ((osal_uint32_t)EC_REG_DCSYSTIME << 16u);
+                ret = ec_cyclic_datagram_send(pec, &pec->dc.cdg, EC_CMD_BWR, 
+                        ((osal_uint32_t)EC_REG_DCSYSTIME << 16u), 8u, 
+                        (osal_uint8_t *)&pec->dc.rtc_time, sizeof(pec->dc.rtc_time));
             } else {
-                p_dg->cmd = EC_CMD_FRMW;
-                p_dg->adr = ((osal_uint32_t)EC_REG_DCSYSTIME << 16u) | pec->dc.master_address;
+                ret = ec_cyclic_datagram_send(pec, &pec->dc.cdg, EC_CMD_FRMW, 
+                        ((osal_uint32_t)EC_REG_DCSYSTIME << 16u) | pec->dc.master_address, 8u, 
+                        NULL, 0u);
             }
-
-            pec->dc.rtc_time = (int64_t)act_rtc_time;
-
-            if (pec->dc.mode == dc_mode_master_as_ref_clock) {
-                (void)memcpy(
-                        (osal_uint8_t *)ec_datagram_payload(p_dg), 
-                        (osal_uint8_t *)&pec->dc.rtc_time, 
-                        sizeof(pec->dc.rtc_time));
-            }
-
-            // queue frame and trigger tx
-            pec->dc.sent_time_nsec = osal_timer_gettime_nsec();
-            hw_enqueue(pec->phw, pec->dc.cdg.p_entry, POOL_HIGH);
         }
     }
 
     osal_mutex_unlock(&pec->dc.cdg.lock);
+    ec_trace_end(EC_TRACE_SEND_DC, 0);
 
     return ret;
 }
@@ -2165,7 +3141,7 @@ int ec_send_brd_ec_state(ec_t *pec) {
     osal_mutex_lock(&pec->cdg_state.lock);
 
     if (pec->cdg_state.p_idx == NULL) {
-        if (ec_index_get(&pec->idx_q, &pec->cdg_state.p_idx) != EC_OK) {
+        if (ec_index_get_cyclic(&pec->idx_q, &pec->cdg_state.p_idx) != EC_OK) {
             ec_log(1, "MASTER_SEND_BRD_STATE", "error getting ethercat index\n");
             ret = EC_ERROR_OUT_OF_INDICES;
         } 
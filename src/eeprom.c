@@ -50,6 +50,10 @@
 #include <string.h>
 #include <inttypes.h>
 
+#if LIBETHERCAT_BUILD_POSIX == 1
+#include <stdio.h>
+#endif
+
 // cppcheck-suppress misra-c2012-20.10
 #define SII_REG(ac, adr, val)                                          \
     cnt = 100u;                                                        \
@@ -248,6 +252,50 @@ int ec_eepromread(ec_t *pec, osal_uint16_t slave, osal_uint32_t eepadr, osal_uin
     return ret;
 }
 
+#if LIBETHERCAT_BUILD_POSIX == 1
+//! Build cache file name of slave's eeprom.
+/*!
+ * The name is made of vendor id, product code, revision, serial number and 
+ * the checksum of the eeprom's config area, which are taken from the image.
+ *
+ * \param[in]  pec         Pointer to EtherCAT master structure.
+ * \param[in]  slave       Number of EtherCAT slave.
+ * \param[out] path        Buffer for file name.
+ * \param[in]  path_len    Size of path buffer.
+ *
+ * \return OSAL_TRUE if the image holds a valid config area and caching is enabled.
+ */
+static osal_bool_t ec_eeprom_cache_path(ec_t *pec, osal_uint16_t slave, osal_char_t *path, osal_size_t path_len) {
+    osal_bool_t ret = OSAL_FALSE;
+    ec_slave_ptr(slv, pec, slave);
+    const osal_uint8_t *image = &slv->eeprom.image[0];
+
+    if ((pec->eeprom_cache_dir[0] != '\0') && (slv->eeprom.image_len >= EC_EEPROM_CACHE_KEY_LEN)) {
+        // crc-8 with polynomial 0x07 over words 0 to 6
+        osal_uint8_t crc = 0xFFu;
+        for (osal_size_t i = 0u; i < (EC_EEPROM_ADR_CHECKSUM * 2u); ++i) {
+            crc ^= image[i];
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = ((crc & 0x80u) != 0u) ? (osal_uint8_t)((crc << 1u) ^ 0x07u) : (osal_uint8_t)(crc << 1u);
+            }
+        }
+
+        if (crc == image[EC_EEPROM_ADR_CHECKSUM * 2u]) {
+            osal_uint32_t id[4];
+            (void)memcpy(&id[0], &image[EC_EEPROM_ADR_VENDOR_ID * 2u], sizeof(id));
+
+            int len = snprintf(path, path_len, "%s/%08X_%08X_%08X_%08X_%02X.sii", 
+                    pec->eeprom_cache_dir, id[0], id[1], id[2], id[3], crc);
+            if ((len > 0) && ((osal_size_t)len < path_len)) {
+                ret = OSAL_TRUE;
+            }
+        }
+    }
+
+    return ret;
+}
+#endif
+
 // write 32-bit word of eeprom
 int ec_eepromwrite(ec_t *pec, osal_uint16_t slave, osal_uint32_t eepadr, osal_uint16_t *data) {
     assert(pec != NULL);
@@ -262,6 +310,15 @@ int ec_eepromwrite(ec_t *pec, osal_uint16_t slave, osal_uint32_t eepadr, osal_ui
     osal_uint16_t wkc = 0;
     osal_uint16_t eepcsr = 0x0100; // write access
     osal_timer_t timeout;
+
+    // prefetched and cached contents are outdated now
+#if LIBETHERCAT_BUILD_POSIX == 1
+    osal_char_t path[LEC_MAX_STRING_LEN + 64u];
+    if (ec_eeprom_cache_path(pec, slave, path, sizeof(path)) == OSAL_TRUE) {
+        (void)remove(path);
+    }
+#endif
+    pec->slaves[slave].eeprom.image_len = 0u;
     
     ret = ec_eeprom_to_ec(pec, slave);
     
@@ -415,6 +472,13 @@ int ec_eepromread_len(ec_t *pec, osal_uint16_t slave, osal_uint32_t eepadr,
 
     osal_off_t offset = 0;
     int ret = EC_OK;
+
+    ec_slave_ptr(slv, pec, slave);
+    if (((eepadr * 2u) + buflen) <= slv->eeprom.image_len) {
+        // already prefetched
+        (void)memcpy(buf, &slv->eeprom.image[eepadr * 2u], buflen);
+        offset = buflen;
+    }
     
     while (offset < buflen) {
         osal_uint8_t val[4];
@@ -472,6 +536,418 @@ int ec_eepromwrite_len(ec_t *pec, osal_uint16_t slave, osal_uint32_t eepadr,
     return ret;
 };
 
+//! Per slave state of eeprom prefetch.
+typedef struct ec_eeprom_prefetch_state {
+    osal_bool_t owned;          //!< EEPROM was assigned to EtherCAT.
+    osal_bool_t active;         //!< Slave is still read.
+    osal_bool_t busy;           //!< Read command issued, waiting for completion.
+    osal_bool_t failed;         //!< Read failed, image is incomplete.
+    osal_bool_t cached;         //!< Image was loaded from cache.
+    osal_bool_t verify;         //!< Category headers of cached image are compared with eeprom.
+    osal_uint8_t step;          //!< Bytes per read access, 4 or 8.
+    osal_uint8_t retries;       //!< Retries left on missing eeprom acknowledge.
+    osal_size_t end;            //!< Bytes to read at most.
+    osal_size_t next_cat;       //!< Byte offset of next category header, read or compared.
+    osal_uint64_t deadline;     //!< Timeout of current access [ns].
+    osal_uint8_t regs[14];      //!< EEPCTL, EEPADR and EEPDAT.
+} ec_eeprom_prefetch_state_t;
+
+//! Same eeprom register access on all slaves in given state.
+/*!
+ * \param[in]     pec       Pointer to EtherCAT master structure.
+ * \param[in,out] st        Prefetch state of all slaves, data is taken 
+ *                          from and returned to regs.
+ * \param[in]     busy      Select active slaves with this busy state.
+ * \param[in]     cmd       EtherCAT command.
+ * \param[in]     ado       Register address.
+ * \param[in]     datalen   Length of data.
+ * \param[out]    wkc       Working counter of each slave.
+ *
+ * \return EC_OK or error code
+ */
+static int ec_eeprom_prefetch_batch(ec_t *pec, ec_eeprom_prefetch_state_t *st, osal_bool_t busy,
+        osal_uint8_t cmd, osal_uint16_t ado, osal_size_t datalen, osal_uint16_t *wkc)
+{
+    int ret = EC_OK;
+    ec_batch_req_t reqs[LEC_MAX_BATCH_DATAGRAMS];
+    osal_uint16_t req_slave[LEC_MAX_BATCH_DATAGRAMS];
+    osal_uint16_t slave = 0u;
+
+    while (slave < pec->slave_cnt) {
+        osal_size_t n = 0u;
+
+        for (; (slave < pec->slave_cnt) && (n < LEC_MAX_BATCH_DATAGRAMS); ++slave) {
+            if ((st[slave].active == OSAL_TRUE) && (st[slave].busy == busy)) {
+                reqs[n].cmd = cmd;
+                reqs[n].adr = ((osal_uint32_t)ado << 16u) | pec->slaves[slave].fixed_address;
+                reqs[n].data = &st[slave].regs[0];
+                reqs[n].datalen = datalen;
+                req_slave[n] = slave;
+                n++;
+            }
+        }
+
+        if (n > 0u) {
+            int local_ret = ec_batch_transceive(pec, reqs, n);
+            if (ret == EC_OK) {
+                ret = local_ret;
+            }
+
+            for (osal_size_t k = 0u; k < n; ++k) {
+                wkc[req_slave[k]] = reqs[k].wkc;
+            }
+        }
+    }
+
+    return ret;
+}
+
+//! Store read eeprom data and check if slave's image is complete.
+/*!
+ * \param[in,out] eeprom    EEPROM info of slave.
+ * \param[in,out] st        Prefetch state of slave.
+ */
+static void ec_eeprom_prefetch_store(eeprom_info_t *eeprom, ec_eeprom_prefetch_state_t *st) {
+    osal_size_t len = LEC_MIN((osal_size_t)st->step, st->end - eeprom->image_len);
+    (void)memcpy(&eeprom->image[eeprom->image_len], &st->regs[6], len);
+    eeprom->image_len += len;
+
+    if ((eeprom->image_len == (EC_EEPROM_ADR_CAT_OFFSET * 2u)) && (eeprom->image_len < st->end)) {
+        // header complete, limit to eeprom size
+        osal_size_t kbit = (osal_size_t)eeprom->image[EC_EEPROM_ADR_SIZE * 2u] | 
+            ((osal_size_t)eeprom->image[(EC_EEPROM_ADR_SIZE * 2u) + 1u] << 8u);
+        st->end = LEC_MIN(st->end, (kbit + 1u) * 128u);
+    }
+
+    // follow category headers as far as read
+    while ((eeprom->image_len >= (EC_EEPROM_ADR_CAT_OFFSET * 2u)) && 
+            (eeprom->image_len >= (st->next_cat + 4u)) && (st->active == OSAL_TRUE)) {
+        osal_uint16_t cat_type = (osal_uint16_t)eeprom->image[st->next_cat] | 
+            ((osal_uint16_t)eeprom->image[st->next_cat + 1u] << 8u);
+        osal_uint16_t cat_len = (osal_uint16_t)eeprom->image[st->next_cat + 2u] | 
+            ((osal_uint16_t)eeprom->image[st->next_cat + 3u] << 8u);
+
+        if (cat_type == EC_EEPROM_CAT_END) {
+            st->active = OSAL_FALSE;
+        } else {
+            st->next_cat += 4u + ((osal_size_t)cat_len * 2u);
+        }
+    }
+
+    if (eeprom->image_len >= st->end) {
+        st->active = OSAL_FALSE;
+    }
+}
+
+//! Compare category header read from eeprom with cached image.
+/*!
+ * A mismatch means the eeprom was rewritten without changing the identity
+ * words, the slave is then read completely like one not cached.
+ *
+ * \param[in,out] eeprom    EEPROM info of slave.
+ * \param[in,out] st        Prefetch state of slave.
+ */
+static void ec_eeprom_prefetch_verify(eeprom_info_t *eeprom, ec_eeprom_prefetch_state_t *st) {
+    if (((st->next_cat + 4u) > eeprom->image_len) || 
+            (memcmp(&eeprom->image[st->next_cat], &st->regs[6], 4u) != 0)) {
+        st->verify = OSAL_FALSE;
+        st->cached = OSAL_FALSE;
+        st->end = LEC_MAX_EEPROM_IMAGE_SIZE;
+        st->next_cat = EC_EEPROM_ADR_CAT_OFFSET * 2u;
+        eeprom->image_len = EC_EEPROM_CACHE_KEY_LEN;
+    } else {
+        osal_uint16_t cat_type = (osal_uint16_t)st->regs[6] | ((osal_uint16_t)st->regs[7] << 8u);
+        osal_uint16_t cat_len = (osal_uint16_t)st->regs[8] | ((osal_uint16_t)st->regs[9] << 8u);
+
+        if (cat_type == EC_EEPROM_CAT_END) {
+            st->verify = OSAL_FALSE;
+            st->active = OSAL_FALSE;
+        } else {
+            st->next_cat += 4u + ((osal_size_t)cat_len * 2u);
+        }
+    }
+}
+
+//! Read eeprom of all active slaves in lock step.
+/*!
+ * \param[in]     pec       Pointer to EtherCAT master structure.
+ * \param[in,out] st        Prefetch state of all slaves.
+ * \param[out]    wkc       Working counter buffer for all slaves.
+ *
+ * \return EC_OK or EC_ERROR_EEPROM_READ_ERROR if at least one slave failed.
+ */
+static int ec_eeprom_prefetch_read(ec_t *pec, ec_eeprom_prefetch_state_t *st, osal_uint16_t *wkc) {
+    int ret = EC_OK;
+    osal_uint16_t slave;
+
+    osal_bool_t pending = OSAL_TRUE;
+    while (pending == OSAL_TRUE) {
+        // issue read command, control and address with one write
+        for (slave = 0u; slave < pec->slave_cnt; ++slave) {
+            osal_uint32_t eepadr = (osal_uint32_t)(((st[slave].verify == OSAL_TRUE) ? 
+                        st[slave].next_cat : pec->slaves[slave].eeprom.image_len) / 2u);
+            st[slave].regs[0] = 0x00u;
+            st[slave].regs[1] = 0x01u;
+            st[slave].regs[2] = (osal_uint8_t)(eepadr & 0xFFu);
+            st[slave].regs[3] = (osal_uint8_t)((eepadr >> 8u) & 0xFFu);
+            st[slave].regs[4] = (osal_uint8_t)((eepadr >> 16u) & 0xFFu);
+            st[slave].regs[5] = (osal_uint8_t)((eepadr >> 24u) & 0xFFu);
+        }
+
+        (void)ec_eeprom_prefetch_batch(pec, st, OSAL_FALSE, EC_CMD_FPWR, EC_REG_EEPCTL, 6u, wkc);
+
+        osal_uint64_t deadline = osal_timer_gettime_nsec() + 100000000u; // 100 ms
+        for (slave = 0u; slave < pec->slave_cnt; ++slave) {
+            if (st[slave].active == OSAL_TRUE) {
+                st[slave].busy = OSAL_TRUE;
+                st[slave].deadline = deadline;
+            }
+        }
+
+        // poll status and data with one read
+        osal_bool_t busy = OSAL_TRUE;
+        while (busy == OSAL_TRUE) {
+            (void)ec_eeprom_prefetch_batch(pec, st, OSAL_TRUE, EC_CMD_FPRD, EC_REG_EEPCTL, 14u, wkc);
+            osal_uint64_t now = osal_timer_gettime_nsec();
+            busy = OSAL_FALSE;
+
+            for (slave = 0u; slave < pec->slave_cnt; ++slave) {
+                if ((st[slave].active == OSAL_FALSE) || (st[slave].busy == OSAL_FALSE)) {
+                    continue;
+                }
+
+                osal_uint16_t eepcsr = (osal_uint16_t)st[slave].regs[0] | ((osal_uint16_t)st[slave].regs[1] << 8u);
+
+                if ((wkc[slave] == 1u) && ((eepcsr & 0x8000u) == 0u)) {
+                    st[slave].busy = OSAL_FALSE;
+
+                    if (((eepcsr & 0x2000u) != 0u) && (st[slave].retries > 0u)) {
+                        // missing acknowledge, read again
+                        st[slave].retries--;
+                    } else if ((eepcsr & 0x6800u) != 0u) {
+                        ec_log(1, "EEPROM_PREFETCH", "slave %2d: read error at %" PRIu64 ", eepcsr 0x%04X\n",
+                                slave, (osal_uint64_t)pec->slaves[slave].eeprom.image_len, eepcsr);
+                        st[slave].active = OSAL_FALSE;
+                        st[slave].failed = OSAL_TRUE;
+                        ret = EC_ERROR_EEPROM_READ_ERROR;
+                    } else if (st[slave].verify == OSAL_TRUE) {
+                        ec_eeprom_prefetch_verify(&pec->slaves[slave].eeprom, &st[slave]);
+                    } else {
+                        ec_eeprom_prefetch_store(&pec->slaves[slave].eeprom, &st[slave]);
+                    }
+                } else if (now > st[slave].deadline) {
+                    ec_log(1, "EEPROM_PREFETCH", "slave %2d: read timeout at %" PRIu64 ", wkc %d\n",
+                            slave, (osal_uint64_t)pec->slaves[slave].eeprom.image_len, wkc[slave]);
+                    st[slave].active = OSAL_FALSE;
+                    st[slave].busy = OSAL_FALSE;
+                    st[slave].failed = OSAL_TRUE;
+                    ret = EC_ERROR_EEPROM_READ_ERROR;
+                } else {
+                    busy = OSAL_TRUE;
+                }
+            }
+        }
+
+        pending = OSAL_FALSE;
+        for (slave = 0u; slave < pec->slave_cnt; ++slave) {
+            if (st[slave].active == OSAL_TRUE) {
+                pending = OSAL_TRUE;
+            }
+        }
+    }
+
+    return ret;
+}
+
+//! Load eeprom image from cache.
+/*!
+ * The cached image is read directly behind the identity words already in 
+ * the slave's image. On failure the image is left with these words only.
+ *
+ * \param[in]  pec         Pointer to EtherCAT master structure.
+ * \param[in]  slave       Number of EtherCAT slave, the image has to hold 
+ *                         at least the identity words.
+ *
+ * \return OSAL_TRUE if a cached image with the same identity words was loaded.
+ */
+static osal_bool_t ec_eeprom_cache_load(ec_t *pec, osal_uint16_t slave) {
+    osal_bool_t ret = OSAL_FALSE;
+
+#if LIBETHERCAT_BUILD_POSIX == 1
+    ec_slave_ptr(slv, pec, slave);
+    osal_char_t path[LEC_MAX_STRING_LEN + 64u];
+    osal_uint8_t key[EC_EEPROM_CACHE_KEY_LEN];
+
+    if (ec_eeprom_cache_path(pec, slave, path, sizeof(path)) == OSAL_TRUE) {
+        FILE *fp = fopen(path, "rb");
+        if (fp != NULL) {
+            osal_size_t len = fread(key, 1u, sizeof(key), fp);
+
+            if ((len == sizeof(key)) && (memcmp(key, slv->eeprom.image, sizeof(key)) == 0)) {
+                len += fread(&slv->eeprom.image[sizeof(key)], 1u, sizeof(slv->eeprom.image) - sizeof(key), fp);
+            }
+            (void)fclose(fp);
+
+            if (len >= (EC_EEPROM_ADR_CAT_OFFSET * 2u)) {
+                slv->eeprom.image_len = len;
+                ret = OSAL_TRUE;
+            } else {
+                ec_log(5, "EEPROM_CACHE", "slave %2d: ignoring invalid cache file %s\n", slave, path);
+            }
+        }
+    }
+#else
+    (void)pec;
+    (void)slave;
+#endif
+
+    return ret;
+}
+
+//! Store eeprom image to cache.
+/*!
+ * \param[in]  pec         Pointer to EtherCAT master structure.
+ * \param[in]  slave       Number of EtherCAT slave with completely read image.
+ */
+static void ec_eeprom_cache_store(ec_t *pec, osal_uint16_t slave) {
+#if LIBETHERCAT_BUILD_POSIX == 1
+    ec_slave_ptr(slv, pec, slave);
+    osal_char_t path[LEC_MAX_STRING_LEN + 64u];
+    osal_char_t tmp_path[LEC_MAX_STRING_LEN + 68u];
+
+    if (ec_eeprom_cache_path(pec, slave, path, sizeof(path)) == OSAL_TRUE) {
+        (void)snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+        // write to temporary file first, so readers never see a partial image
+        FILE *fp = fopen(tmp_path, "wb");
+        if (fp != NULL) {
+            osal_size_t len = fwrite(slv->eeprom.image, 1u, slv->eeprom.image_len, fp);
+            if ((fclose(fp) == 0) && (len == slv->eeprom.image_len) && (rename(tmp_path, path) == 0)) {
+                ec_log(100, "EEPROM_CACHE", "slave %2d: stored %s\n", slave, path);
+            } else {
+                ec_log(5, "EEPROM_CACHE", "slave %2d: could not store %s\n", slave, path);
+                (void)remove(tmp_path);
+            }
+        }
+    }
+#else
+    (void)pec;
+    (void)slave;
+#endif
+}
+
+// set eeprom cache directory
+int ec_eeprom_cache_set_dir(ec_t *pec, const osal_char_t *dir) {
+    assert(pec != NULL);
+
+    int ret = EC_OK;
+
+    if (dir == NULL) {
+        pec->eeprom_cache_dir[0] = '\0';
+    } else if (strlen(dir) >= sizeof(pec->eeprom_cache_dir)) {
+        ret = EC_ERROR_OUT_OF_MEMORY;
+    } else {
+        (void)strcpy(pec->eeprom_cache_dir, dir);
+    }
+
+    return ret;
+}
+
+// prefetch eeprom contents of all slaves
+int ec_eeprom_prefetch(ec_t *pec) {
+    assert(pec != NULL);
+
+    int ret = EC_OK;
+    osal_uint16_t slave;
+    osal_uint16_t wkc[LEC_MAX_SLAVES];
+    ec_eeprom_prefetch_state_t st[LEC_MAX_SLAVES];
+    osal_uint64_t start = osal_timer_gettime_nsec();
+    osal_size_t bytes = 0u;
+    osal_uint16_t hits = 0u;
+
+    for (slave = 0u; slave < pec->slave_cnt; ++slave) {
+        (void)memset(&st[slave], 0, sizeof(st[slave]));
+        st[slave].active = OSAL_TRUE;
+        st[slave].retries = 3u;
+        st[slave].end = EC_EEPROM_CACHE_KEY_LEN;
+        st[slave].next_cat = EC_EEPROM_ADR_CAT_OFFSET * 2u;
+        pec->slaves[slave].eeprom.image_len = 0u;
+    }
+
+    // assign eeprom to EtherCAT and clear former errors
+    (void)ec_eeprom_prefetch_batch(pec, st, OSAL_FALSE, EC_CMD_FPWR, EC_REG_EEPCFG, 4u, wkc);
+    (void)ec_eeprom_prefetch_batch(pec, st, OSAL_FALSE, EC_CMD_FPRD, EC_REG_EEPCFG, 4u, wkc);
+
+    for (slave = 0u; slave < pec->slave_cnt; ++slave) {
+        osal_uint16_t eepcfg = (osal_uint16_t)st[slave].regs[0] | ((osal_uint16_t)st[slave].regs[1] << 8u);
+        osal_uint16_t eepcsr = (osal_uint16_t)st[slave].regs[2] | ((osal_uint16_t)st[slave].regs[3] << 8u);
+
+        if ((wkc[slave] != 1u) || ((eepcfg & 0x0101u) != 0u) || ((eepcsr & 0x8000u) != 0u)) {
+            ec_log(10, "EEPROM_PREFETCH", "slave %2d: eeprom not available, eepcfg 0x%04X, eepcsr 0x%04X\n",
+                    slave, eepcfg, eepcsr);
+            st[slave].active = OSAL_FALSE;
+        } else {
+            st[slave].owned = OSAL_TRUE;
+            st[slave].step = ((eepcsr & 0x0040u) != 0u) ? 8u : 4u;
+        }
+    }
+
+    // read identity words first, the rest or the category headers of cached images afterwards
+    ret = ec_eeprom_prefetch_read(pec, st, wkc);
+
+    for (slave = 0u; slave < pec->slave_cnt; ++slave) {
+        if ((st[slave].owned == OSAL_TRUE) && (st[slave].failed == OSAL_FALSE)) {
+            st[slave].active = OSAL_TRUE;
+
+            if (ec_eeprom_cache_load(pec, slave) == OSAL_TRUE) {
+                // category headers are read back to detect rewritten eeproms
+                st[slave].cached = OSAL_TRUE;
+                st[slave].verify = OSAL_TRUE;
+            } else {
+                st[slave].end = LEC_MAX_EEPROM_IMAGE_SIZE;
+            }
+        }
+    }
+
+    int local_ret = ec_eeprom_prefetch_read(pec, st, wkc);
+    if (ret == EC_OK) {
+        ret = local_ret;
+    }
+
+    for (slave = 0u; slave < pec->slave_cnt; ++slave) {
+        if ((st[slave].cached == OSAL_TRUE) && (st[slave].failed == OSAL_TRUE)) {
+            // cached image could not be verified
+            pec->slaves[slave].eeprom.image_len = EC_EEPROM_CACHE_KEY_LEN;
+        } else if (st[slave].cached == OSAL_TRUE) {
+            hits++;
+        } else if ((st[slave].owned == OSAL_TRUE) && (st[slave].failed == OSAL_FALSE) && 
+                (pec->slaves[slave].eeprom.image_len > EC_EEPROM_CACHE_KEY_LEN)) {
+            ec_eeprom_cache_store(pec, slave);
+        } else {}
+    }
+
+    // give eeprom back to PDI
+    for (slave = 0u; slave < pec->slave_cnt; ++slave) {
+        st[slave].active = st[slave].owned;
+        (void)memset(&st[slave].regs[0], 0, sizeof(st[slave].regs));
+        st[slave].regs[0] = 1u;
+        bytes += pec->slaves[slave].eeprom.image_len;
+    }
+
+    (void)ec_eeprom_prefetch_batch(pec, st, OSAL_FALSE, EC_CMD_FPWR, EC_REG_EEPCFG, 1u, wkc);
+
+    for (slave = 0u; slave < pec->slave_cnt; ++slave) {
+        if ((st[slave].owned == OSAL_TRUE) && (wkc[slave] != 1u)) {
+            (void)ec_eeprom_to_pdi(pec, slave);
+        }
+    }
+
+    ec_log(10, "EEPROM_PREFETCH", "read %" PRIu64 " bytes of %d slaves (%d cached) in %" PRIu64 " ms\n",
+            (osal_uint64_t)bytes, pec->slave_cnt, hits, (osal_timer_gettime_nsec() - start) / 1000000u);
+
+    return ret;
+}
+
 // read out whole eeprom and categories
 void ec_eeprom_dump(ec_t *pec, osal_uint16_t slave) {
     assert(pec != NULL);
@@ -0,0 +1,169 @@
+/**
+ * \file histogram.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief latency histograms
+ *
+ */
+
+/*
+ * This file is part of libethercat.
+ *
+ * libethercat is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * libethercat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with libethercat (LICENSE.LGPL-V3); if not, write 
+ * to the Free Software Foundation, Inc., 51 Franklin Street, Fifth 
+ * Floor, Boston, MA  02110-1301, USA.
+ * 
+ * Please note that the use of the EtherCAT technology, the EtherCAT 
+ * brand name and the EtherCAT logo is only permitted if the property 
+ * rights of Beckhoff Automation GmbH are observed. For further 
+ * information please contact Beckhoff Automation GmbH & Co. KG, 
+ * Hülshorstweg 20, D-33415 Verl, Germany (www.beckhoff.com) or the 
+ * EtherCAT Technology Group, Ostendstraße 196, D-90482 Nuremberg, 
+ * Germany (ETG, www.ethercat.org).
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libethercat/config.h>
+#endif
+
+#include "libethercat/histogram.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+//! Bucket of value.
+static osal_size_t ec_histogram_bucket(osal_uint64_t value) {
+    osal_size_t ret;
+
+    if (value < (2u << EC_HISTOGRAM_SUB_BITS)) {
+        ret = (osal_size_t)value;
+    } else {
+        osal_uint32_t shift = (osal_uint32_t)(63 - __builtin_clzll(value)) - EC_HISTOGRAM_SUB_BITS;
+        ret = ((osal_size_t)shift << EC_HISTOGRAM_SUB_BITS) + (osal_size_t)(value >> shift);
+    }
+
+    return ret;
+}
+
+//! Largest value of bucket.
+static osal_uint64_t ec_histogram_bucket_limit(osal_size_t bucket) {
+    osal_uint64_t ret;
+
+    if (bucket < (2u << EC_HISTOGRAM_SUB_BITS)) {
+        ret = (osal_uint64_t)bucket;
+    } else {
+        osal_uint32_t shift = (osal_uint32_t)(bucket >> EC_HISTOGRAM_SUB_BITS) - 1u;
+        osal_uint64_t mantissa = (osal_uint64_t)(bucket & ((1u << EC_HISTOGRAM_SUB_BITS) - 1u)) + 
+            (1u << EC_HISTOGRAM_SUB_BITS) + 1u;
+        ret = (shift == 60u) && (mantissa == (2u << EC_HISTOGRAM_SUB_BITS)) ? 
+            UINT64_MAX : ((mantissa << shift) - 1u);
+    }
+
+    return ret;
+}
+
+// clear histogram
+void ec_histogram_reset(ec_histogram_t *h) {
+    assert(h != NULL);
+
+    ec_histogram_t snap;
+    ec_histogram_snapshot(h, &snap, 1);
+}
+
+// record one value
+void ec_histogram_add(ec_histogram_t *h, osal_uint64_t value) {
+    assert(h != NULL);
+
+    (void)__atomic_fetch_add(&h->buckets[ec_histogram_bucket(value)], 1u, __ATOMIC_RELAXED);
+    (void)__atomic_fetch_add(&h->sum, value, __ATOMIC_RELAXED);
+    (void)__atomic_fetch_add(&h->count, 1u, __ATOMIC_RELAXED);
+
+    osal_uint64_t old = __atomic_load_n(&h->min, __ATOMIC_RELAXED);
+    while ((value < old) && (__atomic_compare_exchange_n(&h->min, &old, value, 
+                    OSAL_TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED) == OSAL_FALSE)) {}
+
+    old = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+    while ((value > old) && (__atomic_compare_exchange_n(&h->max, &old, value, 
+                    OSAL_TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED) == OSAL_FALSE)) {}
+}
+
+// copy histogram and optionally clear it
+void ec_histogram_snapshot(ec_histogram_t *h, ec_histogram_t *snap, int reset) {
+    assert(h != NULL);
+    assert(snap != NULL);
+
+    if (reset != 0) {
+        snap->count = __atomic_exchange_n(&h->count, 0u, __ATOMIC_RELAXED);
+        snap->sum = __atomic_exchange_n(&h->sum, 0u, __ATOMIC_RELAXED);
+        snap->min = __atomic_exchange_n(&h->min, UINT64_MAX, __ATOMIC_RELAXED);
+        snap->max = __atomic_exchange_n(&h->max, 0u, __ATOMIC_RELAXED);
+        for (osal_size_t i = 0u; i < EC_HISTOGRAM_BUCKETS; ++i) {
+            snap->buckets[i] = __atomic_exchange_n(&h->buckets[i], 0u, __ATOMIC_RELAXED);
+        }
+    } else {
+        snap->count = __atomic_load_n(&h->count, __ATOMIC_RELAXED);
+        snap->sum = __atomic_load_n(&h->sum, __ATOMIC_RELAXED);
+        snap->min = __atomic_load_n(&h->min, __ATOMIC_RELAXED);
+        snap->max = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+        for (osal_size_t i = 0u; i < EC_HISTOGRAM_BUCKETS; ++i) {
+            snap->buckets[i] = __atomic_load_n(&h->buckets[i], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+// get value at percentile
+osal_uint64_t ec_histogram_percentile(const ec_histogram_t *h, double percent) {
+    assert(h != NULL);
+
+    osal_uint64_t ret = 0u;
+    osal_uint64_t total = 0u;
+
+    for (osal_size_t i = 0u; i < EC_HISTOGRAM_BUCKETS; ++i) {
+        total += h->buckets[i];
+    }
+
+    if (total > 0u) {
+        // rank of wanted value, at least the first one
+        osal_uint64_t rank = (osal_uint64_t)(((percent * (double)total) / 100.) + 0.5);
+        osal_uint64_t seen = 0u;
+
+        rank = (rank == 0u) ? 1u : ((rank > total) ? total : rank);
+
+        for (osal_size_t i = 0u; i < EC_HISTOGRAM_BUCKETS; ++i) {
+            seen += h->buckets[i];
+            if (seen >= rank) {
+                ret = ec_histogram_bucket_limit(i);
+                break;
+            }
+        }
+
+        if (ret > h->max) {
+            ret = h->max;
+        }
+    }
+
+    return ret;
+}
+
+// get mean value
+osal_uint64_t ec_histogram_mean(const ec_histogram_t *h) {
+    assert(h != NULL);
+
+    return (h->count > 0u) ? (h->sum / h->count) : 0u;
+}
+
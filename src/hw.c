@@ -58,6 +58,10 @@
 #include <string.h>
 #include <stdlib.h>
 
+#if LIBETHERCAT_BUILD_POSIX == 1
+#include <poll.h>
+#endif
+
 #ifdef LIBETHERCAT_HAVE_ARPA_INET_H
 #include <arpa/inet.h>
 #endif
@@ -95,9 +99,23 @@ int hw_open(struct hw_common *phw, struct ec *pec) {
     phw->pec = pec;
     phw->frame_idx = 0;
     phw->bytes_last_sent = 0;
+    phw->tx_frame = NULL;
+    phw->tx_frame_dg_prev = NULL;
+    phw->tx_frame_in_place = OSAL_FALSE;
+    phw->link_speed_mbps = 100u;
+    phw->tx_low_budget_ns = 0u;
+    phw->tx_low_budget_warned = OSAL_FALSE;
+    phw->tx_cycle_wire_bytes = 0u;
+    phw->tx_window = OSAL_TRUE;
+    phw->tx_window_guard_ns = LEC_HW_TX_WINDOW_GUARD_NS;
+    phw->tx_window_cycle_ns = 0u;
+    phw->rx_polling = OSAL_FALSE;
+    phw->frame_rtt_ns = 0u;
+    phw->capture.running = 0;
+    phw->capture.file = NULL;
 
-    (void)pool_open(&phw->tx_high, 0, NULL);
-    (void)pool_open(&phw->tx_low, 0, NULL);
+    (void)pool_mpsc_open(&phw->tx_high);
+    (void)pool_mpsc_open(&phw->tx_low);
 
     osal_mutex_attr_t hw_lock_attr = OSAL_MUTEX_ATTR__PROTOCOL__INHERIT;
     osal_mutex_init(&phw->hw_lock, &hw_lock_attr);
@@ -113,13 +131,15 @@ int hw_open(struct hw_common *phw, struct ec *pec) {
 int hw_close(struct hw_common *phw) {
     assert(phw != NULL);
 
+    ec_capture_stop(phw);
+
     if (phw->close) {
         phw->close(phw);
     }
 
     osal_mutex_lock(&phw->hw_lock);
-    (void)pool_close(&phw->tx_high);
-    (void)pool_close(&phw->tx_low);
+    (void)pool_mpsc_close(&phw->tx_high);
+    (void)pool_mpsc_close(&phw->tx_low);
 
     osal_mutex_unlock(&phw->hw_lock);
     osal_mutex_destroy(&phw->hw_lock);
@@ -127,13 +147,12 @@ int hw_close(struct hw_common *phw) {
     return 0;
 }
 
-//! Enqueue frame to send queue.
+//! Check if datagram index is still in use by a sent datagram.
 /*!
  * \param[in]   phw         Pointer to hw handle.
- * \param[in]   p_entry     Entry to be enqueued.
- * \parma[in]   pool_type   Enqueue to high prio or low prio queue.
+ * \param[in]   p_entry     Entry to be sent.
  */
-void hw_enqueue(struct hw_common *phw, pool_entry_t *p_entry, pooltype_t pool_type) {
+static void hw_check_lost(struct hw_common *phw, pool_entry_t *p_entry) {
     struct ec *pec = phw->pec;
     if (phw->tx_send[p_entry->p_idx->idx] != NULL) {
         pool_entry_t *p_entry_sent = phw->tx_send[p_entry->p_idx->idx];
@@ -151,8 +170,38 @@ void hw_enqueue(struct hw_common *phw, pool_entry_t *p_entry, pooltype_t pool_ty
                 "Sending next datagram with idx %d which did not return in last cycle (already on wire since %" PRIu64 " ns with packet idx %" PRIu64 "!)\n", 
                 pec->stats.lost_datagrams, p_entry->p_idx->idx, now - sent, p_entry->send_idx);
     }
+}
 
-    pool_put(pool_type == POOL_HIGH ? &phw->tx_high : &phw->tx_low, p_entry);
+//! Enqueue frame to send queue.
+/*!
+ * \param[in]   phw         Pointer to hw handle.
+ * \param[in]   p_entry     Entry to be enqueued.
+ * \parma[in]   pool_type   Enqueue to high prio or low prio queue.
+ */
+void hw_enqueue(struct hw_common *phw, pool_entry_t *p_entry, pooltype_t pool_type) {
+    hw_check_lost(phw, p_entry);
+
+    pool_mpsc_put(pool_type == POOL_HIGH ? &phw->tx_high : &phw->tx_low, p_entry);
+}
+
+//! Remove frame from send queue if it was not sent yet.
+/*!
+ * \param[in]   phw         Pointer to hw handle.
+ * \param[in]   p_entry     Entry to be removed.
+ * \param[in]   pool_type   Remove from high prio or low prio queue.
+ *
+ * \return EC_OK or error code
+ */
+int hw_dequeue(struct hw_common *phw, pool_entry_t *p_entry, pooltype_t pool_type) {
+    assert(phw != NULL);
+    assert(p_entry != NULL);
+
+    // hw_lock serializes all consumers of the send queues
+    osal_mutex_lock(&phw->hw_lock);
+    int ret = pool_mpsc_remove(pool_type == POOL_HIGH ? &phw->tx_high : &phw->tx_low, p_entry);
+    osal_mutex_unlock(&phw->hw_lock);
+
+    return ret;
 }
 
 //! Process a received EtherCAT frame
@@ -168,6 +217,8 @@ osal_bool_t hw_process_rx_frame(struct hw_common *phw, ec_frame_t *pframe) {
     ec_t *pec = phw->pec;
     osal_bool_t success = OSAL_FALSE;
 
+    ec_capture_frame(&phw->capture, pframe, EC_CAPTURE_DIR_RX);
+
 #ifdef LOSS_SIMULATION
     static int miss = 0;
     // Find the random number in the range [min, max]
@@ -184,10 +235,42 @@ osal_bool_t hw_process_rx_frame(struct hw_common *phw, ec_frame_t *pframe) {
         ec_log(1, "HW_RX", "received non-ethercat frame! (type 0x%X)\n", pframe->type);
     } else {
         ec_datagram_t *d = ec_datagram_first(pframe); 
+        osal_bool_t rtt_sampled = OSAL_FALSE;
+        osal_uint64_t now = osal_timer_gettime_nsec();
+        ec_trace_begin(EC_TRACE_FRAME_RX, pframe->len);
         while ((osal_uint8_t *) d < (osal_uint8_t *) ec_frame_end(pframe)) {
             pool_entry_t *entry = phw->tx_send[d->idx];
             phw->tx_send[d->idx] = NULL;
 
+            osal_uint64_t rtt = 0u;
+            if (entry != NULL) {
+                osal_uint64_t sent = ((osal_uint64_t)entry->send_timestamp.sec * NSEC_PER_SEC) + 
+                    (osal_uint64_t)entry->send_timestamp.nsec;
+                rtt = now - sent;
+                ec_histogram_add(&pec->stats.round_trip, rtt);
+
+                if (entry->window_cycle_ns != 0u) {
+                    // piggybacked it would have come back with the frames of the next cycle
+                    osal_uint64_t piggyback = entry->window_cycle_ns + phw->frame_rtt_ns;
+                    if (piggyback > now) {
+                        (void)__atomic_fetch_add(&pec->stats.tx_window_saved_ns, piggyback - now, __ATOMIC_RELAXED);
+                    } else {
+                        (void)__atomic_fetch_add(&pec->stats.tx_window_late, 1u, __ATOMIC_RELAXED);
+                    }
+                }
+            }
+
+            if ((entry != NULL) && (rtt_sampled == OSAL_FALSE)) {
+                // rise immediately, decay slowly, so idle time is never overestimated
+                if (rtt > phw->frame_rtt_ns) {
+                    phw->frame_rtt_ns = rtt;
+                } else {
+                    phw->frame_rtt_ns -= (phw->frame_rtt_ns - rtt) / 8u;
+                }
+
+                rtt_sampled = OSAL_TRUE;
+            }
+
             if (!entry) {
                 ec_log(1, "HW_RX", 
                         "Received idx %d, but it is not marked as sent.\n"
@@ -198,19 +281,362 @@ osal_bool_t hw_process_rx_frame(struct hw_common *phw, ec_frame_t *pframe) {
                 success = OSAL_TRUE;
                 
                 if ((entry->user_cb) != NULL) {
+                    ec_trace_begin(EC_TRACE_DATAGRAM_CB, d->idx);
                     (*entry->user_cb)(phw->pec, entry, d);
+                    ec_trace_end(EC_TRACE_DATAGRAM_CB, d->idx);
                 }
             }
 
             d = ec_datagram_next(d);
         }
+
+        ec_trace_end(EC_TRACE_FRAME_RX, pframe->len);
     }
 
     return success;
 }
 
+#if LIBETHERCAT_BUILD_POSIX == 1
+//! Check if a receive thread cpu mask selects an isolated cpu.
+/*!
+ * \param[in]   cpumask     CPU mask of receive thread.
+ *
+ * \return OSAL_TRUE if cpumask selects exactly one cpu which is listed in 
+ * /sys/devices/system/cpu/isolated.
+ */
+osal_bool_t hw_device_cpu_isolated(int cpumask) {
+    osal_bool_t ret = OSAL_FALSE;
+
+    if ((cpumask > 0) && ((cpumask & (cpumask - 1)) == 0)) {
+        int cpu = __builtin_ctz((unsigned)cpumask);
+        osal_char_t buffer[256];
+
+        FILE *fp = fopen("/sys/devices/system/cpu/isolated", "r");
+        if (fp != NULL) {
+            osal_char_t *pos = fgets(buffer, sizeof(buffer), fp);
+            (void)fclose(fp);
+
+            // parse cpu list, e.g. "2-3,5"
+            while ((ret == OSAL_FALSE) && (pos != NULL) && (*pos >= '0') && (*pos <= '9')) {
+                int first = (int)strtol(pos, &pos, 10);
+                int last = first;
+                if (*pos == '-') {
+                    last = (int)strtol(&pos[1], &pos, 10);
+                }
+
+                if ((cpu >= first) && (cpu <= last)) {
+                    ret = OSAL_TRUE;
+                } else if (*pos == ',') {
+                    pos++;
+                } else {
+                    break;
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+//! Split device name and device options.
+/*!
+ * \param[in]   devname         Device name with options.
+ * \param[out]  name            Buffer for plain device name.
+ * \param[in]   name_len        Size of \p name.
+ * \param[out]  polling_mode    Set to OSAL_TRUE if \a polling was given.
+ * \param[out]  rx_timeout_ns   Receive timeout if \a rx_timeout_nsec was given.
+ */
+void hw_device_parse_options(const osal_char_t *devname, osal_char_t *name, osal_size_t name_len, 
+        osal_bool_t *polling_mode, osal_uint64_t *rx_timeout_ns) 
+{
+    assert(devname != NULL);
+    assert(name != NULL);
+    assert(name_len > 0u);
+    assert(polling_mode != NULL);
+    assert(rx_timeout_ns != NULL);
+
+    const osal_char_t *opt = strchr(devname, ':');
+    osal_size_t len = (opt != NULL) ? (osal_size_t)(opt - devname) : strlen(devname);
+    len = LEC_MIN(len, name_len - 1u);
+
+    (void)memcpy(name, devname, len);
+    name[len] = '\0';
+
+    while (opt != NULL) {
+        opt = &opt[1];
+        const osal_char_t *next = strchr(opt, ':');
+        osal_size_t opt_len = (next != NULL) ? (osal_size_t)(next - opt) : strlen(opt);
+
+        if ((opt_len == 7u) && (strncmp(opt, "polling", 7) == 0)) {
+            *polling_mode = OSAL_TRUE;
+        } else if (strncmp(opt, "rx_timeout_nsec=", 16) == 0) {
+            *rx_timeout_ns = strtoull(&opt[16], NULL, 10);
+        } else {}
+
+        opt = next;
+    }
+}
+
+//! Receive replies on the caller's thread.
+/*!
+ * \param[in]   phw             Pointer to hw handle.
+ * \param[in]   fd              File descriptor to poll for incoming frames
+ *                              or -1 if device cannot be polled.
+ * \param[in]   expected        Number of frames sent.
+ * \param[in]   rx_timeout_ns   Maximum time to wait for all replies.
+ * \param[in,out] predict       Receive wait predictor, updated on reception.
+ * \param[in]   rx_once         Non-blocking receive function of device.
+ *
+ * \return Number of received replies.
+ */
+osal_size_t hw_device_poll_rx(struct hw_common *phw, int fd, osal_size_t expected, 
+        osal_uint64_t rx_timeout_ns, hw_rx_predict_t *predict, hw_device_rx_once_t rx_once) 
+{
+    assert(phw != NULL);
+    assert(predict != NULL);
+    assert(rx_once != NULL);
+
+    osal_size_t received = 0u;
+    osal_uint64_t start = osal_timer_gettime_nsec();
+    osal_uint64_t now = start;
+    osal_uint64_t deadline = start + rx_timeout_ns;
+    osal_uint64_t first_rx = 0u;
+
+    // do not run into the next cycle
+    if (phw->pec->main_cycle_interval > 0) {
+        osal_uint64_t cycle_end = ((osal_uint64_t)phw->next_cylce_start.sec * 1000000000u) + 
+            (osal_uint64_t)phw->next_cylce_start.nsec;
+        if ((cycle_end > start) && (cycle_end < deadline)) {
+            deadline = cycle_end;
+        }
+    }
+
+    // sleep until shortly before the first reply is expected
+    osal_uint64_t guard = (2u * predict->rttvar_ns) + predict->oversleep_ns;
+    if ((predict->srtt_ns > guard) && ((predict->srtt_ns - guard) >= LEC_HW_RX_MIN_SLEEP_NS)) {
+        osal_uint64_t sleep_ns = LEC_MIN(predict->srtt_ns - guard, deadline - start);
+        (void)osal_sleep(sleep_ns);
+
+        now = osal_timer_gettime_nsec();
+        osal_uint64_t over = ((now - start) > sleep_ns) ? ((now - start) - sleep_ns) : 0u;
+        predict->oversleep_ns = ((predict->oversleep_ns * 7u) + over) / 8u;
+    } else {
+        // forget single late wake-ups, otherwise we would never sleep again
+        predict->oversleep_ns -= predict->oversleep_ns / 8u;
+    }
+
+    // replies later than predicted are waited for in poll
+    osal_uint64_t spin_end = start + predict->srtt_ns + (4u * predict->rttvar_ns) + LEC_RX_SPIN_MAX_NS;
+
+    while (received < expected) {
+        osal_size_t cnt = rx_once(phw);
+        if ((cnt > 0u) && (received == 0u)) {
+            first_rx = osal_timer_gettime_nsec();
+        }
+
+        received += cnt;
+        if (received >= expected) {
+            break;
+        }
+
+        now = osal_timer_gettime_nsec();
+        if (now >= deadline) {
+            break;
+        }
+
+        if ((fd >= 0) && (now >= spin_end) && ((deadline - now) >= 1000000u)) {
+            // poll has ms resolution, sleep only while it cannot overshoot
+            struct pollfd pollset;
+            pollset.fd = fd;
+            pollset.events = POLLIN;
+            pollset.revents = 0;
+            (void)poll(&pollset, 1, (int)((deadline - now) / 1000000u));
+        }
+    }
+
+    if (first_rx != 0u) {
+        // smoothed arrival time and mean deviation as in RFC 6298
+        osal_uint64_t sample = first_rx - start;
+        if (predict->srtt_ns == 0u) {
+            predict->srtt_ns = sample;
+            predict->rttvar_ns = sample / 2u;
+        } else {
+            osal_uint64_t err = (sample > predict->srtt_ns) ? 
+                (sample - predict->srtt_ns) : (predict->srtt_ns - sample);
+            predict->rttvar_ns = ((predict->rttvar_ns * 3u) + err) / 4u;
+            predict->srtt_ns = ((predict->srtt_ns * 7u) + sample) / 8u;
+        }
+    }
+
+    if (received >= expected) {
+        phw->last_rx_duration_ns = osal_timer_gettime_nsec() - start;
+        ec_histogram_add(&phw->pec->stats.rx_duration, phw->last_rx_duration_ns);
+    }
+
+    return received;
+}
+#endif
+
+//! Process a batch of received EtherCAT frames
+/*!
+ * \param[in]   phw     Pointer to hw handle.
+ * \param[in]   pframes Array of pointers to received EtherCAT frames.
+ * \param[in]   cnt     Number of frames in pframes.
+ *
+ * \return Number of successfully processed frames.
+ */
+osal_size_t hw_process_rx_frames(struct hw_common *phw, ec_frame_t **pframes, osal_size_t cnt) {
+    assert(phw != NULL);
+    assert((pframes != NULL) || (cnt == 0u));
+
+    osal_size_t processed = 0u;
+
+    for (osal_size_t i = 0u; i < cnt; ++i) {
+        if (hw_process_rx_frame(phw, pframes[i]) == OSAL_TRUE) {
+            processed++;
+        }
+    }
+
+    return processed;
+}
+
+//! Bytes a frame occupies on the wire.
+/*!
+ * \param[in] frame_len     Frame length without FCS.
+ *
+ * \return Frame length with padding, FCS, preamble and inter frame gap.
+ */
+static osal_size_t hw_wire_bytes(osal_size_t frame_len) {
+    return ((frame_len < 60u) ? 60u : frame_len) + 4u + 8u + 12u;
+}
+
+//! Send frame currently filled.
+/*!
+ * \param[in] phw           Hardware handle.
+ * \param[in] pool_type     Type of pool the frame was filled from.
+ */
+static void hw_tx_frame_flush(struct hw_common *phw, pooltype_t pool_type) {
+    if (phw->tx_frame != NULL) {
+        phw->tx_cycle_wire_bytes += hw_wire_bytes(phw->tx_frame->len);
+        ec_trace_instant(EC_TRACE_FRAME_TX, phw->tx_frame->len);
+        ec_capture_frame(&phw->capture, phw->tx_frame, EC_CAPTURE_DIR_TX);
+
+        // round trip time starts when the frame leaves, not when it was filled
+        osal_timer_t now;
+        (void)osal_timer_gettime(&now);
+        ec_datagram_t *d = ec_datagram_first(phw->tx_frame);
+        while ((osal_uint8_t *)d < (osal_uint8_t *)ec_frame_end(phw->tx_frame)) {
+            if (phw->tx_send[d->idx] != NULL) {
+                phw->tx_send[d->idx]->send_timestamp = now;
+            }
+
+            d = ec_datagram_next(d);
+        }
+
+        (void)phw->send(phw, phw->tx_frame, pool_type);
+        phw->tx_frame = NULL;
+        phw->tx_frame_dg_prev = NULL;
+        phw->frame_idx++;
+    }
+}
+
+//! Append datagram space to frame currently filled.
+/*!
+ * Sends the current frame if there is not enough space left and gets a new
+ * one from the device. The datagram is marked as sent.
+ *
+ * \param[in]   phw         Hardware handle.
+ * \param[in]   p_entry     Pool entry the datagram belongs to.
+ * \param[in]   len         Complete datagram length (header, payload and wkc).
+ * \param[in]   pool_type   Type of pool the frame is filled from.
+ * \param[out]  ppdg        Returns pointer to datagram space in frame.
+ *
+ * \return EC_OK or error code
+ */
+static int hw_tx_frame_append(struct hw_common *phw, pool_entry_t *p_entry, 
+        osal_size_t len, pooltype_t pool_type, ec_datagram_t **ppdg) {
+    int ret = EC_OK;
+
+    // Before adding the datagram into the frame buffer, we must check whether there is enough space.
+    // If there is no space left, we have to send the frame.
+    if ((phw->tx_frame != NULL) && ((phw->tx_frame->len + len) > phw->mtu_size)) {
+        hw_tx_frame_flush(phw, pool_type);
+    }
+
+    // Get the framebuffer if nothing has been allocated yet.
+    if (phw->tx_frame == NULL) {
+        if (phw->get_tx_buffer(phw, &phw->tx_frame) != EC_OK) {
+            ec_t *pec = phw->pec;
+            ec_log(1, "HW_TX_POOL", "no more send buffers available!\n");
+            phw->tx_frame = NULL;
+            ret = EC_ERROR_UNAVAILABLE;
+        }
+    }
+
+    if (ret == EC_OK) {
+        if (phw->tx_frame_dg_prev != NULL) {
+            ec_datagram_mark_next(phw->tx_frame_dg_prev);
+        }
+
+        // cppcheck-suppress misra-c2012-11.3
+        *ppdg = (ec_datagram_t *)ec_frame_end(phw->tx_frame);
+        phw->tx_frame->len += len;
+        phw->tx_frame_dg_prev = *ppdg;
+
+        // store as sent
+        phw->tx_send[p_entry->p_idx->idx] = p_entry;
+            
+        p_entry->send_idx = phw->frame_idx;
+        p_entry->window_cycle_ns = phw->tx_window_cycle_ns;
+    }
+
+    return ret;
+}
+
+//! Append queued datagram to frame currently filled.
+/*!
+ * \param[in] phw           Hardware handle.
+ * \param[in] p_entry       Dequeued pool entry.
+ * \param[in] pool_type     Type of pool the frame is filled from.
+ *
+ * \return EC_OK or error code
+ */
+static int hw_tx_pool_entry(struct hw_common *phw, pool_entry_t *p_entry, pooltype_t pool_type) {
+    // cppcheck-suppress misra-c2012-11.3
+    ec_datagram_t *p_entry_dg = (ec_datagram_t *)p_entry->data;
+    ec_datagram_t *pdg = NULL;
+    osal_size_t len = ec_datagram_length(p_entry_dg);
+
+    int ret = hw_tx_frame_append(phw, p_entry, len, pool_type, &pdg);
+    if (ret == EC_OK) {
+        p_entry_dg->next = 0;
+        (void)memcpy(pdg, p_entry_dg, len);
+    }
+
+    return ret;
+}
+
+//! Append all queued datagrams of pool, the last frame is left open.
+/*!
+ * \param[in] phw           Hardware handle.
+ * \param[in] pool_type     Type of pool to sent.
+ */
+static void hw_tx_pool_fill(struct hw_common *phw, pooltype_t pool_type) {
+    pool_mpsc_t *pool = pool_type == POOL_HIGH ? &phw->tx_high : &phw->tx_low;
+    pool_entry_t *p_entry = NULL;
+
+    while (pool_mpsc_get(pool, &p_entry) == EC_OK) {
+        if (hw_tx_pool_entry(phw, p_entry, pool_type) != EC_OK) {
+            break;
+        }
+    }
+}
+
 //! Start sending queued ethrecat datagrams from specified pool.
 /*!
+ * Queued datagrams are appended to a frame which may already have been 
+ * opened, the last frame is always sent.
+ *
  * \param[in] phw           Hardware handle.
  * \param[in] pool_type     Type of pool to sent.
  * \retval OSAL_TRUE when at least one frame was sent
@@ -219,92 +645,344 @@ osal_bool_t hw_process_rx_frame(struct hw_common *phw, ec_frame_t *pframe) {
 osal_bool_t hw_tx_pool(struct hw_common *phw, pooltype_t pool_type) {
     assert(phw != NULL);
     
-    osal_bool_t sent = OSAL_FALSE;
-    ec_frame_t *pframe = NULL;
-    pool_t *pool = pool_type == POOL_HIGH ? &phw->tx_high : &phw->tx_low;
+    osal_uint64_t frame_idx_start = phw->frame_idx;
 
-    ec_datagram_t *pdg = NULL;
-    ec_datagram_t *pdg_prev = NULL;
+    hw_tx_pool_fill(phw, pool_type);
+
+    // We also have to send the frame if we have no further pending datagrams.
+    hw_tx_frame_flush(phw, pool_type);
 
+    return (phw->frame_idx != frame_idx_start) ? OSAL_TRUE : OSAL_FALSE;
+}
+
+//! Bytes which can be sent within given wire time.
+/*!
+ * \param[in] phw           Hardware handle.
+ * \param[in] time_ns       Wire time [ns].
+ *
+ * \return Number of bytes at current link speed.
+ */
+static osal_size_t hw_wire_budget(struct hw_common *phw, osal_uint64_t time_ns) {
+    return (osal_size_t)((time_ns * phw->link_speed_mbps) / 8000u);
+}
+
+//! Fill spare room of frames with low prio datagrams.
+/*!
+ * Takes datagrams from the low prio queue as long as all frames of the
+ * current cycle stay within the wire byte budget. The frame currently 
+ * filled is left open.
+ *
+ * \param[in] phw           Hardware handle.
+ * \param[in] budget        Wire bytes all frames of the cycle may occupy.
+ * \param[in] min_cnt       Datagrams taken even if exceeding the budget.
+ * \param[in] pool_type     Type of pool the frame is filled for.
+ *
+ * \return Number of low prio datagrams appended.
+ */
+static osal_size_t hw_tx_piggyback(struct hw_common *phw, osal_size_t budget, osal_size_t min_cnt, pooltype_t pool_type) {
+    osal_size_t cnt = 0u;
     pool_entry_t *p_entry = NULL;
-    ec_datagram_t *p_entry_dg = NULL;
-
-    // send frames
-    osal_size_t len;
-    do {
-        if (pool_get(pool, &p_entry, NULL) == EC_OK) {
-            // cppcheck-suppress misra-c2012-11.3
-            p_entry_dg = (ec_datagram_t *)p_entry->data;
-            
-            len = ec_datagram_length(p_entry_dg);
-        } else { 
-            // This is the signal that we have no pending datagrams
-            len = 0u;
+
+    while (pool_mpsc_peek(&phw->tx_low, &p_entry) == EC_OK) {
+        // cppcheck-suppress misra-c2012-11.3
+        osal_size_t len = ec_datagram_length((ec_datagram_t *)p_entry->data);
+        osal_size_t open_len = (phw->tx_frame != NULL) ? phw->tx_frame->len : 0u;
+        osal_size_t wire = phw->tx_cycle_wire_bytes;
+
+        if ((open_len > 0u) && ((open_len + len) <= phw->mtu_size)) {
+            wire += hw_wire_bytes(open_len + len);
+        } else {
+            wire += ((open_len > 0u) ? hw_wire_bytes(open_len) : 0u) + 
+                hw_wire_bytes(ec_frame_hdr_length + len);
         }
 
-        // Before copying the datagram into the frame buffer, we must check whether there is enough space.
-        // If there is no space left, we have to send the frame.
-        // We also have to send the frame if we have no further pending datagrams.
-        if (pframe != NULL 
-                && ((len == 0u) || ((pframe->len + len) > phw->mtu_size))) {
-            (void)phw->send(phw, pframe, pool_type);
-            pframe = NULL;
-            pdg_prev = NULL;
-            phw->frame_idx++;
-            sent = OSAL_TRUE;
+        if (((wire > budget) && (cnt >= min_cnt)) || (pool_mpsc_get(&phw->tx_low, &p_entry) != EC_OK)) {
+            break;
         }
 
-        if (len != 0u) {
-            // Get the framebuffer if nothing has been allocated yet.
-            if (pframe == NULL) {
-                if (phw->get_tx_buffer(phw, &pframe) != EC_OK) {
-                    ec_t *pec = phw->pec;
-                    ec_log(1, "HW_TX_POOL", "no more send buffers available!\n");
-                    break;
-                }
-                pdg = ec_datagram_first(pframe);
-            }
+        if (hw_tx_pool_entry(phw, p_entry, pool_type) != EC_OK) {
+            break;
+        }
 
-//            pool_remove(pool, p_entry);
-            if (pdg_prev != NULL) {
-                ec_datagram_mark_next(pdg_prev);
-            }
-            p_entry_dg->next = 0;
-            (void)memcpy(pdg, p_entry_dg, ec_datagram_length(p_entry_dg));
-            pframe->len += len;
-            pdg_prev = pdg;
+        cnt++;
+    }
+
+    return cnt;
+}
+
+//! Fill cyclic frames with low prio datagrams within the cycle budget.
+/*!
+ * At least one datagram is taken per cycle, so low prio datagrams never 
+ * starve if the cyclic frames alone exceed the budget. This is logged 
+ * once per configured budget.
+ *
+ * \param[in] phw           Hardware handle.
+ */
+static void hw_tx_piggyback_cycle(struct hw_common *phw) {
+    osal_size_t budget = hw_wire_budget(phw, phw->tx_low_budget_ns);
+    osal_size_t cyclic = phw->tx_cycle_wire_bytes + 
+        ((phw->tx_frame != NULL) ? hw_wire_bytes(phw->tx_frame->len) : 0u);
+
+    if ((cyclic > budget) && (phw->tx_low_budget_warned == OSAL_FALSE)) {
+        struct ec *pec = phw->pec;
+        ec_log(5, "HW_TX", "cyclic frames need %" PRIu64 " bytes on wire, more than the low prio "
+                "budget of %" PRIu64 " bytes, sending one low prio datagram per cycle\n", 
+                (osal_uint64_t)cyclic, (osal_uint64_t)budget);
+        phw->tx_low_budget_warned = OSAL_TRUE;
+    }
+
+    (void)hw_tx_piggyback(phw, budget, 1u, POOL_HIGH);
+}
+
+//! Start a new cycle on high prio queue and take hw lock.
+/*!
+ * \param phw hardware handle
+ */
+static void hw_tx_frame_begin(struct hw_common *phw) {
+    osal_mutex_lock(&phw->hw_lock);
+    phw->tx_frame_start_ns = osal_timer_gettime_nsec();
+    phw->tx_frame_idx_open = phw->frame_idx;
+    phw->tx_cycle_wire_bytes = 0u;
+    osal_timer_init(&phw->next_cylce_start, phw->pec->main_cycle_interval);
+}
+
+//! Send high prio queue and release hw lock.
+/*!
+ * \param phw hardware handle
+ * \retval OSAL_TRUE when at least one frame was sent
+ * \retval OSAL_FALSE when no frame was sent
+ */
+static osal_bool_t hw_tx_frame_end(struct hw_common *phw) {
+    hw_tx_pool_fill(phw, POOL_HIGH);
+    if (phw->tx_low_budget_ns > 0u) {
+        hw_tx_piggyback_cycle(phw);
+    }
+    hw_tx_frame_flush(phw, POOL_HIGH);
+
+    osal_bool_t sent = (phw->frame_idx != phw->tx_frame_idx_open) ? OSAL_TRUE : OSAL_FALSE;
+    phw->last_tx_duration_ns = osal_timer_gettime_nsec() - phw->tx_frame_start_ns;
+    ec_histogram_add(&phw->pec->stats.tx_duration, phw->last_tx_duration_ns);
+    
+    osal_mutex_unlock(&phw->hw_lock);
+
+    return sent;
+}
+
+//! Open a frame to build cyclic datagrams in place.
+/*!
+ * \param phw hardware handle
+ * \return 0 or error code
+ */
+int hw_tx_frame_open(struct hw_common *phw) {
+    assert(phw != NULL);
+
+    hw_tx_frame_begin(phw);
+    phw->tx_frame_in_place = OSAL_TRUE;
+
+    return EC_OK;
+}
+
+//! Reserve datagram space in frame opened by \link hw_tx_frame_open \endlink.
+/*!
+ * \param[in]   phw             Pointer to hw handle.
+ * \param[in]   p_entry         Pool entry with assigned index.
+ * \param[in]   payload_len     Datagram payload length.
+ * \param[out]  ppdg            Returns pointer to datagram in frame.
+ *
+ * \return EC_OK or error code
+ */
+int hw_tx_frame_reserve(struct hw_common *phw, pool_entry_t *p_entry, 
+        osal_size_t payload_len, ec_datagram_t **ppdg) {
+    assert(phw != NULL);
+    assert(p_entry != NULL);
+    assert(ppdg != NULL);
+    assert(phw->tx_frame_in_place == OSAL_TRUE);
+
+    ec_datagram_t *pdg = NULL;
+
+    hw_check_lost(phw, p_entry);
+
+    int ret = hw_tx_frame_append(phw, p_entry, 
+            ec_datagram_hdr_length + payload_len + EC_WKC_SIZE, POOL_HIGH, &pdg);
+    if (ret == EC_OK) {
+        (void)memset(pdg, 0, ec_datagram_hdr_length);
+        pdg->idx = p_entry->p_idx->idx;
+        pdg->len = payload_len;
+        (void)memset(&ec_datagram_payload(pdg)[payload_len], 0, EC_WKC_SIZE);
+
+        *ppdg = pdg;
+    }
+
+    return ret;
+}
+
+//! Add prebuilt datagrams to frame opened by \link hw_tx_frame_open \endlink.
+/*!
+ * \param[in]   phw             Pointer to hw handle.
+ * \param[in]   tmpl            Prebuilt chained datagrams.
+ * \param[in]   len             Length of \p tmpl in bytes.
+ * \param[in]   p_entries       Pool entries of the datagrams in \p tmpl, in order.
+ * \param[in]   cnt             Number of datagrams in \p tmpl.
+ * \param[out]  pp_data         Returns pointer to the copy of \p tmpl in frame.
+ *
+ * \return EC_OK or error code
+ */
+int hw_tx_frame_add_template(struct hw_common *phw, const osal_uint8_t *tmpl, osal_size_t len, 
+        pool_entry_t * const *p_entries, osal_size_t cnt, osal_uint8_t **pp_data) {
+    assert(phw != NULL);
+    assert(tmpl != NULL);
+    assert(p_entries != NULL);
+    assert(cnt > 0u);
+    assert(pp_data != NULL);
+    assert(phw->tx_frame_in_place == OSAL_TRUE);
+
+    ec_datagram_t *pdg = NULL;
+
+    for (osal_size_t i = 0u; i < cnt; ++i) {
+        hw_check_lost(phw, p_entries[i]);
+    }
+
+    int ret = hw_tx_frame_append(phw, p_entries[0], len, POOL_HIGH, &pdg);
+    if (ret == EC_OK) {
+        (void)memcpy(pdg, tmpl, len);
+        *pp_data = (osal_uint8_t *)pdg;
+
+        // store remaining datagrams as sent, last one is chained to 
+        // following datagrams
+        for (osal_size_t i = 1u; i < cnt; ++i) {
             pdg = ec_datagram_next(pdg);
+            assert(pdg->idx == p_entries[i]->p_idx->idx);
 
-            // store as sent
-            phw->tx_send[p_entry_dg->idx] = p_entry;
-            
-            p_entry->send_idx = phw->frame_idx;
-            (void)osal_timer_gettime(&p_entry->send_timestamp);
+            phw->tx_send[pdg->idx] = p_entries[i];
+            p_entries[i]->send_idx = phw->frame_idx;
+            p_entries[i]->window_cycle_ns = p_entries[0]->window_cycle_ns;
         }
-    } while (len > 0);
 
-    return sent;
+        phw->tx_frame_dg_prev = pdg;
+    }
+
+    return ret;
 }
 
-//! start sending queued ethercat datagrams (low prio queue)
+//! Send frame opened by \link hw_tx_frame_open \endlink.
 /*!
  * \param phw hardware handle
  * \return 0 or error code
  */
-int hw_tx_high(struct hw_common *phw) {
+int hw_tx_frame_close(struct hw_common *phw) {
+    assert(phw != NULL);
+    assert(phw->tx_frame_in_place == OSAL_TRUE);
+
+    phw->tx_frame_in_place = OSAL_FALSE;
+
+    return hw_tx_frame_end(phw);
+}
+
+//! Configure piggybacking of low priority datagrams on cyclic frames.
+/*!
+ * \param[in]   phw             Pointer to hw handle.
+ * \param[in]   budget_ns       Wire time budget of one cycle [ns].
+ * \param[in]   link_speed_mbps Link speed [Mbit/s], 0 keeps current (default 100).
+ */
+void hw_tx_set_low_budget(struct hw_common *phw, osal_uint64_t budget_ns, osal_uint32_t link_speed_mbps) {
     assert(phw != NULL);
 
     osal_mutex_lock(&phw->hw_lock);
-    osal_uint64_t tx_start = osal_timer_gettime_nsec();
-    osal_timer_init(&phw->next_cylce_start, phw->pec->main_cycle_interval);
-    osal_bool_t sent = hw_tx_pool(phw, POOL_HIGH);
-    phw->last_tx_duration_ns = osal_timer_gettime_nsec() - tx_start;
-    
+    phw->tx_low_budget_ns = budget_ns;
+    phw->tx_low_budget_warned = OSAL_FALSE;
+    if (link_speed_mbps > 0u) {
+        phw->link_speed_mbps = link_speed_mbps;
+    }
+    osal_mutex_unlock(&phw->hw_lock);
+}
+
+//! Configure sending of low priority datagrams between cycles.
+/*!
+ * Enabled by default. Not used with devices in polling mode 
+ * (\link hw_common::rx_polling \endlink), their replies would be received 
+ * by the sending thread while holding hw_lock and could delay the next 
+ * cyclic frame. Their low priority datagrams always wait for the next cycle.
+ *
+ * \param[in]   phw             Pointer to hw handle.
+ * \param[in]   enable          Enable sending in the idle time of a cycle.
+ * \param[in]   guard_ns        Margin frames have to return before the next cycle [ns].
+ */
+void hw_tx_set_low_window(struct hw_common *phw, osal_bool_t enable, osal_uint64_t guard_ns) {
+    assert(phw != NULL);
+
+    osal_mutex_lock(&phw->hw_lock);
+    phw->tx_window = enable;
+    phw->tx_window_guard_ns = guard_ns;
+    osal_mutex_unlock(&phw->hw_lock);
+}
+
+//! Send low priority datagrams in the idle time before the next cycle.
+/*!
+ * Datagrams are only sent if their frames are expected back before the 
+ * next cycle starts, the others stay queued for the next cycle.
+ *
+ * \param[in]   phw             Pointer to hw handle.
+ *
+ * \retval OSAL_TRUE when at least one frame was sent
+ * \retval OSAL_FALSE when no frame was sent
+ */
+osal_bool_t hw_tx_low_window(struct hw_common *phw) {
+    assert(phw != NULL);
+
+    ec_t *pec = phw->pec;
+    osal_bool_t sent = OSAL_FALSE;
+
+    // hw_lock is held by the cyclic thread from hw_tx until its frames are out
+    osal_mutex_lock(&phw->hw_lock);
+
+    // without rx thread the reply would be polled here under hw_lock and 
+    // could delay the next cyclic frame
+    if ((phw->tx_window == OSAL_TRUE) && (phw->rx_polling == OSAL_FALSE) && 
+            (pec->main_cycle_interval > 0)) {
+        osal_uint64_t now = osal_timer_gettime_nsec();
+        osal_uint64_t cycle_end = ((osal_uint64_t)phw->next_cylce_start.sec * NSEC_PER_SEC) + 
+            (osal_uint64_t)phw->next_cylce_start.nsec;
+        osal_uint64_t reserve = phw->frame_rtt_ns + phw->tx_window_guard_ns;
+        osal_size_t cnt = 0u;
+
+        if (cycle_end > (now + reserve)) {
+            osal_uint64_t frame_idx_start = phw->frame_idx;
+
+            // tag datagrams, their replies are compared to the next cycle in hw_process_rx_frame
+            phw->tx_window_cycle_ns = cycle_end;
+            cnt = hw_tx_piggyback(phw, phw->tx_cycle_wire_bytes + 
+                    hw_wire_budget(phw, cycle_end - now - reserve), 0u, POOL_LOW);
+            hw_tx_frame_flush(phw, POOL_LOW);
+            phw->tx_window_cycle_ns = 0u;
+
+            sent = (phw->frame_idx != frame_idx_start) ? OSAL_TRUE : OSAL_FALSE;
+            (void)__atomic_fetch_add(&pec->stats.tx_window_datagrams, cnt, __ATOMIC_RELAXED);
+        }
+
+        pool_entry_t *p_entry = NULL;
+        if (pool_mpsc_peek(&phw->tx_low, &p_entry) == EC_OK) {
+            (void)__atomic_fetch_add(&pec->stats.tx_window_missed, 1u, __ATOMIC_RELAXED);
+        }
+    }
+
     osal_mutex_unlock(&phw->hw_lock);
 
     return sent;
 }
 
+//! start sending queued ethercat datagrams (low prio queue)
+/*!
+ * \param phw hardware handle
+ * \return 0 or error code
+ */
+int hw_tx_high(struct hw_common *phw) {
+    assert(phw != NULL);
+
+    hw_tx_frame_begin(phw);
+
+    return hw_tx_frame_end(phw);
+}
+
 //! start sending queued ethercat datagrams (low prio queue)
 /*!
  * \param phw hardware handle
@@ -332,8 +1010,22 @@ int hw_tx(struct hw_common *phw) {
     osal_mutex_lock(&phw->hw_lock);
 
     osal_timer_init(&phw->next_cylce_start, phw->pec->main_cycle_interval);
-    osal_bool_t sent = hw_tx_pool(phw, POOL_HIGH);
-    sent |= hw_tx_pool(phw, POOL_LOW);
+    phw->tx_cycle_wire_bytes = 0u;
+
+    osal_bool_t sent;
+    if (phw->tx_low_budget_ns > 0u) {
+        osal_uint64_t frame_idx_start = phw->frame_idx;
+
+        // low prio datagrams exceeding the budget stay queued for the next cycle
+        hw_tx_pool_fill(phw, POOL_HIGH);
+        hw_tx_piggyback_cycle(phw);
+        hw_tx_frame_flush(phw, POOL_HIGH);
+
+        sent = (phw->frame_idx != frame_idx_start) ? OSAL_TRUE : OSAL_FALSE;
+    } else {
+        sent = hw_tx_pool(phw, POOL_HIGH);
+        sent |= hw_tx_pool(phw, POOL_LOW);
+    }
    
     osal_mutex_unlock(&phw->hw_lock);
 
@@ -109,6 +109,7 @@ int hw_device_file_open(struct hw_file *phw_file, struct ec *pec, const osal_cha
     phw_file->common.get_tx_buffer = hw_device_file_get_tx_buffer;
     phw_file->common.close = hw_device_file_close;
     phw_file->rx_timeout_ns = 100000000;
+    (void)memset(&phw_file->rx_predict, 0, sizeof(phw_file->rx_predict));
     
     int flags = O_RDWR | O_NONBLOCK;
     uint64_t link_timeout_sec = 5, rx_usecs = 0, tx_usecs = 0;
@@ -231,6 +232,8 @@ int hw_device_file_open(struct hw_file *phw_file, struct ec *pec, const osal_cha
             attr.affinity = cpumask;
             (void)strcpy(&attr.task_name[0], "ecat.rx");
             osal_task_create(&phw_file->rxthread, &attr, hw_device_file_rx_thread, phw_file);
+        } else {
+            phw_file->common.rx_polling = OSAL_TRUE;
         }
     }
 
@@ -289,11 +292,26 @@ osal_bool_t hw_device_file_recv_internal(struct hw_file *phw_file) {
    
     if ((ret == OSAL_TRUE) && (phw_file->last_pool_type == POOL_HIGH)) {
         phw_file->common.last_rx_duration_ns = osal_timer_gettime_nsec() - rx_start;
+        ec_histogram_add(&phw_file->common.pec->stats.rx_duration, phw_file->common.last_rx_duration_ns);
     }
 
     return ret;
 }
 
+//! Receive one reply in polling mode.
+/*!
+ * Only one reply per call, the device may have been opened blocking.
+ *
+ * \param[in]   phw         Pointer to hw handle.
+ *
+ * \return Number of received frames which answered sent frames.
+ */
+static osal_size_t hw_device_file_rx_once(struct hw_common *phw) {
+    struct hw_file *phw_file = container_of(phw, struct hw_file, common);
+
+    return (hw_device_file_recv_internal(phw_file) == OSAL_TRUE) ? 1u : 0u;
+}
+
 //! receiver thread
 void *hw_device_file_rx_thread(void *arg) {
     // cppcheck-suppress misra-c2012-11.5
@@ -301,6 +319,9 @@ void *hw_device_file_rx_thread(void *arg) {
     ec_t *pec = phw_file->common.pec;
 
     assert(phw_file != NULL);
+
+    // received frames show up in the cycle timeline
+    (void)ec_trace_register_thread();
     
     osal_task_sched_priority_t rx_prio;
     if (osal_task_get_priority(&phw_file->rxthread, &rx_prio) != OSAL_OK) {
@@ -314,6 +335,7 @@ void *hw_device_file_rx_thread(void *arg) {
     }
     
     ec_log(10, "HW_FILE_RX", "receive thread stopped\n");
+    ec_trace_unregister_thread();
     
     return NULL;
 }
@@ -419,29 +441,18 @@ void hw_device_file_send_finished(struct hw_common *phw) {
 
     // in case of polling do receive now
     if (phw_file->polling_mode == OSAL_TRUE) {
-        while (phw_file->frames_send > 0) {
-            // sleep a little bit (at least packet-on-wire-duration)
-            // 10 [ns] per bit on 100 Mbit/s Ethernet.
-            //uint64_t packet_time = 10 * 8 * phw->bytes_sent; 
-            //osal_sleep(packet_time * 0.4);
-            phw_file->common.bytes_last_sent = phw_file->common.bytes_sent;
-            phw_file->common.bytes_sent = 0;
-
-            osal_bool_t local_ret = OSAL_FALSE;
-            osal_timer_t timeout;
-            osal_timer_init(&timeout, phw_file->rx_timeout_ns);
-            while (osal_timer_expired(&timeout) != OSAL_ERR_TIMEOUT) {
-                local_ret = hw_device_file_recv_internal(phw_file);
-                if (local_ret == OSAL_TRUE) {
-                    phw_file->frames_send--;
-                    break;
-                }
-            }
+        phw_file->common.bytes_last_sent = phw_file->common.bytes_sent;
+        phw_file->common.bytes_sent = 0;
 
-            if (local_ret == OSAL_FALSE) {
+        if (phw_file->frames_send > 0) {
+            // driver has no interrupts in polling mode, so nothing to poll() on
+            osal_size_t received = hw_device_poll_rx(phw, -1, (osal_size_t)phw_file->frames_send, 
+                    phw_file->rx_timeout_ns, &phw_file->rx_predict, hw_device_file_rx_once);
+            if (received < (osal_size_t)phw_file->frames_send) {
                 ec_log(100, "HW_RX", "Timeout on receive\n");
-                break;
             }
+
+            phw_file->frames_send -= (int)LEC_MIN(received, (osal_size_t)phw_file->frames_send);
         }
 
         if (phw_file->frames_send > 0) {
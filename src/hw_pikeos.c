@@ -222,6 +222,9 @@ void *hw_device_pikeos_rx_thread(void *arg) {
     ec_t *pec = phw_pikeos->common.pec;
 
     assert(phw_pikeos != NULL);
+
+    // received frames show up in the cycle timeline
+    (void)ec_trace_register_thread();
     
     osal_task_sched_priority_t rx_prio;
     if (osal_task_get_priority(&phw_pikeos->rxthread, &rx_prio) != OSAL_OK) {
@@ -235,6 +238,7 @@ void *hw_device_pikeos_rx_thread(void *arg) {
     }
     
     ec_log(10, "HW_PIKEOS_RX", "receive thread stopped\n");
+    ec_trace_unregister_thread();
     
     return NULL;
 }
@@ -0,0 +1,758 @@
+/**
+ * \file hw_replay.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief recorded session replay hardware access functions
+ *
+ * Answers sent frames from a pcap recording of a real bus session, for 
+ * hardware-less reproduction and benchmarking.
+ */
+
+/*
+ * This file is part of libethercat.
+ *
+ * libethercat is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * libethercat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with libethercat (LICENSE.LGPL-V3); if not, write 
+ * to the Free Software Foundation, Inc., 51 Franklin Street, Fifth 
+ * Floor, Boston, MA  02110-1301, USA.
+ * 
+ * Please note that the use of the EtherCAT technology, the EtherCAT 
+ * brand name and the EtherCAT logo is only permitted if the property 
+ * rights of Beckhoff Automation GmbH are observed. For further 
+ * information please contact Beckhoff Automation GmbH & Co. KG, 
+ * Hülshorstweg 20, D-33415 Verl, Germany (www.beckhoff.com) or the 
+ * EtherCAT Technology Group, Ostendstraße 196, D-90482 Nuremberg, 
+ * Germany (ETG, www.ethercat.org).
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libethercat/config.h>
+#endif
+
+#include <libethercat/settings.h>
+
+#if LIBETHERCAT_BUILD_DEVICE_REPLAY == 1
+
+#include <libethercat/hw_replay.h>
+#include <libethercat/ec.h>
+#include <libethercat/idx.h>
+#include <libethercat/error_codes.h>
+
+#include <assert.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if LIBETHERCAT_HAVE_UNISTD_H == 1
+#include <unistd.h>
+#endif
+
+#ifdef LIBETHERCAT_HAVE_ARPA_INET_H
+#include <arpa/inet.h>
+#endif
+
+#define PCAP_MAGIC_USEC             (0xA1B2C3D4u)   //!< \brief pcap with microsecond timestamps.
+#define PCAP_MAGIC_NSEC             (0xA1B23C4Du)   //!< \brief pcap with nanosecond timestamps.
+#define PCAP_HDR_LEN                (24u)           //!< \brief pcap file header length.
+#define PCAP_REC_HDR_LEN            (16u)           //!< \brief pcap record header length.
+#define PCAPNG_BLOCK_SHB            (0x0A0D0D0Au)   //!< \brief Section header block.
+#define PCAPNG_BLOCK_EPB            (0x00000006u)   //!< \brief Enhanced packet block.
+#define PCAPNG_BYTE_ORDER_MAGIC     (0x1A2B3C4Du)   //!< \brief Byte order magic.
+#define PCAPNG_EPB_HDR_LEN          (28u)           //!< \brief Enhanced packet block header length.
+#define PCAPNG_OPT_EPB_FLAGS        (2u)            //!< \brief Packet flags, bits 0-1 direction.
+#define PCAPNG_DIR_INBOUND          (1u)            //!< \brief Direction inbound.
+#define LINKTYPE_ETHERNET           (1u)            //!< \brief Link type ethernet.
+
+#define HW_REPLAY_NONE              (0xFFFFFFFFu)   //!< \brief No recorded datagram.
+
+//! Recorded request and its reply, positioned on one datagram.
+typedef struct hw_replay_pair {
+    osal_size_t next;               //!< \brief Offset following request record.
+    const osal_uint8_t *req_end;    //!< \brief End of captured request.
+    const osal_uint8_t *reply_end;  //!< \brief End of captured reply.
+    const ec_datagram_t *req_dg;    //!< \brief Datagram in request.
+    const ec_datagram_t *reply_dg;  //!< \brief Same datagram in reply.
+} hw_replay_pair_t;
+
+//! Recorded datagram with reply, entry of the index built on open.
+typedef struct hw_replay_dg {
+    const ec_datagram_t *req_dg;    //!< \brief Datagram in request.
+    const ec_datagram_t *reply_dg;  //!< \brief Same datagram in reply.
+    osal_uint32_t next_same;        //!< \brief Next datagram with same command, address and length.
+    osal_uint32_t used;             //!< \brief Pass over the recording in which it was replayed.
+} hw_replay_dg_t;
+
+//! Recorded datagrams with same command, address and length.
+typedef struct hw_replay_key {
+    osal_uint32_t adr;              //!< \brief Datagram address.
+    osal_uint16_t len;              //!< \brief Datagram payload length.
+    osal_uint8_t cmd;               //!< \brief Datagram command.
+    osal_uint32_t first;            //!< \brief First datagram, \link HW_REPLAY_NONE \endlink if slot is free.
+    osal_uint32_t next;             //!< \brief Next datagram not replayed yet.
+    osal_uint32_t pass;             //!< \brief Pass over the recording \link next \endlink belongs to.
+} hw_replay_key_t;
+
+// forward declarations
+int hw_device_replay_send(struct hw_common *phw, ec_frame_t *pframe, pooltype_t pool_type);
+int hw_device_replay_recv(struct hw_common *phw);
+void hw_device_replay_send_finished(struct hw_common *phw);
+int hw_device_replay_get_tx_buffer(struct hw_common *phw, ec_frame_t **ppframe);
+int hw_device_replay_close(struct hw_common *phw);
+
+//! Read possibly unaligned 32-bit value from recording.
+static osal_uint32_t hw_replay_u32(const osal_uint8_t *p) {
+    osal_uint32_t val;
+    (void)memcpy(&val, p, sizeof(val));
+    return val;
+}
+
+//! Read possibly unaligned 16-bit value from recording.
+static osal_uint16_t hw_replay_u16(const osal_uint8_t *p) {
+    osal_uint16_t val;
+    (void)memcpy(&val, p, sizeof(val));
+    return val;
+}
+
+//! Parse recorded packet.
+/*!
+ * \param[in]   phw_replay  Pointer to replay hw handle.
+ * \param[in]   pos         Offset of packet record.
+ * \param[out]  data        Returns EtherCAT frame, NULL for other packets.
+ * \param[out]  caplen      Returns captured length of frame.
+ * \param[out]  inbound     Returns OSAL_TRUE if frame was returned by the slaves.
+ * \param[out]  next        Returns offset following packet record.
+ *
+ * \return OSAL_FALSE at end of recording.
+ */
+static osal_bool_t hw_replay_packet(const struct hw_replay *phw_replay, osal_size_t pos, 
+        const osal_uint8_t **data, osal_size_t *caplen, osal_bool_t *inbound, osal_size_t *next) 
+{
+    const osal_uint8_t *rec = phw_replay->rec;
+    osal_size_t size = phw_replay->rec_size;
+    const osal_uint8_t *pkt = NULL;
+    osal_size_t len = 0u;
+    osal_uint32_t dir = 0u;
+    osal_bool_t valid = OSAL_FALSE;
+
+    *data = NULL;
+
+    if (phw_replay->rec_pcapng == OSAL_TRUE) {
+        if ((pos + 12u) <= size) {
+            osal_uint32_t type = hw_replay_u32(&rec[pos]);
+            osal_size_t blen = hw_replay_u32(&rec[pos + 4u]);
+
+            if ((blen >= 12u) && (blen <= (size - pos))) {
+                if ((type == PCAPNG_BLOCK_EPB) && (blen >= (PCAPNG_EPB_HDR_LEN + 4u))) {
+                    len = hw_replay_u32(&rec[pos + 20u]);
+                    if (len <= (blen - PCAPNG_EPB_HDR_LEN - 4u)) {
+                        pkt = &rec[pos + PCAPNG_EPB_HDR_LEN];
+
+                        osal_size_t opt = pos + PCAPNG_EPB_HDR_LEN + ((len + 3u) & ~3u);
+                        while ((opt + 4u) <= (pos + blen - 4u)) {
+                            osal_uint16_t code = hw_replay_u16(&rec[opt]);
+                            osal_uint16_t olen = hw_replay_u16(&rec[opt + 2u]);
+                            if (code == 0u) { break; }
+                            if ((code == PCAPNG_OPT_EPB_FLAGS) && (olen == 4u) && ((opt + 8u) <= (pos + blen))) {
+                                dir = hw_replay_u32(&rec[opt + 4u]) & 3u;
+                            }
+                            opt += 4u + ((olen + 3u) & ~3u);
+                        }
+                    }
+                }
+
+                *next = pos + blen;
+                valid = OSAL_TRUE;
+            }
+        }
+    } else {
+        if ((pos + PCAP_REC_HDR_LEN) <= size) {
+            len = hw_replay_u32(&rec[pos + 8u]);
+            if (len <= (size - pos - PCAP_REC_HDR_LEN)) {
+                pkt = &rec[pos + PCAP_REC_HDR_LEN];
+                *next = pos + PCAP_REC_HDR_LEN + len;
+                valid = OSAL_TRUE;
+            }
+        }
+    }
+
+    if ((pkt != NULL) && (len >= (sizeof(ec_frame_t) + ec_datagram_hdr_length + EC_WKC_SIZE))) {
+        ec_frame_t hdr;
+        (void)memcpy(&hdr, pkt, sizeof(hdr));
+
+        if (hdr.ethertype == htons(ETH_P_ECAT)) {
+            // slaves set the locally administered bit of the source address
+            *inbound = (dir != 0u) ? (dir == PCAPNG_DIR_INBOUND) : ((hdr.mac_src[0] & 0x02u) != 0u);
+            *data = pkt;
+            *caplen = len;
+        }
+    }
+
+    return valid;
+}
+
+//! Check that current datagram lies within request and reply frame.
+/*!
+ * \param[in]   pair        Recorded request and reply.
+ *
+ * \return OSAL_TRUE if datagram is complete in both frames.
+ */
+static osal_bool_t hw_replay_pair_dg_valid(const hw_replay_pair_t *pair) {
+    const osal_uint8_t *req = (const osal_uint8_t *)pair->req_dg;
+    const osal_uint8_t *reply = (const osal_uint8_t *)pair->reply_dg;
+
+    return ((&req[ec_datagram_hdr_length] <= pair->req_end) && 
+            (&req[ec_datagram_length(pair->req_dg)] <= pair->req_end) && 
+            (&reply[ec_datagram_length(pair->req_dg)] <= pair->reply_end) &&
+            (pair->reply_dg->cmd == pair->req_dg->cmd) && 
+            (pair->reply_dg->len == pair->req_dg->len)) ? OSAL_TRUE : OSAL_FALSE;
+}
+
+//! Find next recorded request and its reply.
+/*!
+ * Requests without reply, e.g. lost frames, are skipped.
+ *
+ * \param[in]   phw_replay  Pointer to replay hw handle.
+ * \param[in]   pos         Offset to start search.
+ * \param[out]  pair        Returns request and reply, positioned on first datagram.
+ *
+ * \return OSAL_FALSE at end of recording.
+ */
+static osal_bool_t hw_replay_pair_first(const struct hw_replay *phw_replay, osal_size_t pos, 
+        hw_replay_pair_t *pair) 
+{
+    const osal_uint8_t *data = NULL;
+    osal_size_t caplen = 0u;
+    osal_bool_t inbound = OSAL_FALSE;
+    osal_size_t next = 0u;
+    osal_bool_t found = OSAL_FALSE;
+
+    while ((found == OSAL_FALSE) && (hw_replay_packet(phw_replay, pos, &data, &caplen, &inbound, &next) == OSAL_TRUE)) {
+        if ((data != NULL) && (inbound == OSAL_FALSE)) {
+            // cppcheck-suppress misra-c2012-11.8
+            const ec_datagram_t *req_dg = ec_datagram_first((ec_frame_t *)data);
+            const osal_uint8_t *rdata = NULL;
+            osal_size_t rcaplen = 0u;
+            osal_bool_t rinbound = OSAL_FALSE;
+            osal_size_t rpos = next;
+            osal_size_t rnext = 0u;
+
+            // the reply carries the same index and length as the request
+            for (osal_size_t n = 0u; (found == OSAL_FALSE) && (n < HW_REPLAY_MAX_IN_FLIGHT) && 
+                    (hw_replay_packet(phw_replay, rpos, &rdata, &rcaplen, &rinbound, &rnext) == OSAL_TRUE); ++n) {
+                if ((rdata != NULL) && (rinbound == OSAL_TRUE) && (rcaplen == caplen)) {
+                    // cppcheck-suppress misra-c2012-11.8
+                    const ec_datagram_t *reply_dg = ec_datagram_first((ec_frame_t *)rdata);
+
+                    if (reply_dg->idx == req_dg->idx) {
+                        pair->next = next;
+                        pair->req_end = &data[caplen];
+                        pair->reply_end = &rdata[rcaplen];
+                        pair->req_dg = req_dg;
+                        pair->reply_dg = reply_dg;
+                        found = hw_replay_pair_dg_valid(pair);
+                    }
+                }
+
+                rpos = rnext;
+            }
+        }
+
+        pos = next;
+    }
+
+    return found;
+}
+
+//! Move to next recorded datagram.
+/*!
+ * \param[in]     phw_replay  Pointer to replay hw handle.
+ * \param[in,out] pair        Recorded request and reply.
+ *
+ * \return OSAL_FALSE at end of recording.
+ */
+static osal_bool_t hw_replay_pair_next(const struct hw_replay *phw_replay, hw_replay_pair_t *pair) {
+    osal_bool_t valid = OSAL_FALSE;
+
+    if (pair->req_dg->next != 0u) {
+        hw_replay_pair_t tmp = *pair;
+        // cppcheck-suppress misra-c2012-11.8
+        tmp.req_dg = ec_datagram_next((ec_datagram_t *)pair->req_dg);
+        // cppcheck-suppress misra-c2012-11.8
+        tmp.reply_dg = ec_datagram_next((ec_datagram_t *)pair->reply_dg);
+
+        if (hw_replay_pair_dg_valid(&tmp) == OSAL_TRUE) {
+            *pair = tmp;
+            valid = OSAL_TRUE;
+        }
+    }
+
+    if (valid == OSAL_FALSE) {
+        valid = hw_replay_pair_first(phw_replay, pair->next, pair);
+    }
+
+    return valid;
+}
+
+//! Hash of command, address and length.
+static osal_uint32_t hw_replay_hash(const ec_datagram_t *dg) {
+    osal_uint32_t h = (dg->adr ^ ((osal_uint32_t)dg->cmd << 24u) ^ ((osal_uint32_t)dg->len << 8u)) * 0x9E3779B1u;
+    return h ^ (h >> 16u);
+}
+
+//! Look up recorded datagrams with command, address and length of a datagram.
+/*!
+ * \param[in]   phw_replay  Pointer to replay hw handle.
+ * \param[in]   dg          Datagram.
+ *
+ * \return Matching key, or free slot for it if not recorded.
+ */
+static hw_replay_key_t *hw_replay_key(const struct hw_replay *phw_replay, const ec_datagram_t *dg) {
+    osal_size_t i = (osal_size_t)hw_replay_hash(dg) & phw_replay->key_mask;
+    hw_replay_key_t *key = &phw_replay->keys[i];
+
+    // table has at least twice as many slots as keys
+    while ((key->first != HW_REPLAY_NONE) && 
+            ((key->cmd != dg->cmd) || (key->adr != dg->adr) || (key->len != dg->len))) {
+        i = (i + 1u) & phw_replay->key_mask;
+        key = &phw_replay->keys[i];
+    }
+
+    return key;
+}
+
+//! Build index of recorded datagrams.
+/*!
+ * Pairs all recorded requests with their replies once, so sent datagrams 
+ * are looked up by command, address and length without parsing the 
+ * recording again. Datagrams with the same key are chained in recorded
+ * order.
+ *
+ * \param[in]   phw_replay  Pointer to replay hw handle.
+ *
+ * \return 0 or negative error code
+ */
+static int hw_replay_index(struct hw_replay *phw_replay) {
+    ec_t *pec = phw_replay->common.pec;
+    int ret = EC_OK;
+    hw_replay_pair_t pair;
+    osal_size_t cnt = 0u;
+    osal_size_t slots = 16u;
+
+    for (osal_bool_t valid = hw_replay_pair_first(phw_replay, phw_replay->rec_first, &pair); 
+            valid == OSAL_TRUE; valid = hw_replay_pair_next(phw_replay, &pair)) {
+        cnt++;
+    }
+
+    if ((cnt == 0u) || (cnt >= HW_REPLAY_NONE)) {
+        ec_log(1, "HW_OPEN", "recording contains %" PRIu64 " requests with reply\n", (osal_uint64_t)cnt);
+        ret = EC_ERROR_HW_NOT_SUPPORTED;
+    } else {
+        while (slots < (2u * cnt)) {
+            slots <<= 1u;
+        }
+
+        phw_replay->index_size = (cnt * sizeof(hw_replay_dg_t)) + (slots * sizeof(hw_replay_key_t));
+        void *map = mmap(NULL, phw_replay->index_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (map == MAP_FAILED) {
+            ec_log(1, "HW_OPEN", "mmap() index: %s\n", strerror(errno));
+            ret = EC_ERROR_OUT_OF_MEMORY;
+        } else {
+            // cppcheck-suppress misra-c2012-11.5
+            phw_replay->dgs = (hw_replay_dg_t *)map;
+            // cppcheck-suppress misra-c2012-11.3
+            phw_replay->keys = (hw_replay_key_t *)&((osal_uint8_t *)map)[cnt * sizeof(hw_replay_dg_t)];
+            phw_replay->key_mask = slots - 1u;
+            phw_replay->dg_cnt = cnt;
+
+            for (osal_size_t i = 0u; i < slots; ++i) {
+                phw_replay->keys[i].first = HW_REPLAY_NONE;
+            }
+        }
+    }
+
+    if (ret == EC_OK) {
+        osal_uint32_t i = 0u;
+
+        for (osal_bool_t valid = hw_replay_pair_first(phw_replay, phw_replay->rec_first, &pair); 
+                (valid == OSAL_TRUE) && (i < cnt); valid = hw_replay_pair_next(phw_replay, &pair)) {
+            hw_replay_dg_t *dg = &phw_replay->dgs[i];
+            hw_replay_key_t *key = hw_replay_key(phw_replay, pair.req_dg);
+
+            dg->req_dg = pair.req_dg;
+            dg->reply_dg = pair.reply_dg;
+            dg->next_same = HW_REPLAY_NONE;
+            dg->used = 0u;
+
+            // next is the tail of the chain while building
+            if (key->first == HW_REPLAY_NONE) {
+                key->cmd = pair.req_dg->cmd;
+                key->adr = pair.req_dg->adr;
+                key->len = pair.req_dg->len;
+                key->first = i;
+            } else {
+                phw_replay->dgs[key->next].next_same = i;
+            }
+
+            key->next = i;
+            i++;
+        }
+
+        for (osal_size_t k = 0u; k < slots; ++k) {
+            phw_replay->keys[k].next = phw_replay->keys[k].first;
+            phw_replay->keys[k].pass = 1u;
+        }
+
+        phw_replay->pass = 1u;
+        phw_replay->cursor = 0u;
+    }
+
+    return ret;
+}
+
+//! Find recorded reply datagram matching sent datagram.
+/*!
+ * The sent datagram is compared with the recorded requests, so addresses 
+ * changed by the slaves (e.g. auto increment) do not matter. Datagrams 
+ * may be answered out of order within the search window, each recorded 
+ * datagram is replayed once. The recorded datagrams of a key are taken
+ * in order, so a lookup is a hash lookup in the index.
+ *
+ * \param[in]   phw_replay  Pointer to replay hw handle.
+ * \param[in]   sent        Sent datagram.
+ * \param[out]  reply       Returns recorded reply datagram.
+ *
+ * \return OSAL_TRUE if found within \link HW_REPLAY_LOOKAHEAD \endlink datagrams.
+ */
+static osal_bool_t hw_replay_find(struct hw_replay *phw_replay, const ec_datagram_t *sent, 
+        const ec_datagram_t **reply) 
+{
+    hw_replay_key_t *key = hw_replay_key(phw_replay, sent);
+    osal_uint32_t i = HW_REPLAY_NONE;
+    osal_bool_t found = OSAL_FALSE;
+
+    if (key->first != HW_REPLAY_NONE) {
+        if (key->pass != phw_replay->pass) {
+            key->next = key->first;
+            key->pass = phw_replay->pass;
+        }
+
+        // the search window slid over these, they are not replayed any more
+        i = key->next;
+        while ((i != HW_REPLAY_NONE) && (i < phw_replay->cursor)) {
+            i = phw_replay->dgs[i].next_same;
+        }
+        key->next = i;
+
+        if ((i != HW_REPLAY_NONE) && ((i - phw_replay->cursor) < HW_REPLAY_LOOKAHEAD)) {
+            found = OSAL_TRUE;
+        } else if (((phw_replay->cursor + HW_REPLAY_LOOKAHEAD) > phw_replay->dg_cnt) && 
+                (key->first < HW_REPLAY_LOOKAHEAD)) {
+            // end of recording within search window, start over
+            phw_replay->pass++;
+            phw_replay->cursor = 0u;
+            phw_replay->wraps++;
+
+            i = key->first;
+            key->pass = phw_replay->pass;
+            found = OSAL_TRUE;
+        } else {}
+    }
+
+    if (found == OSAL_TRUE) {
+        hw_replay_dg_t *dg = &phw_replay->dgs[i];
+
+        *reply = dg->reply_dg;
+        dg->used = phw_replay->pass;
+        key->next = dg->next_same;
+
+        // slide over replayed datagrams, drop unanswered ones once half 
+        // of the window is used.
+        while ((phw_replay->cursor < phw_replay->dg_cnt) && 
+                ((phw_replay->dgs[phw_replay->cursor].used == phw_replay->pass) || 
+                 ((i > phw_replay->cursor) && ((i - phw_replay->cursor) >= (HW_REPLAY_LOOKAHEAD / 2u))))) {
+            phw_replay->cursor++;
+        }
+    }
+
+    return found;
+}
+
+//! Process all pending replies.
+/*!
+ * \param[in]   phw_replay  Pointer to replay hw handle.
+ */
+static void hw_device_replay_deliver(struct hw_replay *phw_replay) {
+    for (osal_size_t i = 0u; i < phw_replay->pending_cnt; ++i) {
+        // cppcheck-suppress misra-c2012-11.3
+        (void)hw_process_rx_frame(&phw_replay->common, (ec_frame_t *)&phw_replay->pending[i][0]);
+    }
+
+    phw_replay->pending_cnt = 0u;
+}
+
+//! Opens recorded session as EtherCAT hw device.
+/*!
+ * \param[in]   phw_replay  Pointer to replay hw handle. 
+ * \param[in]   pec         Pointer to master structure.
+ * \param[in]   path        Null-terminated path to recording.
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_replay_open(struct hw_replay *phw_replay, struct ec *pec, const osal_char_t *path) {
+    assert(phw_replay != NULL);
+    assert(path != NULL);
+
+    int ret = EC_OK;
+    ec_frame_t *pframe = NULL;
+    static const osal_uint8_t mac_dest[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+    static const osal_uint8_t mac_src[] = {0x00, 0x30, 0x64, 0x0f, 0x83, 0x35};
+
+    hw_open(&phw_replay->common, pec);
+
+    phw_replay->common.send = hw_device_replay_send;
+    phw_replay->common.recv = hw_device_replay_recv;
+    phw_replay->common.send_finished = hw_device_replay_send_finished;
+    phw_replay->common.get_tx_buffer = hw_device_replay_get_tx_buffer;
+    phw_replay->common.close = hw_device_replay_close;
+    phw_replay->common.mtu_size = 1480;
+    phw_replay->common.rx_polling = OSAL_TRUE;
+
+    phw_replay->rec = NULL;
+    phw_replay->rec_size = 0u;
+    phw_replay->dgs = NULL;
+    phw_replay->keys = NULL;
+    phw_replay->index_size = 0u;
+    phw_replay->dg_cnt = 0u;
+    phw_replay->pending_cnt = 0u;
+    phw_replay->last_pool_type = POOL_HIGH;
+    phw_replay->replayed = 0u;
+    phw_replay->mismatches = 0u;
+    phw_replay->wraps = 0u;
+
+    // cppcheck-suppress misra-c2012-7.1
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        ec_log(1, "HW_OPEN", "error opening %s: %s\n", path, strerror(errno));
+        ret = EC_ERROR_HW_NO_INTERFACE;
+    } else {
+        struct stat st;
+        if ((fstat(fd, &st) != 0) || (st.st_size < 4)) {
+            ec_log(1, "HW_OPEN", "%s is empty or not readable\n", path);
+            ret = EC_ERROR_HW_NO_INTERFACE;
+        } else {
+            void *map = mmap(NULL, (osal_size_t)st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+            if (map == MAP_FAILED) {
+                ec_log(1, "HW_OPEN", "mmap() %s: %s\n", path, strerror(errno));
+                ret = EC_ERROR_HW_NO_INTERFACE;
+            } else {
+                phw_replay->rec = (const osal_uint8_t *)map;
+                phw_replay->rec_size = (osal_size_t)st.st_size;
+            }
+        }
+
+        (void)close(fd);
+    }
+
+    if (ret == EC_OK) {
+        const osal_uint8_t *rec = phw_replay->rec;
+        osal_uint32_t magic = hw_replay_u32(&rec[0]);
+
+        if ((magic == PCAP_MAGIC_USEC) || (magic == PCAP_MAGIC_NSEC)) {
+            if ((phw_replay->rec_size < PCAP_HDR_LEN) || (hw_replay_u32(&rec[20]) != LINKTYPE_ETHERNET)) {
+                ec_log(1, "HW_OPEN", "%s: no ethernet pcap\n", path);
+                ret = EC_ERROR_HW_NOT_SUPPORTED;
+            } else {
+                phw_replay->rec_pcapng = OSAL_FALSE;
+                phw_replay->rec_first = PCAP_HDR_LEN;
+            }
+        } else if ((magic == PCAPNG_BLOCK_SHB) && (phw_replay->rec_size >= 12u) && 
+                (hw_replay_u32(&rec[8]) == PCAPNG_BYTE_ORDER_MAGIC)) {
+            phw_replay->rec_pcapng = OSAL_TRUE;
+            phw_replay->rec_first = 0u;
+        } else {
+            ec_log(1, "HW_OPEN", "%s: no pcap or pcapng in host byte order\n", path);
+            ret = EC_ERROR_HW_NOT_SUPPORTED;
+        }
+    }
+
+    if (ret == EC_OK) {
+        ret = hw_replay_index(phw_replay);
+    }
+
+    if (ret == EC_OK) {
+        // cppcheck-suppress misra-c2012-11.3
+        pframe = (ec_frame_t *)phw_replay->send_frame;
+        (void)memcpy(pframe->mac_dest, mac_dest, 6);
+        (void)memcpy(pframe->mac_src, mac_src, 6);
+
+        ec_log(10, "HW_OPEN", "replaying %s (%" PRIu64 " bytes, %" PRIu64 " datagrams)\n", path, 
+                (osal_uint64_t)phw_replay->rec_size, (osal_uint64_t)phw_replay->dg_cnt);
+    } else if (phw_replay->rec != NULL) {
+        // cppcheck-suppress misra-c2012-11.8
+        (void)munmap((void *)phw_replay->rec, phw_replay->rec_size);
+        phw_replay->rec = NULL;
+    } else {}
+
+    return ret;
+}
+
+//! Close hardware layer
+/*!
+ * \param[in]   phw         Pointer to hw handle.
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_replay_close(struct hw_common *phw) {
+    assert(phw != NULL);
+
+    ec_t *pec = phw->pec;
+    struct hw_replay *phw_replay = container_of(phw, struct hw_replay, common);
+
+    ec_log(10, "HW_CLOSE", "replayed %" PRIu64 " datagrams, %" PRIu64 " not found, "
+            "recording restarted %" PRIu64 " times\n", 
+            phw_replay->replayed, phw_replay->mismatches, phw_replay->wraps);
+
+    if (phw_replay->dgs != NULL) {
+        (void)munmap(phw_replay->dgs, phw_replay->index_size);
+        phw_replay->dgs = NULL;
+        phw_replay->keys = NULL;
+    }
+
+    if (phw_replay->rec != NULL) {
+        // cppcheck-suppress misra-c2012-11.8
+        (void)munmap((void *)phw_replay->rec, phw_replay->rec_size);
+        phw_replay->rec = NULL;
+    }
+
+    return 0;
+}
+
+//! Receive a frame from an EtherCAT hw device.
+/*!
+ * Replies are only processed by \link hw_rx \endlink.
+ *
+ * \param[in]   phw         Pointer to hw handle. 
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_replay_recv(struct hw_common *phw) {
+    (void)phw;
+    return EC_ERROR_HW_NOT_SUPPORTED;
+}
+
+//! Get a free tx buffer from underlying hw device.
+/*!
+ * \param[in]   phw         Pointer to hw handle. 
+ * \param[in]   ppframe     Pointer to return frame buffer pointer.
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_replay_get_tx_buffer(struct hw_common *phw, ec_frame_t **ppframe) {
+    assert(phw != NULL);
+    assert(ppframe != NULL);
+
+    struct hw_replay *phw_replay = container_of(phw, struct hw_replay, common);
+    
+    // cppcheck-suppress misra-c2012-11.3
+    ec_frame_t *pframe = (ec_frame_t *)phw_replay->send_frame;
+
+    // reset length to send new frame
+    pframe->ethertype = htons(ETH_P_ECAT);
+    pframe->type = 0x01;
+    pframe->len = sizeof(ec_frame_t);
+
+    *ppframe = pframe;
+
+    return EC_OK;
+}
+
+//! Send a frame from an EtherCAT hw device.
+/*!
+ * Builds the reply from the recording.
+ *
+ * \param[in]   phw         Pointer to hw handle. 
+ * \param[in]   pframe      Pointer to frame buffer.
+ * \param[in]   pool_type   Pool type to distinguish between high and low prio frames.
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_replay_send(struct hw_common *phw, ec_frame_t *pframe, pooltype_t pool_type) {
+    assert(phw != NULL);
+    assert(pframe != NULL);
+
+    ec_t *pec = phw->pec;
+    struct hw_replay *phw_replay = container_of(phw, struct hw_replay, common);
+    phw_replay->last_pool_type = pool_type;
+
+    if (phw_replay->pending_cnt == HW_REPLAY_MAX_PENDING) {
+        hw_device_replay_deliver(phw_replay);
+    }
+
+    // cppcheck-suppress misra-c2012-11.3
+    ec_frame_t *preply = (ec_frame_t *)&phw_replay->pending[phw_replay->pending_cnt][0];
+    (void)memcpy(preply, pframe, pframe->len);
+
+    for (ec_datagram_t *d = ec_datagram_first(preply); (osal_uint8_t *)d < ec_frame_end(preply); 
+            d = ec_datagram_next(d)) {
+        const ec_datagram_t *rd = NULL;
+
+        if (hw_replay_find(phw_replay, d, &rd) == OSAL_TRUE) {
+            // keep index of sent datagram
+            d->irq = rd->irq;
+            // cppcheck-suppress misra-c2012-11.8
+            (void)memcpy(ec_datagram_payload(d), ec_datagram_payload((ec_datagram_t *)rd), 
+                    (osal_size_t)d->len + EC_WKC_SIZE);
+            phw_replay->replayed++;
+        } else {
+            ec_log(100, "HW_TX", "datagram cmd %u adr 0x%08" PRIX32 " len %u not in recording\n", 
+                    d->cmd, d->adr, (unsigned)d->len);
+            phw_replay->mismatches++;
+        }
+    }
+
+    phw_replay->pending_cnt++;
+    phw->bytes_sent += pframe->len;
+
+    return EC_OK;
+}
+
+//! Doing internal stuff when finished sending frames
+/*!
+ * \param[in]   phw         Pointer to hw handle.
+ */
+void hw_device_replay_send_finished(struct hw_common *phw) {
+    assert(phw != NULL);
+
+    struct hw_replay *phw_replay = container_of(phw, struct hw_replay, common);
+
+    phw->bytes_last_sent = phw->bytes_sent;
+    phw->bytes_sent = 0;
+
+    osal_uint64_t rx_start = osal_timer_gettime_nsec();
+    hw_device_replay_deliver(phw_replay);
+
+    if (phw_replay->last_pool_type == POOL_HIGH) {
+        phw->last_rx_duration_ns = osal_timer_gettime_nsec() - rx_start;
+        ec_histogram_add(&phw->pec->stats.rx_duration, phw->last_rx_duration_ns);
+    }
+}
+
+#endif /* LIBETHERCAT_BUILD_DEVICE_REPLAY == 1 */
+
@@ -122,6 +122,7 @@ int hw_device_sock_raw_open(struct hw_sock_raw *phw_sock_raw, struct ec *pec, co
     int ret = EC_OK;
     struct ifreq ifr;
     int ifindex;
+    osal_char_t ifname[IFNAMSIZ];
     
     if (try_grant_cap_net_raw_init(pec) == -1) {
         ec_log(10, "hw_open", "grant_cap_net_raw unsuccessfull, maybe we are "
@@ -136,6 +137,14 @@ int hw_device_sock_raw_open(struct hw_sock_raw *phw_sock_raw, struct ec *pec, co
     phw_sock_raw->common.get_tx_buffer = hw_device_sock_raw_get_tx_buffer;
     phw_sock_raw->common.close = hw_device_sock_raw_close;
 
+    phw_sock_raw->polling_mode = OSAL_FALSE;
+    phw_sock_raw->rx_timeout_ns = 100000000u;
+    (void)memset(&phw_sock_raw->rx_predict, 0, sizeof(phw_sock_raw->rx_predict));
+    phw_sock_raw->frames_send = 0u;
+    phw_sock_raw->rxthreadrunning = 0;
+    hw_device_parse_options(devname, ifname, sizeof(ifname), 
+            &phw_sock_raw->polling_mode, &phw_sock_raw->rx_timeout_ns);
+
     // create raw socket connection
     phw_sock_raw->sockfd = socket(PF_PACKET, SOCK_RAW, htons(ETH_P_ECAT));
     if (phw_sock_raw->sockfd <= 0) {
@@ -158,10 +167,10 @@ int hw_device_sock_raw_open(struct hw_sock_raw *phw_sock_raw, struct ec *pec, co
         setsockopt(phw_sock_raw->sockfd, SOL_SOCKET, SO_DONTROUTE, &i, sizeof(i));
 
         // attach to out network interface
-        (void)strcpy(ifr.ifr_name, devname);
+        (void)strcpy(ifr.ifr_name, ifname);
         ioctl(phw_sock_raw->sockfd, SIOCGIFINDEX, &ifr);
         ifindex = ifr.ifr_ifindex;
-        (void)strcpy(ifr.ifr_name, devname);
+        (void)strcpy(ifr.ifr_name, ifname);
         ifr.ifr_flags = 0;
         ioctl(phw_sock_raw->sockfd, SIOCGIFFLAGS, &ifr);
 
@@ -169,7 +178,7 @@ int hw_device_sock_raw_open(struct hw_sock_raw *phw_sock_raw, struct ec *pec, co
         ifr.ifr_flags = ifr.ifr_flags | IFF_PROMISC | IFF_BROADCAST | IFF_UP;
         /*int ret =*/ ioctl(phw_sock_raw->sockfd, SIOCSIFFLAGS, &ifr);
         //    if (ret != 0) {
-        //        ec_log(1, "HW_OPEN", "error setting interface %s: %s\n", devname, strerror(errno));
+        //        ec_log(1, "HW_OPEN", "error setting interface %s: %s\n", ifname, strerror(errno));
         //        goto error_exit;
         //    }
         
@@ -179,10 +188,10 @@ int hw_device_sock_raw_open(struct hw_sock_raw *phw_sock_raw, struct ec *pec, co
             ioctl(phw_sock_raw->sockfd, SIOCGIFFLAGS, &ifr);
             iff_running = (ifr.ifr_flags & IFF_RUNNING) == 0 ? OSAL_FALSE : OSAL_TRUE;
             if (iff_running == OSAL_TRUE) {
-                ec_log(10, "HW_OPEN", "interface %s is RUNNING now, wait additional 2 sec for link to be established!\n", devname);
+                ec_log(10, "HW_OPEN", "interface %s is RUNNING now, wait additional 2 sec for link to be established!\n", ifname);
                 osal_sleep(1000000000);
             } else {
-                ec_log(10, "HW_OPEN", "interface %s is not RUNNING, waiting ...\n", devname);
+                ec_log(10, "HW_OPEN", "interface %s is not RUNNING, waiting ...\n", ifname);
             }
             
             if (osal_timer_expired(&up_timeout) == OSAL_ERR_TIMEOUT) {
@@ -193,7 +202,7 @@ int hw_device_sock_raw_open(struct hw_sock_raw *phw_sock_raw, struct ec *pec, co
         }
 
         if (iff_running == OSAL_FALSE) {
-            ec_log(1, "HW_OPEN", "unable to bring interface %s UP!\n", devname);
+            ec_log(1, "HW_OPEN", "unable to bring interface %s UP!\n", ifname);
             ret = EC_ERROR_UNAVAILABLE;
             close(phw_sock_raw->sockfd);
             phw_sock_raw->sockfd = 0;
@@ -201,12 +210,12 @@ int hw_device_sock_raw_open(struct hw_sock_raw *phw_sock_raw, struct ec *pec, co
     }
 
     if (ret == EC_OK) {
-        ec_log(10, "HW_OPEN", "binding raw socket to %s\n", devname);
+        ec_log(10, "HW_OPEN", "binding raw socket to %s\n", ifname);
 
         (void)memset(&ifr, 0, sizeof(ifr));
-        size_t copy_len = LEC_MIN(strlen(devname), IFNAMSIZ - 1);
+        size_t copy_len = LEC_MIN(strlen(ifname), IFNAMSIZ - 1);
         (void)memset(ifr.ifr_name, 0, IFNAMSIZ);
-        (void)memcpy(ifr.ifr_name, devname, copy_len);
+        (void)memcpy(ifr.ifr_name, ifname, copy_len);
         ioctl(phw_sock_raw->sockfd, SIOCGIFMTU, &ifr);
         phw_sock_raw->common.mtu_size = ifr.ifr_mtu;
         ec_log(10, "hw_open", "got mtu size %d\n", phw_sock_raw->common.mtu_size);
@@ -220,7 +229,10 @@ int hw_device_sock_raw_open(struct hw_sock_raw *phw_sock_raw, struct ec *pec, co
         bind(phw_sock_raw->sockfd, (struct sockaddr *) &sll, sizeof(sll));
     }
 
-    if (ret == EC_OK) {
+    if ((ret == EC_OK) && (phw_sock_raw->polling_mode == OSAL_TRUE)) {
+        ec_log(10, "HW_OPEN", "using polling mode, rx timeout %" PRIu64 " ns\n", phw_sock_raw->rx_timeout_ns);
+        phw_sock_raw->common.rx_polling = OSAL_TRUE;
+    } else if (ret == EC_OK) {
         phw_sock_raw->rxthreadrunning = 1;
         osal_task_attr_t attr;
         attr.policy = OSAL_SCHED_POLICY_FIFO;
@@ -244,8 +256,10 @@ int hw_device_sock_raw_close(struct hw_common *phw) {
 
     struct hw_sock_raw *phw_sock_raw = container_of(phw, struct hw_sock_raw, common);
     
-    phw_sock_raw->rxthreadrunning = 0;
-    osal_task_join(&phw_sock_raw->rxthread, NULL);
+    if (phw_sock_raw->rxthreadrunning != 0) {
+        phw_sock_raw->rxthreadrunning = 0;
+        osal_task_join(&phw_sock_raw->rxthread, NULL);
+    }
 
     close(phw_sock_raw->sockfd);
 
@@ -265,6 +279,10 @@ int hw_device_sock_raw_recv(struct hw_common *phw) {
     struct hw_sock_raw *phw_sock_raw = container_of(phw, struct hw_sock_raw, common);
     ec_frame_t *pframe = (ec_frame_t *) &phw_sock_raw->recv_frame;
 
+    if (phw_sock_raw->polling_mode == OSAL_TRUE) {
+        return EC_ERROR_HW_NOT_SUPPORTED;
+    }
+
     // using tradional recv function
     osal_ssize_t bytesrx = recv(phw_sock_raw->sockfd, pframe, EC_ETH_FRAME_LEN, 0);
 
@@ -275,6 +293,27 @@ int hw_device_sock_raw_recv(struct hw_common *phw) {
     return EC_OK;
 }
 
+//! Receive all pending frames without blocking.
+/*!
+ * \param[in]   phw         Pointer to hw handle. 
+ *
+ * \return Number of received frames which answered sent frames.
+ */
+static osal_size_t hw_device_sock_raw_rx_once(struct hw_common *phw) {
+    struct hw_sock_raw *phw_sock_raw = container_of(phw, struct hw_sock_raw, common);
+    // cppcheck-suppress misra-c2012-11.3
+    ec_frame_t *pframe = (ec_frame_t *) &phw_sock_raw->recv_frame;
+    osal_size_t received = 0u;
+
+    while (recv(phw_sock_raw->sockfd, pframe, EC_ETH_FRAME_LEN, MSG_DONTWAIT) > 0) {
+        if (hw_process_rx_frame(phw, pframe) == OSAL_TRUE) {
+            received++;
+        }
+    }
+
+    return received;
+}
+
 //! receiver thread
 void *hw_device_sock_raw_rx_thread(void *arg) {
     // cppcheck-suppress misra-c2012-11.5
@@ -282,6 +321,9 @@ void *hw_device_sock_raw_rx_thread(void *arg) {
     ec_t *pec = phw_sock_raw->common.pec;
 
     assert(phw_sock_raw != NULL);
+
+    // received frames show up in the cycle timeline
+    (void)ec_trace_register_thread();
     
     osal_task_sched_priority_t rx_prio;
     if (osal_task_get_priority(&phw_sock_raw->rxthread, &rx_prio) != OSAL_OK) {
@@ -295,6 +337,7 @@ void *hw_device_sock_raw_rx_thread(void *arg) {
     }
     
     ec_log(10, "HW_SOCK_RAW_RX", "receive thread stopped\n");
+    ec_trace_unregister_thread();
     
     return NULL;
 }
@@ -362,16 +405,36 @@ int hw_device_sock_raw_send(struct hw_common *phw, ec_frame_t *pframe, pooltype_
         }
 
         ret = EC_ERROR_HW_SEND;
-    }
+    } else if (phw_sock_raw->polling_mode == OSAL_TRUE) {
+        phw_sock_raw->frames_send++;
+    } else {}
 
     return ret;
 }
 
 //! Doing internal stuff when finished sending frames
 /*!
+ * In polling mode the replies to all frames sent are received here.
+ *
  * \param[in]   phw         Pointer to hw handle.
  */
 void hw_device_sock_raw_send_finished(struct hw_common *phw) {
+    assert(phw != NULL);
+
+    ec_t *pec = phw->pec;
+    struct hw_sock_raw *phw_sock_raw = container_of(phw, struct hw_sock_raw, common);
+
+    if ((phw_sock_raw->polling_mode == OSAL_TRUE) && (phw_sock_raw->frames_send > 0u)) {
+        osal_size_t received = hw_device_poll_rx(phw, phw_sock_raw->sockfd, phw_sock_raw->frames_send, 
+                phw_sock_raw->rx_timeout_ns, &phw_sock_raw->rx_predict, hw_device_sock_raw_rx_once);
+
+        if (received < phw_sock_raw->frames_send) {
+            ec_log(1, "HW_RX", "timeout, received %" PRIu64 " of %" PRIu64 " frames.\n", 
+                    (osal_uint64_t)received, (osal_uint64_t)phw_sock_raw->frames_send);
+        }
+
+        phw_sock_raw->frames_send = 0u;
+    }
 }
 
 
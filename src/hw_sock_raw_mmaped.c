@@ -69,6 +69,30 @@
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
+#include <inttypes.h>
+
+//! Number of blocks in RX ring.
+#define SOCK_RAW_MMAPED_RX_BLOCK_NR     64u
+//! Block retire timeout [ms], the kernel minimum. Blocks are small, so they 
+//! usually retire earlier because the next frame of a cycle does not fit.
+#define SOCK_RAW_MMAPED_RX_BLOCK_TOV    1u
+//! Maximum number of frames passed to hw_process_rx_frames at once.
+#define SOCK_RAW_MMAPED_RX_BATCH        32u
+
+#if LEC_SOCK_RAW_MMAPED_RX_BLOCK_RING == 1
+// TPACKET_V3 block ring, frames are visible when their block is retired
+#define SOCK_RAW_MMAPED_TPACKET_VERSION TPACKET_V3
+#define SOCK_RAW_MMAPED_HDRLEN          TPACKET3_HDRLEN
+typedef struct tpacket3_hdr             hw_sock_raw_mmaped_hdr_t;
+#else
+// TPACKET_V2 frame ring, every frame is visible as soon as it is received
+#define SOCK_RAW_MMAPED_TPACKET_VERSION TPACKET_V2
+#define SOCK_RAW_MMAPED_HDRLEN          TPACKET2_HDRLEN
+typedef struct tpacket2_hdr             hw_sock_raw_mmaped_hdr_t;
+#endif
+
+//! Offset of frame data in a TX ring frame.
+#define SOCK_RAW_MMAPED_TX_DATA_OFFSET  (SOCK_RAW_MMAPED_HDRLEN - sizeof(struct sockaddr_ll))
 
 // forward declarations
 int hw_device_sock_raw_mmaped_send(struct hw_common *phw, ec_frame_t *pframe, pooltype_t pool_type);
@@ -120,11 +144,14 @@ int hw_device_sock_raw_mmaped_open(struct hw_sock_raw_mmaped *phw_sock_raw_mmape
     int ret = EC_OK;
     struct ifreq ifr;
     int ifindex;
+    osal_char_t ifname[IFNAMSIZ];
     
     if (try_grant_cap_net_raw_init(pec) == -1) {
         ec_log(10, "hw_open", "grant_cap_net_raw unsuccessfull, maybe we are "
                 "not allowed to open a raw socket\n");
     }
+
+    hw_open(&phw_sock_raw_mmaped->common, pec);
     
     phw_sock_raw_mmaped->common.send = hw_device_sock_raw_mmaped_send;
     phw_sock_raw_mmaped->common.recv = hw_device_sock_raw_mmaped_recv;
@@ -132,6 +159,14 @@ int hw_device_sock_raw_mmaped_open(struct hw_sock_raw_mmaped *phw_sock_raw_mmape
     phw_sock_raw_mmaped->common.get_tx_buffer = hw_device_sock_raw_mmaped_get_tx_buffer;
     phw_sock_raw_mmaped->common.close = hw_device_sock_raw_mmaped_close;
 
+    phw_sock_raw_mmaped->polling_mode = OSAL_FALSE;
+    phw_sock_raw_mmaped->rx_timeout_ns = 100000000u;
+    (void)memset(&phw_sock_raw_mmaped->rx_predict, 0, sizeof(phw_sock_raw_mmaped->rx_predict));
+    phw_sock_raw_mmaped->frames_send = 0u;
+    phw_sock_raw_mmaped->rxthreadrunning = 0;
+    hw_device_parse_options(devname, ifname, sizeof(ifname), 
+            &phw_sock_raw_mmaped->polling_mode, &phw_sock_raw_mmaped->rx_timeout_ns);
+
     // create raw socket connection
     phw_sock_raw_mmaped->sockfd = socket(PF_PACKET, SOCK_RAW, htons(ETH_P_ECAT));
     if (phw_sock_raw_mmaped->sockfd <= 0) {
@@ -139,37 +174,74 @@ int hw_device_sock_raw_mmaped_open(struct hw_sock_raw_mmaped *phw_sock_raw_mmape
         ret = EC_ERROR_UNAVAILABLE;
     }
 
-    phw_sock_raw_mmaped->mmap_packets = 100;
+    phw_sock_raw_mmaped->mmap_packets = LEC_SOCK_RAW_MMAPED_TX_RING_DEPTH;
+    phw_sock_raw_mmaped->tx_pending = 0;
 
     if (ret == EC_OK) {
         int pagesize = getpagesize();
         ec_log(10, "HW_OPEN", "got page size %d bytes\n", pagesize);
 
-        struct tpacket_req tp;
-
-        // tell kernel to export data through mmap()ped ring
-        tp.tp_block_size = phw_sock_raw_mmaped->mmap_packets * pagesize;
-        tp.tp_block_nr   = 1;
-        tp.tp_frame_size = pagesize;
-        tp.tp_frame_nr   = phw_sock_raw_mmaped->mmap_packets;
-        if (setsockopt(phw_sock_raw_mmaped->sockfd, SOL_PACKET, PACKET_RX_RING, (void*)&tp, sizeof(tp)) != 0) {
+        // small blocks, one page holds at least two full ethernet frames
+        phw_sock_raw_mmaped->rx_block_size = pagesize;
+        phw_sock_raw_mmaped->rx_block_nr = SOCK_RAW_MMAPED_RX_BLOCK_NR;
+        phw_sock_raw_mmaped->tx_frame_size = pagesize;
+
+        // tpacket_req3 starts with tpacket_req, V2 ignores the block fields
+        struct tpacket_req3 rx_req;
+        (void)memset(&rx_req, 0, sizeof(rx_req));
+        rx_req.tp_block_size = phw_sock_raw_mmaped->rx_block_size;
+        rx_req.tp_block_nr   = phw_sock_raw_mmaped->rx_block_nr;
+        rx_req.tp_frame_size = TPACKET_ALIGN(SOCK_RAW_MMAPED_HDRLEN + ETH_FRAME_LEN);
+        rx_req.tp_frame_nr   = (rx_req.tp_block_size / rx_req.tp_frame_size) * rx_req.tp_block_nr;
+        rx_req.tp_retire_blk_tov = SOCK_RAW_MMAPED_RX_BLOCK_TOV;
+        phw_sock_raw_mmaped->rx_frame_size = rx_req.tp_frame_size;
+        phw_sock_raw_mmaped->rx_frame_nr = rx_req.tp_frame_nr;
+
+        struct tpacket_req3 tx_req;
+        (void)memset(&tx_req, 0, sizeof(tx_req));
+        tx_req.tp_block_size = phw_sock_raw_mmaped->mmap_packets * pagesize;
+        tx_req.tp_block_nr   = 1;
+        tx_req.tp_frame_size = phw_sock_raw_mmaped->tx_frame_size;
+        tx_req.tp_frame_nr   = phw_sock_raw_mmaped->mmap_packets;
+
+        // tx ring uses the same header version
+        int version = SOCK_RAW_MMAPED_TPACKET_VERSION;
+        if (setsockopt(phw_sock_raw_mmaped->sockfd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0) {
+            ec_log(1, "HW_OPEN", "setsockopt() packet version: %s\n", strerror(errno));
+            ret = EC_ERROR_UNAVAILABLE;
+        } else if (setsockopt(phw_sock_raw_mmaped->sockfd, SOL_PACKET, PACKET_RX_RING, (void*)&rx_req, sizeof(rx_req)) != 0) {
             ec_log(1, "HW_OPEN", "setsockopt() rx ring: %s\n", strerror(errno));
             ret = EC_ERROR_UNAVAILABLE;
-        } else if (setsockopt(phw_sock_raw_mmaped->sockfd, SOL_PACKET, PACKET_TX_RING, (void*)&tp, sizeof(tp)) != 0) {
+        } else if (setsockopt(phw_sock_raw_mmaped->sockfd, SOL_PACKET, PACKET_TX_RING, (void*)&tx_req, sizeof(tx_req)) != 0) {
             ec_log(1, "HW_OPEN", "setsockopt() tx ring: %s\n", strerror(errno));
             ret = EC_ERROR_UNAVAILABLE;
         } else {}
 
         if (ret == EC_OK) {
-            // TODO unmap anywhere
-            phw_sock_raw_mmaped->rx_ring = mmap(0, phw_sock_raw_mmaped->mmap_packets * pagesize * 2, PROT_READ | PROT_WRITE, MAP_SHARED, phw_sock_raw_mmaped->sockfd, 0);
-            phw_sock_raw_mmaped->tx_ring = &phw_sock_raw_mmaped->rx_ring[(phw_sock_raw_mmaped->mmap_packets * pagesize)];
+            osal_size_t rx_size = (osal_size_t)rx_req.tp_block_size * rx_req.tp_block_nr;
+            phw_sock_raw_mmaped->mmap_size = rx_size + ((osal_size_t)tx_req.tp_block_size * tx_req.tp_block_nr);
+            void *ring = mmap(0, phw_sock_raw_mmaped->mmap_size, PROT_READ | PROT_WRITE, MAP_SHARED, phw_sock_raw_mmaped->sockfd, 0);
+            if (ring == MAP_FAILED) {
+                ec_log(1, "HW_OPEN", "mmap() rings: %s\n", strerror(errno));
+                phw_sock_raw_mmaped->rx_ring = NULL;
+                ret = EC_ERROR_UNAVAILABLE;
+            } else {
+                phw_sock_raw_mmaped->rx_ring = (osal_char_t *)ring;
+                phw_sock_raw_mmaped->tx_ring = &phw_sock_raw_mmaped->rx_ring[rx_size];
+            }
 
             phw_sock_raw_mmaped->rx_ring_offset = 0;
             phw_sock_raw_mmaped->tx_ring_offset = 0;
         }
     }
 
+    if (ret == EC_OK) {
+        phw_sock_raw_mmaped->rx_busy_poll = hw_device_cpu_isolated(cpumask);
+        if (phw_sock_raw_mmaped->rx_busy_poll == OSAL_TRUE) {
+            ec_log(10, "HW_OPEN", "receive thread pinned to isolated cpu, busy-polling rx ring\n");
+        }
+    }
+
     if (ret == EC_OK) { 
         int i;
 
@@ -184,11 +256,17 @@ int hw_device_sock_raw_mmaped_open(struct hw_sock_raw_mmaped *phw_sock_raw_mmape
         i = 1;
         setsockopt(phw_sock_raw_mmaped->sockfd, SOL_SOCKET, SO_DONTROUTE, &i, sizeof(i));
 
+        // hand frames directly to the driver, we do not need traffic control
+        i = 1;
+        if (setsockopt(phw_sock_raw_mmaped->sockfd, SOL_PACKET, PACKET_QDISC_BYPASS, &i, sizeof(i)) != 0) {
+            ec_log(10, "HW_OPEN", "setsockopt() qdisc bypass: %s\n", strerror(errno));
+        }
+
         // attach to out network interface
-        (void)strcpy(ifr.ifr_name, devname);
+        (void)strcpy(ifr.ifr_name, ifname);
         ioctl(phw_sock_raw_mmaped->sockfd, SIOCGIFINDEX, &ifr);
         ifindex = ifr.ifr_ifindex;
-        (void)strcpy(ifr.ifr_name, devname);
+        (void)strcpy(ifr.ifr_name, ifname);
         ifr.ifr_flags = 0;
         ioctl(phw_sock_raw_mmaped->sockfd, SIOCGIFFLAGS, &ifr);
 
@@ -196,7 +274,7 @@ int hw_device_sock_raw_mmaped_open(struct hw_sock_raw_mmaped *phw_sock_raw_mmape
         ifr.ifr_flags = ifr.ifr_flags | IFF_PROMISC | IFF_BROADCAST | IFF_UP;
         /*int ret =*/ ioctl(phw_sock_raw_mmaped->sockfd, SIOCSIFFLAGS, &ifr);
         //    if (ret != 0) {
-        //        ec_log(1, "HW_OPEN", "error setting interface %s: %s\n", devname, strerror(errno));
+        //        ec_log(1, "HW_OPEN", "error setting interface %s: %s\n", ifname, strerror(errno));
         //        goto error_exit;
         //    }
         
@@ -206,10 +284,10 @@ int hw_device_sock_raw_mmaped_open(struct hw_sock_raw_mmaped *phw_sock_raw_mmape
             ioctl(phw_sock_raw_mmaped->sockfd, SIOCGIFFLAGS, &ifr);
             iff_running = (ifr.ifr_flags & IFF_RUNNING) == 0 ? OSAL_FALSE : OSAL_TRUE;
             if (iff_running == OSAL_TRUE) {
-                ec_log(10, "HW_OPEN", "interface %s is RUNNING now, wait additional 2 sec for link to be established!\n", devname);
+                ec_log(10, "HW_OPEN", "interface %s is RUNNING now, wait additional 2 sec for link to be established!\n", ifname);
                 osal_sleep(1000000000);
             } else {
-                ec_log(10, "HW_OPEN", "interface %s is not RUNNING, waiting ...\n", devname);
+                ec_log(10, "HW_OPEN", "interface %s is not RUNNING, waiting ...\n", ifname);
             }
             
             if (osal_timer_expired(&up_timeout) == OSAL_ERR_TIMEOUT) {
@@ -220,7 +298,7 @@ int hw_device_sock_raw_mmaped_open(struct hw_sock_raw_mmaped *phw_sock_raw_mmape
         }
 
         if (iff_running == OSAL_FALSE) {
-            ec_log(1, "HW_OPEN", "unable to bring interface %s UP!\n", devname);
+            ec_log(1, "HW_OPEN", "unable to bring interface %s UP!\n", ifname);
             ret = EC_ERROR_UNAVAILABLE;
             close(phw_sock_raw_mmaped->sockfd);
             phw_sock_raw_mmaped->sockfd = 0;
@@ -228,12 +306,12 @@ int hw_device_sock_raw_mmaped_open(struct hw_sock_raw_mmaped *phw_sock_raw_mmape
     }
 
     if (ret == EC_OK) {
-        ec_log(10, "HW_OPEN", "binding raw socket to %s\n", devname);
+        ec_log(10, "HW_OPEN", "binding raw socket to %s\n", ifname);
 
         (void)memset(&ifr, 0, sizeof(ifr));
-        size_t copy_len = LEC_MIN(strlen(devname), IFNAMSIZ - 1);
+        size_t copy_len = LEC_MIN(strlen(ifname), IFNAMSIZ - 1);
         (void)memset(ifr.ifr_name, 0, IFNAMSIZ);
-        (void)memcpy(ifr.ifr_name, devname, copy_len);
+        (void)memcpy(ifr.ifr_name, ifname, copy_len);
         ioctl(phw_sock_raw_mmaped->sockfd, SIOCGIFMTU, &ifr);
         phw_sock_raw_mmaped->common.mtu_size = ifr.ifr_mtu;
         ec_log(10, "hw_open", "got mtu size %d\n", phw_sock_raw_mmaped->common.mtu_size);
@@ -247,7 +325,10 @@ int hw_device_sock_raw_mmaped_open(struct hw_sock_raw_mmaped *phw_sock_raw_mmape
         bind(phw_sock_raw_mmaped->sockfd, (struct sockaddr *) &sll, sizeof(sll));
     }
     
-    if (ret == EC_OK) {
+    if ((ret == EC_OK) && (phw_sock_raw_mmaped->polling_mode == OSAL_TRUE)) {
+        ec_log(10, "HW_OPEN", "using polling mode, rx timeout %" PRIu64 " ns\n", phw_sock_raw_mmaped->rx_timeout_ns);
+        phw_sock_raw_mmaped->common.rx_polling = OSAL_TRUE;
+    } else if (ret == EC_OK) {
         phw_sock_raw_mmaped->rxthreadrunning = 1;
         osal_task_attr_t attr;
         attr.policy = OSAL_SCHED_POLICY_FIFO;
@@ -271,14 +352,131 @@ int hw_device_sock_raw_mmaped_close(struct hw_common *phw) {
 
     struct hw_sock_raw_mmaped *phw_sock_raw_mmaped = container_of(phw, struct hw_sock_raw_mmaped, common);
     
-    phw_sock_raw_mmaped->rxthreadrunning = 0;
-    osal_task_join(&phw_sock_raw_mmaped->rxthread, NULL);
+    if (phw_sock_raw_mmaped->rxthreadrunning != 0) {
+        phw_sock_raw_mmaped->rxthreadrunning = 0;
+        osal_task_join(&phw_sock_raw_mmaped->rxthread, NULL);
+    }
+
+    if (phw_sock_raw_mmaped->rx_ring != NULL) {
+        (void)munmap(phw_sock_raw_mmaped->rx_ring, phw_sock_raw_mmaped->mmap_size);
+        phw_sock_raw_mmaped->rx_ring = NULL;
+        phw_sock_raw_mmaped->tx_ring = NULL;
+    }
     
     close(phw_sock_raw_mmaped->sockfd);
 
     return ret;
 }
 
+#if LEC_SOCK_RAW_MMAPED_RX_BLOCK_RING == 1
+//! Get current RX ring block.
+static struct tpacket_block_desc *hw_sock_raw_mmaped_rx_block(struct hw_sock_raw_mmaped *phw_sock_raw_mmaped) {
+    // cppcheck-suppress misra-c2012-11.3
+    return (struct tpacket_block_desc *)(&phw_sock_raw_mmaped->rx_ring[
+            (phw_sock_raw_mmaped->rx_ring_offset * phw_sock_raw_mmaped->rx_block_size)]);
+}
+
+//! Check if current RX ring block was retired by kernel.
+static osal_bool_t hw_device_sock_raw_mmaped_rx_ready(struct hw_sock_raw_mmaped *phw_sock_raw_mmaped) {
+    struct tpacket_block_desc *pbd = hw_sock_raw_mmaped_rx_block(phw_sock_raw_mmaped);
+    return ((__atomic_load_n(&pbd->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) != 0u) ? OSAL_TRUE : OSAL_FALSE;
+}
+
+//! Process all retired RX ring blocks without blocking.
+/*!
+ * \param[in]   phw         Pointer to hw handle. 
+ *
+ * \return Number of received frames which answered sent frames.
+ */
+static osal_size_t hw_device_sock_raw_mmaped_rx_once(struct hw_common *phw) {
+    struct hw_sock_raw_mmaped *phw_sock_raw_mmaped = container_of(phw, struct hw_sock_raw_mmaped, common);
+    struct tpacket_block_desc *pbd = hw_sock_raw_mmaped_rx_block(phw_sock_raw_mmaped);
+    osal_size_t received = 0u;
+
+    while ((__atomic_load_n(&pbd->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) != 0u) {
+        ec_frame_t *frames[SOCK_RAW_MMAPED_RX_BATCH];
+        osal_size_t cnt = 0u;
+
+        // cppcheck-suppress misra-c2012-11.3
+        struct tpacket3_hdr *ppd = (struct tpacket3_hdr *)(&((osal_char_t *)pbd)[pbd->hdr.bh1.offset_to_first_pkt]);
+        for (osal_uint32_t i = 0u; i < pbd->hdr.bh1.num_pkts; ++i) {
+            // cppcheck-suppress misra-c2012-11.3
+            frames[cnt++] = (ec_frame_t *)(&((osal_char_t *)ppd)[ppd->tp_mac]);
+            if (cnt == SOCK_RAW_MMAPED_RX_BATCH) {
+                received += hw_process_rx_frames(phw, frames, cnt);
+                cnt = 0u;
+            }
+
+            // cppcheck-suppress misra-c2012-11.3
+            ppd = (struct tpacket3_hdr *)(&((osal_char_t *)ppd)[ppd->tp_next_offset]);
+        }
+
+        received += hw_process_rx_frames(phw, frames, cnt);
+
+        // return block to kernel
+        __atomic_store_n(&pbd->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+        phw_sock_raw_mmaped->rx_ring_offset = (phw_sock_raw_mmaped->rx_ring_offset + 1) % phw_sock_raw_mmaped->rx_block_nr;
+        pbd = hw_sock_raw_mmaped_rx_block(phw_sock_raw_mmaped);
+    }
+
+    return received;
+}
+#else
+//! Get RX ring frame header.
+static struct tpacket2_hdr *hw_sock_raw_mmaped_rx_frame(struct hw_sock_raw_mmaped *phw_sock_raw_mmaped, osal_off_t idx) {
+    osal_uint32_t per_block = phw_sock_raw_mmaped->rx_block_size / phw_sock_raw_mmaped->rx_frame_size;
+
+    // cppcheck-suppress misra-c2012-11.3
+    return (struct tpacket2_hdr *)(&phw_sock_raw_mmaped->rx_ring[
+            ((idx / per_block) * phw_sock_raw_mmaped->rx_block_size) + 
+            ((idx % per_block) * phw_sock_raw_mmaped->rx_frame_size)]);
+}
+
+//! Check if current RX ring frame was received.
+static osal_bool_t hw_device_sock_raw_mmaped_rx_ready(struct hw_sock_raw_mmaped *phw_sock_raw_mmaped) {
+    struct tpacket2_hdr *header = hw_sock_raw_mmaped_rx_frame(phw_sock_raw_mmaped, phw_sock_raw_mmaped->rx_ring_offset);
+    return ((__atomic_load_n(&header->tp_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) != 0u) ? OSAL_TRUE : OSAL_FALSE;
+}
+
+//! Process all received RX ring frames without blocking.
+/*!
+ * \param[in]   phw         Pointer to hw handle. 
+ *
+ * \return Number of received frames which answered sent frames.
+ */
+static osal_size_t hw_device_sock_raw_mmaped_rx_once(struct hw_common *phw) {
+    struct hw_sock_raw_mmaped *phw_sock_raw_mmaped = container_of(phw, struct hw_sock_raw_mmaped, common);
+    struct tpacket2_hdr *header = hw_sock_raw_mmaped_rx_frame(phw_sock_raw_mmaped, phw_sock_raw_mmaped->rx_ring_offset);
+    osal_size_t received = 0u;
+
+    while ((__atomic_load_n(&header->tp_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) != 0u) {
+        ec_frame_t *frames[SOCK_RAW_MMAPED_RX_BATCH];
+        osal_off_t first = phw_sock_raw_mmaped->rx_ring_offset;
+        osal_size_t cnt = 0u;
+
+        // collect all consecutive frames already received
+        do {
+            // cppcheck-suppress misra-c2012-11.3
+            frames[cnt++] = (ec_frame_t *)(&((osal_char_t *)header)[header->tp_mac]);
+            phw_sock_raw_mmaped->rx_ring_offset = (phw_sock_raw_mmaped->rx_ring_offset + 1) % phw_sock_raw_mmaped->rx_frame_nr;
+            header = hw_sock_raw_mmaped_rx_frame(phw_sock_raw_mmaped, phw_sock_raw_mmaped->rx_ring_offset);
+        } while (   (cnt < SOCK_RAW_MMAPED_RX_BATCH) && 
+                    ((__atomic_load_n(&header->tp_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) != 0u));
+
+        received += hw_process_rx_frames(phw, frames, cnt);
+
+        // return frames to kernel
+        for (osal_size_t i = 0u; i < cnt; ++i) {
+            struct tpacket2_hdr *done = hw_sock_raw_mmaped_rx_frame(phw_sock_raw_mmaped, 
+                    (first + (osal_off_t)i) % phw_sock_raw_mmaped->rx_frame_nr);
+            __atomic_store_n(&done->tp_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+        }
+    }
+
+    return received;
+}
+#endif
+
 //! Receive a frame from an EtherCAT hw device.
 /*!
  * \param[in]   phw         Pointer to hw handle. 
@@ -290,33 +488,22 @@ int hw_device_sock_raw_mmaped_recv(struct hw_common *phw) {
 
     struct hw_sock_raw_mmaped *phw_sock_raw_mmaped = container_of(phw, struct hw_sock_raw_mmaped, common);
 
-    // using kernel mapped receive buffers
-    // wait for received, non-processed packet
-    struct pollfd pollset;
-    pollset.fd = phw_sock_raw_mmaped->sockfd;
-    pollset.events = POLLIN;
-    pollset.revents = 0;
-    int ret = poll(&pollset, 1, 1);
-    if (ret > 0) {
-        int pagesize = getpagesize();
-
-        struct tpacket_hdr *header;
-        for (
-                // cppcheck-suppress misra-c2012-11.3
-                header = (struct tpacket_hdr *)(&phw_sock_raw_mmaped->rx_ring[(phw_sock_raw_mmaped->rx_ring_offset * pagesize)]);
-                header->tp_status & TP_STATUS_USER; 
-                // cppcheck-suppress misra-c2012-11.3
-                header = (struct tpacket_hdr *)(&phw_sock_raw_mmaped->rx_ring[(phw_sock_raw_mmaped->rx_ring_offset * pagesize)])) 
-        {
-            // cppcheck-suppress misra-c2012-11.3
-            ec_frame_t *real_frame = (ec_frame_t *)(&((osal_char_t *)header)[header->tp_mac]);
-            hw_process_rx_frame(phw, real_frame);
+    if (phw_sock_raw_mmaped->polling_mode == OSAL_TRUE) {
+        return EC_ERROR_HW_NOT_SUPPORTED;
+    }
 
-            header->tp_status = 0;
-            phw_sock_raw_mmaped->rx_ring_offset = (phw_sock_raw_mmaped->rx_ring_offset + 1) % phw_sock_raw_mmaped->mmap_packets;
-        }           
+    // using kernel mapped receive ring, wait for frames if not busy-polling
+    if (    (phw_sock_raw_mmaped->rx_busy_poll == OSAL_FALSE) && 
+            (hw_device_sock_raw_mmaped_rx_ready(phw_sock_raw_mmaped) == OSAL_FALSE)) {
+        struct pollfd pollset;
+        pollset.fd = phw_sock_raw_mmaped->sockfd;
+        pollset.events = POLLIN;
+        pollset.revents = 0;
+        (void)poll(&pollset, 1, 1);
     }
 
+    (void)hw_device_sock_raw_mmaped_rx_once(phw);
+
     return EC_OK;
 }
 
@@ -327,6 +514,9 @@ void *hw_device_sock_raw_mmaped_rx_thread(void *arg) {
     ec_t *pec = phw_sock_raw_mmaped->common.pec;
 
     assert(phw_sock_raw_mmaped != NULL);
+
+    // received frames show up in the cycle timeline
+    (void)ec_trace_register_thread();
     
     osal_task_sched_priority_t rx_prio;
     if (osal_task_get_priority(&phw_sock_raw_mmaped->rxthread, &rx_prio) != OSAL_OK) {
@@ -340,13 +530,36 @@ void *hw_device_sock_raw_mmaped_rx_thread(void *arg) {
     }
     
     ec_log(10, "HW_SOCK_RAW_MMAPED_RX", "receive thread stopped\n");
+    ec_trace_unregister_thread();
     
     return NULL;
 }
 
 
-static struct tpacket_hdr *hw_get_next_tx_buffer(struct hw_common *phw) {
-    struct tpacket_hdr *header;
+//! Notify kernel about frames pending in TX ring.
+/*!
+ * \param[in]   phw_sock_raw_mmaped     Pointer to sock_raw_mmaped hw handle.
+ *
+ * \return 0 or negative error code
+ */
+static int hw_device_sock_raw_mmaped_kick(struct hw_sock_raw_mmaped *phw_sock_raw_mmaped) {
+    int ret = EC_OK;
+    ec_t *pec = phw_sock_raw_mmaped->common.pec;
+
+    if (phw_sock_raw_mmaped->tx_pending > 0u) {
+        phw_sock_raw_mmaped->tx_pending = 0u;
+
+        if (sendto(phw_sock_raw_mmaped->sockfd, NULL, 0, MSG_DONTWAIT, NULL, 0) < 0) {
+            ec_log(1, "HW_TX", "error on sendto: %s\n", strerror(errno));
+            ret = EC_ERROR_HW_SEND;
+        }
+    }
+
+    return ret;
+}
+
+static hw_sock_raw_mmaped_hdr_t *hw_get_next_tx_buffer(struct hw_common *phw) {
+    hw_sock_raw_mmaped_hdr_t *header;
     struct pollfd pollset;
 
     assert(phw != NULL);
@@ -355,13 +568,11 @@ static struct tpacket_hdr *hw_get_next_tx_buffer(struct hw_common *phw) {
     struct hw_sock_raw_mmaped *phw_sock_raw_mmaped = container_of(phw, struct hw_sock_raw_mmaped, common);
 
     // cppcheck-suppress misra-c2012-11.3
-    header = (struct tpacket_hdr *)(&phw_sock_raw_mmaped->tx_ring[(phw_sock_raw_mmaped->tx_ring_offset * getpagesize())]);
+    header = (hw_sock_raw_mmaped_hdr_t *)(&phw_sock_raw_mmaped->tx_ring[(phw_sock_raw_mmaped->tx_ring_offset * phw_sock_raw_mmaped->tx_frame_size)]);
 
-    while (header->tp_status != TP_STATUS_AVAILABLE) {
-        // notify kernel
-        if (send(phw_sock_raw_mmaped->sockfd, NULL, 0, 0) < 0) {
-            ec_log(1, "HW_TX", "error on send: %s\n", strerror(errno));
-        }
+    while (__atomic_load_n(&header->tp_status, __ATOMIC_ACQUIRE) != TP_STATUS_AVAILABLE) {
+        // ring full, notify kernel about frames queued so far
+        (void)hw_device_sock_raw_mmaped_kick(phw_sock_raw_mmaped);
 
         // buffer not available, wait here...
         pollset.fd = phw_sock_raw_mmaped->sockfd;
@@ -394,10 +605,10 @@ int hw_device_sock_raw_mmaped_get_tx_buffer(struct hw_common *phw, ec_frame_t **
     static const osal_uint8_t mac_dest[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
     static const osal_uint8_t mac_src[] = {0x00, 0x30, 0x64, 0x0f, 0x83, 0x35};
 
-    struct tpacket_hdr *header = NULL;
+    hw_sock_raw_mmaped_hdr_t *header = NULL;
     header = hw_get_next_tx_buffer(phw);
     // cppcheck-suppress misra-c2012-11.3
-    pframe = (ec_frame_t *)(&((osal_char_t *)header)[(TPACKET_HDRLEN - sizeof(struct sockaddr_ll))]);
+    pframe = (ec_frame_t *)(&((osal_char_t *)header)[SOCK_RAW_MMAPED_TX_DATA_OFFSET]);
 
     // reset length to send new frame
     (void)memcpy(pframe->mac_dest, mac_dest, 6);
@@ -426,20 +637,17 @@ int hw_device_sock_raw_mmaped_send(struct hw_common *phw, ec_frame_t *pframe, po
     (void)pool_type;
 
     int ret = EC_OK;
-    ec_t *pec = phw->pec;
     struct hw_sock_raw_mmaped *phw_sock_raw_mmaped = container_of(phw, struct hw_sock_raw_mmaped, common);
 
-    // fill header
-    struct tpacket_hdr *header = NULL;
-    header = (struct tpacket_hdr *)(((osal_char_t *)pframe) - sizeof(struct tpacket_hdr));
+    // fill header, kernel is notified in send_finished
+    hw_sock_raw_mmaped_hdr_t *header = NULL;
+    // cppcheck-suppress misra-c2012-11.3
+    header = (hw_sock_raw_mmaped_hdr_t *)(((osal_char_t *)pframe) - SOCK_RAW_MMAPED_TX_DATA_OFFSET);
     header->tp_len = pframe->len;
-    header->tp_status = TP_STATUS_SEND_REQUEST;
-
-    // notify kernel
-    if (send(phw_sock_raw_mmaped->sockfd, NULL, 0, 0) < 0) {
-        ec_log(1, "HW_TX", "error on sendto: %s\n", strerror(errno));
-        ret = EC_ERROR_HW_SEND;
-    }
+    header->tp_snaplen = pframe->len;
+    __atomic_store_n(&header->tp_status, TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+    phw_sock_raw_mmaped->tx_pending++;
+    phw_sock_raw_mmaped->frames_send++;
 
     // increase consumer ring pointer
     phw_sock_raw_mmaped->tx_ring_offset = (phw_sock_raw_mmaped->tx_ring_offset + 1) % phw_sock_raw_mmaped->mmap_packets;
@@ -449,9 +657,30 @@ int hw_device_sock_raw_mmaped_send(struct hw_common *phw, ec_frame_t *pframe, po
 
 //! Doing internal stuff when finished sending frames
 /*!
+ * Notifies the kernel once about all frames queued to the TX ring. In 
+ * polling mode the replies to these frames are received here.
+ *
  * \param[in]   phw         Pointer to hw handle.
  */
 void hw_device_sock_raw_mmaped_send_finished(struct hw_common *phw) {
+    assert(phw != NULL);
+
+    ec_t *pec = phw->pec;
+    struct hw_sock_raw_mmaped *phw_sock_raw_mmaped = container_of(phw, struct hw_sock_raw_mmaped, common);
+
+    (void)hw_device_sock_raw_mmaped_kick(phw_sock_raw_mmaped);
+
+    if ((phw_sock_raw_mmaped->polling_mode == OSAL_TRUE) && (phw_sock_raw_mmaped->frames_send > 0u)) {
+        osal_size_t received = hw_device_poll_rx(phw, phw_sock_raw_mmaped->sockfd, phw_sock_raw_mmaped->frames_send, 
+                phw_sock_raw_mmaped->rx_timeout_ns, &phw_sock_raw_mmaped->rx_predict, hw_device_sock_raw_mmaped_rx_once);
+
+        if (received < phw_sock_raw_mmaped->frames_send) {
+            ec_log(1, "HW_RX", "timeout, received %" PRIu64 " of %" PRIu64 " frames.\n", 
+                    (osal_uint64_t)received, (osal_uint64_t)phw_sock_raw_mmaped->frames_send);
+        }
+    }
+
+    phw_sock_raw_mmaped->frames_send = 0u;
 }
 
 
@@ -103,6 +103,7 @@ int hw_device_stm32_open(struct hw_stm32 *phw_stm32, struct ec *pec) {
     phw_stm32->common.get_tx_buffer = hw_device_stm32_get_tx_buffer;
     phw_stm32->common.close = hw_device_stm32_close;
     phw_stm32->common.mtu_size = 1480;
+    phw_stm32->common.rx_polling = OSAL_TRUE;
 
     phw_stm32->frames_sent = 0;
     memset(&phw_stm32->TxConfig, 0 , sizeof(ETH_TxPacketConfig));
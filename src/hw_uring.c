@@ -0,0 +1,733 @@
+/**
+ * \file hw_uring.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief io_uring hardware access functions
+ *
+ */
+
+/*
+ * This file is part of libethercat.
+ *
+ * libethercat is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * libethercat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with libethercat (LICENSE.LGPL-V3); if not, write 
+ * to the Free Software Foundation, Inc., 51 Franklin Street, Fifth 
+ * Floor, Boston, MA  02110-1301, USA.
+ * 
+ * Please note that the use of the EtherCAT technology, the EtherCAT 
+ * brand name and the EtherCAT logo is only permitted if the property 
+ * rights of Beckhoff Automation GmbH are observed. For further 
+ * information please contact Beckhoff Automation GmbH & Co. KG, 
+ * Hülshorstweg 20, D-33415 Verl, Germany (www.beckhoff.com) or the 
+ * EtherCAT Technology Group, Ostendstraße 196, D-90482 Nuremberg, 
+ * Germany (ETG, www.ethercat.org).
+ *
+ */
+#ifdef HAVE_CONFIG_H
+#include <libethercat/config.h>
+#endif
+
+#include <libethercat/settings.h>
+
+#if LIBETHERCAT_BUILD_DEVICE_URING == 1
+
+#include <libethercat/hw_uring.h>
+#include <libethercat/ec.h>
+#include <libethercat/idx.h>
+#include <libethercat/error_codes.h>
+
+#include <assert.h>
+
+#ifdef LIBETHERCAT_HAVE_NET_IF_H
+#include <net/if.h> 
+#endif
+
+#ifdef LIBETHERCAT_HAVE_ARPA_INET_H
+#include <arpa/inet.h>
+#endif
+
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/if_packet.h>
+#include <linux/io_uring.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+// forward declarations
+int hw_device_uring_send(struct hw_common *phw, ec_frame_t *pframe, pooltype_t pool_type);
+int hw_device_uring_recv(struct hw_common *phw);
+void hw_device_uring_send_finished(struct hw_common *phw);
+int hw_device_uring_get_tx_buffer(struct hw_common *phw, ec_frame_t **ppframe);
+int hw_device_uring_close(struct hw_common *phw);
+
+static void *hw_device_uring_rx_thread(void *arg);
+
+//! Completion types encoded in upper half of user_data.
+#define HW_URING_OP_NOP     0u
+#define HW_URING_OP_RX      1u
+#define HW_URING_OP_TX      2u
+
+#define HW_URING_USER_DATA(op, idx)     ((((osal_uint64_t)(op)) << 32u) | (osal_uint64_t)(idx))
+
+//! Get frame buffer of RX slot.
+#define HW_URING_RX_BUFFER(phw_uring, idx) \
+    (&(phw_uring)->buffers[(idx) * HW_URING_FRAME_SIZE])
+//! Get frame buffer of TX slot.
+#define HW_URING_TX_BUFFER(phw_uring, idx) \
+    (&(phw_uring)->buffers[(HW_URING_RX_FRAMES + (idx)) * HW_URING_FRAME_SIZE])
+
+//! Wrapper for io_uring_setup syscall.
+static int hw_uring_setup(osal_uint32_t entries, struct io_uring_params *p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+//! Wrapper for io_uring_enter syscall.
+static int hw_uring_enter(int ring_fd, osal_uint32_t to_submit, osal_uint32_t min_complete, osal_uint32_t flags) {
+    return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+//! Create io_uring and map submission and completion queues.
+/*!
+ * \param[in]   phw_uring   Pointer to uring hw handle. 
+ *
+ * \return 0 or negative error code
+ */
+static int hw_uring_create(struct hw_uring *phw_uring) {
+    int ret = EC_OK;
+    ec_t *pec = phw_uring->common.pec;
+    struct io_uring_params p;
+
+    (void)memset(&p, 0, sizeof(p));
+    if (phw_uring->sqpoll == OSAL_TRUE) {
+        p.flags = IORING_SETUP_SQPOLL;
+        p.sq_thread_idle = 1000u; // ms before kernel thread goes to sleep
+    }
+
+    phw_uring->ring_fd = hw_uring_setup(HW_URING_ENTRIES, &p);
+    if (phw_uring->ring_fd < 0) {
+        ec_log(1, "HW_OPEN", "io_uring_setup failed: %s\n", strerror(errno));
+        ret = EC_ERROR_UNAVAILABLE;
+    }
+
+    if (ret == EC_OK) {
+        osal_size_t sq_size = p.sq_off.array + (p.sq_entries * sizeof(osal_uint32_t));
+        osal_size_t cq_size = p.cq_off.cqes + (p.cq_entries * sizeof(struct io_uring_cqe));
+
+        if ((p.features & IORING_FEAT_SINGLE_MMAP) != 0u) {
+            sq_size = (sq_size > cq_size) ? sq_size : cq_size;
+        }
+
+        phw_uring->sq.map_size = sq_size;
+        phw_uring->sq.map = mmap(NULL, sq_size, PROT_READ | PROT_WRITE, 
+                MAP_SHARED | MAP_POPULATE, phw_uring->ring_fd, IORING_OFF_SQ_RING);
+        if (phw_uring->sq.map == MAP_FAILED) {
+            phw_uring->sq.map = NULL;
+            ec_log(1, "HW_OPEN", "mapping submission queue failed: %s\n", strerror(errno));
+            ret = EC_ERROR_OUT_OF_MEMORY;
+        } else if ((p.features & IORING_FEAT_SINGLE_MMAP) != 0u) {
+            // completion queue shares mapping, only unmapped once
+            phw_uring->cq.map = NULL;
+            phw_uring->cq.map_size = 0u;
+        } else {
+            phw_uring->cq.map_size = cq_size;
+            phw_uring->cq.map = mmap(NULL, cq_size, PROT_READ | PROT_WRITE, 
+                    MAP_SHARED | MAP_POPULATE, phw_uring->ring_fd, IORING_OFF_CQ_RING);
+            if (phw_uring->cq.map == MAP_FAILED) {
+                phw_uring->cq.map = NULL;
+                ec_log(1, "HW_OPEN", "mapping completion queue failed: %s\n", strerror(errno));
+                ret = EC_ERROR_OUT_OF_MEMORY;
+            }
+        }
+    }
+
+    if (ret == EC_OK) {
+        phw_uring->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+        phw_uring->sqes = mmap(NULL, phw_uring->sqes_size, PROT_READ | PROT_WRITE, 
+                MAP_SHARED | MAP_POPULATE, phw_uring->ring_fd, IORING_OFF_SQES);
+        if (phw_uring->sqes == MAP_FAILED) {
+            phw_uring->sqes = NULL;
+            ec_log(1, "HW_OPEN", "mapping submission queue entries failed: %s\n", strerror(errno));
+            ret = EC_ERROR_OUT_OF_MEMORY;
+        }
+    }
+
+    if (ret == EC_OK) {
+        osal_uint8_t *sq = (osal_uint8_t *)phw_uring->sq.map;
+        osal_uint8_t *cq = (phw_uring->cq.map != NULL) ? (osal_uint8_t *)phw_uring->cq.map : sq;
+
+        // cppcheck-suppress misra-c2012-11.3
+        phw_uring->sq.head = (osal_uint32_t *)&sq[p.sq_off.head];
+        // cppcheck-suppress misra-c2012-11.3
+        phw_uring->sq.tail = (osal_uint32_t *)&sq[p.sq_off.tail];
+        // cppcheck-suppress misra-c2012-11.3
+        phw_uring->sq.flags = (osal_uint32_t *)&sq[p.sq_off.flags];
+        // cppcheck-suppress misra-c2012-11.3
+        phw_uring->sq.array = (osal_uint32_t *)&sq[p.sq_off.array];
+        // cppcheck-suppress misra-c2012-11.3
+        phw_uring->sq.mask = *(osal_uint32_t *)&sq[p.sq_off.ring_mask];
+        phw_uring->sq.entries = NULL;
+
+        // cppcheck-suppress misra-c2012-11.3
+        phw_uring->cq.head = (osal_uint32_t *)&cq[p.cq_off.head];
+        // cppcheck-suppress misra-c2012-11.3
+        phw_uring->cq.tail = (osal_uint32_t *)&cq[p.cq_off.tail];
+        phw_uring->cq.flags = NULL;
+        phw_uring->cq.array = NULL;
+        phw_uring->cq.entries = &cq[p.cq_off.cqes];
+        // cppcheck-suppress misra-c2012-11.3
+        phw_uring->cq.mask = *(osal_uint32_t *)&cq[p.cq_off.ring_mask];
+
+        phw_uring->sq_tail = *phw_uring->sq.tail;
+    }
+
+    return ret;
+}
+
+//! Get next free submission queue entry.
+/*!
+ * Has to be called with sq_lock held. The entry is published to the 
+ * kernel with the next \link hw_uring_flush \endlink.
+ *
+ * \param[in]   phw_uring   Pointer to uring hw handle. 
+ *
+ * \return Pointer to cleared entry or NULL if queue is full.
+ */
+static struct io_uring_sqe *hw_uring_get_sqe(struct hw_uring *phw_uring) {
+    struct io_uring_sqe *sqe = NULL;
+    osal_uint32_t head = __atomic_load_n(phw_uring->sq.head, __ATOMIC_ACQUIRE);
+
+    if ((phw_uring->sq_tail - head) <= phw_uring->sq.mask) {
+        osal_uint32_t idx = phw_uring->sq_tail & phw_uring->sq.mask;
+        sqe = &((struct io_uring_sqe *)phw_uring->sqes)[idx];
+        (void)memset(sqe, 0, sizeof(*sqe));
+        phw_uring->sq.array[idx] = idx;
+        phw_uring->sq_tail++;
+        phw_uring->sq_pending++;
+    }
+
+    return sqe;
+}
+
+//! Submit all queued entries to the kernel.
+/*!
+ * Has to be called with sq_lock held. Without SQPOLL this is exactly one 
+ * io_uring_enter syscall, with SQPOLL a syscall is only needed if the 
+ * kernel thread went to sleep.
+ *
+ * \param[in]   phw_uring   Pointer to uring hw handle. 
+ *
+ * \return 0 or negative error code
+ */
+static int hw_uring_flush(struct hw_uring *phw_uring) {
+    int ret = EC_OK;
+    ec_t *pec = phw_uring->common.pec;
+
+    if (phw_uring->sq_pending > 0u) {
+        phw_uring->sq_pending = 0u;
+        phw_uring->rx_queued = 0u;
+        __atomic_store_n(phw_uring->sq.tail, phw_uring->sq_tail, __ATOMIC_RELEASE);
+
+        if (phw_uring->sqpoll == OSAL_FALSE) {
+            // also resubmits entries left over from a previous failed enter
+            osal_uint32_t to_submit = phw_uring->sq_tail - *phw_uring->sq.head;
+            if (    (hw_uring_enter(phw_uring->ring_fd, to_submit, 0u, 0u) < 0) &&
+                    (errno != EAGAIN) && (errno != EBUSY) && (errno != EINTR)) {
+                ec_log(1, "HW_TX", "error on io_uring_enter: %s\n", strerror(errno));
+                ret = EC_ERROR_HW_SEND;
+            }
+        } else {
+            // tail store has to be visible before checking the wakeup flag
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            if ((__atomic_load_n(phw_uring->sq.flags, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP) != 0u) {
+                (void)hw_uring_enter(phw_uring->ring_fd, 0u, 0u, IORING_ENTER_SQ_WAKEUP);
+            }
+        }
+    }
+
+    return ret;
+}
+
+//! Queue a read to RX slot.
+/*!
+ * Has to be called with sq_lock held.
+ *
+ * \param[in]   phw_uring   Pointer to uring hw handle. 
+ * \param[in]   idx         RX slot index.
+ */
+static void hw_uring_queue_read(struct hw_uring *phw_uring, osal_uint32_t idx) {
+    ec_t *pec = phw_uring->common.pec;
+    struct io_uring_sqe *sqe = hw_uring_get_sqe(phw_uring);
+
+    if (sqe == NULL) {
+        ec_log(1, "HW_RX", "submission queue full, rx slot %u lost\n", idx);
+    } else {
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = phw_uring->fd;
+        sqe->addr = (osal_uint64_t)(osal_size_t)HW_URING_RX_BUFFER(phw_uring, idx);
+        sqe->len = HW_URING_FRAME_SIZE;
+        sqe->user_data = HW_URING_USER_DATA(HW_URING_OP_RX, idx);
+        phw_uring->rx_queued++;
+    }
+}
+
+//! Open EtherCAT network interface as raw socket.
+/*!
+ * \param[in]   phw_uring   Pointer to uring hw handle. 
+ * \param[in]   devname     Null-terminated string to network interface name.
+ *
+ * \return 0 or negative error code
+ */
+static int hw_uring_open_socket(struct hw_uring *phw_uring, const osal_char_t *devname) {
+    int ret = EC_OK;
+    ec_t *pec = phw_uring->common.pec;
+    struct ifreq ifr;
+    int ifindex = (int)if_nametoindex(devname);
+
+    if (ifindex == 0) {
+        ec_log(1, "HW_OPEN", "unknown interface %s: %s\n", devname, strerror(errno));
+        ret = EC_ERROR_UNAVAILABLE;
+    }
+
+    if (ret == EC_OK) {
+        phw_uring->fd = socket(PF_PACKET, SOCK_RAW, htons(ETH_P_ECAT));
+        if (phw_uring->fd < 0) {
+            ec_log(1, "HW_OPEN", "socket error on opening SOCK_RAW: %s\n", strerror(errno));
+            ret = EC_ERROR_UNAVAILABLE;
+        }
+    }
+
+    if (ret == EC_OK) {
+        int i = 1;
+        (void)setsockopt(phw_uring->fd, SOL_SOCKET, SO_DONTROUTE, &i, sizeof(i));
+#ifdef PACKET_QDISC_BYPASS
+        (void)setsockopt(phw_uring->fd, SOL_PACKET, PACKET_QDISC_BYPASS, &i, sizeof(i));
+#endif
+
+        (void)memset(&ifr, 0, sizeof(ifr));
+        (void)strncpy(ifr.ifr_name, devname, IFNAMSIZ - 1);
+        if (ioctl(phw_uring->fd, SIOCGIFFLAGS, &ifr) == 0) {
+            ifr.ifr_flags = ifr.ifr_flags | IFF_PROMISC | IFF_BROADCAST | IFF_UP;
+            (void)ioctl(phw_uring->fd, SIOCSIFFLAGS, &ifr);
+        }
+
+        if (ioctl(phw_uring->fd, SIOCGIFMTU, &ifr) == 0) {
+            phw_uring->common.mtu_size = ifr.ifr_mtu;
+        }
+
+        // frame has to fit into one buffer
+        if ((phw_uring->common.mtu_size == 0u) || (phw_uring->common.mtu_size > 1500u)) {
+            phw_uring->common.mtu_size = 1500u;
+        }
+        ec_log(10, "HW_OPEN", "got mtu size %d\n", phw_uring->common.mtu_size);
+
+        ec_log(10, "HW_OPEN", "binding raw socket to %s\n", devname);
+        struct sockaddr_ll sll;
+        (void)memset(&sll, 0, sizeof(sll));
+        sll.sll_family = AF_PACKET;
+        sll.sll_ifindex = ifindex;
+        sll.sll_protocol = htons(ETH_P_ECAT);
+        if (bind(phw_uring->fd, (struct sockaddr *) &sll, sizeof(sll)) < 0) {
+            ec_log(1, "HW_OPEN", "binding raw socket failed: %s\n", strerror(errno));
+            ret = EC_ERROR_UNAVAILABLE;
+        }
+    }
+
+    return ret;
+}
+
+//! Opens EtherCAT hw device.
+/*!
+ * \param[in]   phw_uring   Pointer to uring hw handle. 
+ * \param[in]   pec         Pointer to master struct.
+ * \param[in]   devname     Null-terminated string to EtherCAT hw device name.
+ * \param[in]   prio        Priority for receiver thread.
+ * \param[in]   cpu_mask    CPU mask for receiver thread.
+ * \param[in]   sqpoll      Use kernel submission queue polling thread.
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_uring_open(struct hw_uring *phw_uring, ec_t *pec, const osal_char_t *devname, 
+        int prio, int cpumask, osal_bool_t sqpoll) 
+{
+    assert(phw_uring != NULL);
+    assert(devname != NULL);
+
+    int ret = EC_OK;
+
+    hw_open(&phw_uring->common, pec);
+
+    phw_uring->common.send = hw_device_uring_send;
+    phw_uring->common.recv = hw_device_uring_recv;
+    phw_uring->common.send_finished = hw_device_uring_send_finished;
+    phw_uring->common.get_tx_buffer = hw_device_uring_get_tx_buffer;
+    phw_uring->common.close = hw_device_uring_close;
+
+    phw_uring->fd = -1;
+    phw_uring->ring_fd = -1;
+    (void)memset(&phw_uring->sq, 0, sizeof(phw_uring->sq));
+    (void)memset(&phw_uring->cq, 0, sizeof(phw_uring->cq));
+    phw_uring->sqes = NULL;
+    phw_uring->sq_tail = 0u;
+    phw_uring->sq_pending = 0u;
+    phw_uring->rx_queued = 0u;
+    phw_uring->sqpoll = sqpoll;
+    phw_uring->tx_next = 0u;
+    (void)memset(&phw_uring->tx_busy[0], 0, sizeof(phw_uring->tx_busy));
+    phw_uring->rxthreadrunning = 0;
+
+    (void)osal_mutex_init(&phw_uring->sq_lock, NULL);
+
+    phw_uring->buffers = mmap(NULL, (HW_URING_RX_FRAMES + HW_URING_TX_FRAMES) * HW_URING_FRAME_SIZE, 
+            PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (phw_uring->buffers == MAP_FAILED) {
+        phw_uring->buffers = NULL;
+        ec_log(1, "HW_OPEN", "allocating frame buffers failed: %s\n", strerror(errno));
+        ret = EC_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (ret == EC_OK) {
+        if (devname[0] == '/') {
+            ec_log(10, "HW_OPEN", "opening device file %s\n", devname);
+            phw_uring->fd = open(devname, O_RDWR | O_NONBLOCK, 0644);
+            if (phw_uring->fd < 0) {
+                ec_log(1, "HW_OPEN", "error opening %s: %s\n", devname, strerror(errno));
+                ret = EC_ERROR_UNAVAILABLE;
+            } else {
+                phw_uring->common.mtu_size = 1480;
+            }
+        } else {
+            ret = hw_uring_open_socket(phw_uring, devname);
+        }
+    }
+
+    if (ret == EC_OK) {
+        ret = hw_uring_create(phw_uring);
+    }
+
+    if (ret == EC_OK) {
+        ec_log(10, "HW_OPEN", "io_uring created%s\n", sqpoll == OSAL_TRUE ? " with SQPOLL" : "");
+
+        // arm all reads, they are re-armed after completion
+        osal_mutex_lock(&phw_uring->sq_lock);
+        for (osal_uint32_t i = 0u; i < HW_URING_RX_FRAMES; ++i) {
+            hw_uring_queue_read(phw_uring, i);
+        }
+        ret = hw_uring_flush(phw_uring);
+        osal_mutex_unlock(&phw_uring->sq_lock);
+    }
+    
+    if (ret == EC_OK) {
+        phw_uring->rxthreadrunning = 1;
+        osal_task_attr_t attr;
+        attr.policy = OSAL_SCHED_POLICY_FIFO;
+        attr.priority = prio;
+        attr.affinity = cpumask;
+        (void)strcpy(&attr.task_name[0], "ecat.rx");
+        osal_task_create(&phw_uring->rxthread, &attr, hw_device_uring_rx_thread, phw_uring);
+    } else {
+        (void)hw_device_uring_close(&phw_uring->common);
+    }
+
+    return ret;
+}
+
+//! Close hardware layer
+/*!
+ * \param[in]   phw         Pointer to hw handle.
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_uring_close(struct hw_common *phw) {
+    int ret = 0;
+
+    struct hw_uring *phw_uring = container_of(phw, struct hw_uring, common);
+    
+    if (phw_uring->rxthreadrunning != 0) {
+        phw_uring->rxthreadrunning = 0;
+
+        // wake up receiver thread waiting for completions
+        osal_mutex_lock(&phw_uring->sq_lock);
+        struct io_uring_sqe *sqe = hw_uring_get_sqe(phw_uring);
+        if (sqe != NULL) {
+            sqe->opcode = IORING_OP_NOP;
+            sqe->user_data = HW_URING_USER_DATA(HW_URING_OP_NOP, 0u);
+        }
+        (void)hw_uring_flush(phw_uring);
+        osal_mutex_unlock(&phw_uring->sq_lock);
+
+        osal_task_join(&phw_uring->rxthread, NULL);
+    }
+
+    // closing the ring cancels all pending reads
+    if (phw_uring->ring_fd >= 0) { close(phw_uring->ring_fd); phw_uring->ring_fd = -1; }
+
+    if (phw_uring->sqes != NULL) {
+        (void)munmap(phw_uring->sqes, phw_uring->sqes_size);
+        phw_uring->sqes = NULL;
+    }
+    if (phw_uring->cq.map != NULL) {
+        (void)munmap(phw_uring->cq.map, phw_uring->cq.map_size);
+        phw_uring->cq.map = NULL;
+    }
+    if (phw_uring->sq.map != NULL) {
+        (void)munmap(phw_uring->sq.map, phw_uring->sq.map_size);
+        phw_uring->sq.map = NULL;
+    }
+
+    if (phw_uring->fd >= 0) { close(phw_uring->fd); phw_uring->fd = -1; }
+
+    if (phw_uring->buffers != NULL) {
+        (void)munmap(phw_uring->buffers, (HW_URING_RX_FRAMES + HW_URING_TX_FRAMES) * HW_URING_FRAME_SIZE);
+        phw_uring->buffers = NULL;
+    }
+
+    osal_mutex_destroy(&phw_uring->sq_lock);
+
+    return ret;
+}
+
+//! Receive a frame from an EtherCAT hw device.
+/*!
+ * Reaps all completions. Received frames are processed in place and their 
+ * reads re-armed, finished writes release their TX buffer. Waits for at 
+ * least one completion if none is available.
+ *
+ * \param[in]   phw         Pointer to hw handle. 
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_uring_recv(struct hw_common *phw) {
+    assert(phw != NULL);
+
+    ec_t *pec = phw->pec;
+    struct hw_uring *phw_uring = container_of(phw, struct hw_uring, common);
+
+    osal_uint32_t head = *phw_uring->cq.head;
+    osal_uint32_t tail = __atomic_load_n(phw_uring->cq.tail, __ATOMIC_ACQUIRE);
+
+    if (head == tail) {
+        if (    (hw_uring_enter(phw_uring->ring_fd, 0u, 1u, IORING_ENTER_GETEVENTS) < 0) &&
+                (errno != EINTR) && (errno != EAGAIN) && (errno != EBUSY)) {
+            ec_log(1, "HW_RX", "error on io_uring_enter: %s\n", strerror(errno));
+        }
+
+        tail = __atomic_load_n(phw_uring->cq.tail, __ATOMIC_ACQUIRE);
+    }
+
+    if (head != tail) {
+        // each rx slot has at most one read in flight
+        ec_frame_t *frames[HW_URING_RX_FRAMES];
+        osal_uint32_t rearm[HW_URING_RX_FRAMES];
+        osal_size_t cnt = 0u;
+        osal_size_t rearm_cnt = 0u;
+
+        for (; head != tail; ++head) {
+            struct io_uring_cqe *cqe = &((struct io_uring_cqe *)phw_uring->cq.entries)[head & phw_uring->cq.mask];
+            osal_uint32_t op = (osal_uint32_t)(cqe->user_data >> 32u);
+            osal_uint32_t idx = (osal_uint32_t)(cqe->user_data & 0xFFFFFFFFu);
+
+            if (op == HW_URING_OP_TX) {
+                if (cqe->res < 0) {
+                    ec_log(1, "HW_TX", "error on write: %s\n", strerror(-cqe->res));
+                }
+
+                __atomic_store_n(&phw_uring->tx_busy[idx], 0u, __ATOMIC_RELEASE);
+            } else if (op == HW_URING_OP_RX) {
+                if (cqe->res > 0) {
+                    // cppcheck-suppress misra-c2012-11.3
+                    frames[cnt++] = (ec_frame_t *)HW_URING_RX_BUFFER(phw_uring, idx);
+                } else if ((cqe->res < 0) && (cqe->res != -ECANCELED) && (cqe->res != -EAGAIN) && (cqe->res != -EINTR)) {
+                    ec_log(1, "HW_RX", "error on read: %s\n", strerror(-cqe->res));
+                } else {}
+
+                rearm[rearm_cnt++] = idx;
+            } else {}
+        }
+
+        __atomic_store_n(phw_uring->cq.head, head, __ATOMIC_RELEASE);
+
+        (void)hw_process_rx_frames(phw, frames, cnt);
+
+        if ((rearm_cnt > 0u) && (phw_uring->rxthreadrunning != 0)) {
+            osal_mutex_lock(&phw_uring->sq_lock);
+            for (osal_size_t i = 0u; i < rearm_cnt; ++i) {
+                hw_uring_queue_read(phw_uring, rearm[i]);
+            }
+
+            // re-armed reads usually go out with the next cycle's frames, only
+            // submit them now if the kernel is running short of reads
+            if (phw_uring->rx_queued >= (HW_URING_RX_FRAMES / 2u)) {
+                (void)hw_uring_flush(phw_uring);
+            }
+            osal_mutex_unlock(&phw_uring->sq_lock);
+        }
+    }
+
+    return EC_OK;
+}
+
+//! receiver thread
+void *hw_device_uring_rx_thread(void *arg) {
+    // cppcheck-suppress misra-c2012-11.5
+    struct hw_uring *phw_uring = (struct hw_uring *) arg;
+    ec_t *pec = phw_uring->common.pec;
+
+    assert(phw_uring != NULL);
+
+    // received frames show up in the cycle timeline
+    (void)ec_trace_register_thread();
+    
+    osal_task_sched_priority_t rx_prio;
+    if (osal_task_get_priority(&phw_uring->rxthread, &rx_prio) != OSAL_OK) {
+        rx_prio = 0;
+    }
+
+    ec_log(10, "HW_URING_RX", "receive thread running (prio %d)\n", rx_prio);
+
+    while (phw_uring->rxthreadrunning != 0) {
+        (void)hw_device_uring_recv(&phw_uring->common);
+    }
+    
+    ec_log(10, "HW_URING_RX", "receive thread stopped\n");
+    ec_trace_unregister_thread();
+    
+    return NULL;
+}
+
+//! Get a free tx buffer from underlying hw device.
+/*!
+ * \param[in]   phw         Pointer to hw handle. 
+ * \param[in]   ppframe     Pointer to return frame buffer pointer.
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_uring_get_tx_buffer(struct hw_common *phw, ec_frame_t **ppframe) {
+    assert(phw != NULL);
+    assert(ppframe != NULL);
+
+    int ret = EC_OK;
+    struct hw_uring *phw_uring = container_of(phw, struct hw_uring, common);
+    
+    static const osal_uint8_t mac_dest[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+    static const osal_uint8_t mac_src[] = {0x00, 0x30, 0x64, 0x0f, 0x83, 0x35};
+
+    osal_uint32_t idx = HW_URING_TX_FRAMES;
+
+    while (idx == HW_URING_TX_FRAMES) {
+        for (osal_uint32_t n = 0u; n < HW_URING_TX_FRAMES; ++n) {
+            osal_uint32_t i = (phw_uring->tx_next + n) % HW_URING_TX_FRAMES;
+            if (__atomic_load_n(&phw_uring->tx_busy[i], __ATOMIC_ACQUIRE) == 0u) {
+                idx = i;
+                break;
+            }
+        }
+
+        if (idx == HW_URING_TX_FRAMES) {
+            // all buffers in flight, let the kernel process queued writes
+            osal_mutex_lock(&phw_uring->sq_lock);
+            (void)hw_uring_flush(phw_uring);
+            osal_mutex_unlock(&phw_uring->sq_lock);
+            osal_microsleep(10);
+        }
+    }
+
+    phw_uring->tx_busy[idx] = 1u;
+    phw_uring->tx_next = (idx + 1u) % HW_URING_TX_FRAMES;
+
+    // cppcheck-suppress misra-c2012-11.3
+    ec_frame_t *pframe = (ec_frame_t *)HW_URING_TX_BUFFER(phw_uring, idx);
+
+    // reset length to send new frame
+    (void)memcpy(pframe->mac_dest, mac_dest, 6);
+    (void)memcpy(pframe->mac_src, mac_src, 6);
+    pframe->ethertype = htons(ETH_P_ECAT);
+    pframe->type = 0x01;
+    pframe->len = sizeof(ec_frame_t);
+
+    *ppframe = pframe;
+
+    return ret;
+}
+
+//! Send a frame from an EtherCAT hw device.
+/*!
+ * Only queues the write, it is submitted in send_finished.
+ *
+ * \param[in]   phw         Pointer to hw handle. 
+ * \param[in]   pframe      Pointer to frame buffer.
+ * \param[in]   pool_type   Pool type to distinguish between high and low prio frames.
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_uring_send(struct hw_common *phw, ec_frame_t *pframe, pooltype_t pool_type) {
+    assert(phw != NULL);
+    assert(pframe != NULL);
+
+    (void)pool_type;
+
+    int ret = EC_OK;
+    ec_t *pec = phw->pec;
+    struct hw_uring *phw_uring = container_of(phw, struct hw_uring, common);
+    osal_uint32_t idx = (osal_uint32_t)(((osal_uint8_t *)pframe - HW_URING_TX_BUFFER(phw_uring, 0u)) / HW_URING_FRAME_SIZE);
+
+    assert(idx < HW_URING_TX_FRAMES);
+
+    osal_mutex_lock(&phw_uring->sq_lock);
+    struct io_uring_sqe *sqe = hw_uring_get_sqe(phw_uring);
+    if (sqe == NULL) {
+        // should not happen, queue holds all rx and tx slots
+        (void)hw_uring_flush(phw_uring);
+        sqe = hw_uring_get_sqe(phw_uring);
+    }
+
+    if (sqe == NULL) {
+        ec_log(1, "HW_TX", "submission queue full, dropping frame\n");
+        __atomic_store_n(&phw_uring->tx_busy[idx], 0u, __ATOMIC_RELEASE);
+        ret = EC_ERROR_HW_SEND;
+    } else {
+        sqe->opcode = IORING_OP_WRITE;
+        sqe->fd = phw_uring->fd;
+        sqe->addr = (osal_uint64_t)(osal_size_t)pframe;
+        sqe->len = pframe->len;
+        sqe->user_data = HW_URING_USER_DATA(HW_URING_OP_TX, idx);
+    }
+    osal_mutex_unlock(&phw_uring->sq_lock);
+
+    return ret;
+}
+
+//! Doing internal stuff when finished sending frames
+/*!
+ * Submits all frames of this cycle together with re-armed reads.
+ *
+ * \param[in]   phw         Pointer to hw handle.
+ */
+void hw_device_uring_send_finished(struct hw_common *phw) {
+    assert(phw != NULL);
+
+    struct hw_uring *phw_uring = container_of(phw, struct hw_uring, common);
+
+    osal_mutex_lock(&phw_uring->sq_lock);
+    (void)hw_uring_flush(phw_uring);
+    osal_mutex_unlock(&phw_uring->sq_lock);
+}
+
+#endif /* LIBETHERCAT_BUILD_DEVICE_URING == 1 */
+
@@ -0,0 +1,740 @@
+/**
+ * \file hw_xdp.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief AF_XDP hardware access functions
+ *
+ */
+
+/*
+ * This file is part of libethercat.
+ *
+ * libethercat is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * libethercat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with libethercat (LICENSE.LGPL-V3); if not, write 
+ * to the Free Software Foundation, Inc., 51 Franklin Street, Fifth 
+ * Floor, Boston, MA  02110-1301, USA.
+ * 
+ * Please note that the use of the EtherCAT technology, the EtherCAT 
+ * brand name and the EtherCAT logo is only permitted if the property 
+ * rights of Beckhoff Automation GmbH are observed. For further 
+ * information please contact Beckhoff Automation GmbH & Co. KG, 
+ * Hülshorstweg 20, D-33415 Verl, Germany (www.beckhoff.com) or the 
+ * EtherCAT Technology Group, Ostendstraße 196, D-90482 Nuremberg, 
+ * Germany (ETG, www.ethercat.org).
+ *
+ */
+#ifdef HAVE_CONFIG_H
+#include <libethercat/config.h>
+#endif
+
+#include <libethercat/settings.h>
+
+#if LIBETHERCAT_BUILD_DEVICE_XDP == 1
+
+#include <libethercat/hw_xdp.h>
+#include <libethercat/ec.h>
+#include <libethercat/idx.h>
+#include <libethercat/error_codes.h>
+
+#include <assert.h>
+
+#ifdef LIBETHERCAT_HAVE_NET_IF_H
+#include <net/if.h> 
+#endif
+
+#ifdef LIBETHERCAT_HAVE_ARPA_INET_H
+#include <arpa/inet.h>
+#endif
+
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/if_xdp.h>
+#include <linux/if_link.h>
+#include <linux/bpf.h>
+#include <poll.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+#ifndef AF_XDP
+#define AF_XDP      44
+#endif
+
+#ifndef SOL_XDP
+#define SOL_XDP     283
+#endif
+
+// forward declarations
+int hw_device_xdp_send(struct hw_common *phw, ec_frame_t *pframe, pooltype_t pool_type);
+int hw_device_xdp_recv(struct hw_common *phw);
+void hw_device_xdp_send_finished(struct hw_common *phw);
+int hw_device_xdp_get_tx_buffer(struct hw_common *phw, ec_frame_t **ppframe);
+int hw_device_xdp_close(struct hw_common *phw);
+
+static void *hw_device_xdp_rx_thread(void *arg);
+
+//! Maximum number of frames passed to hw_process_rx_frames at once.
+#define HW_XDP_RX_BATCH     32u
+
+//! Wrapper for bpf syscall.
+static int hw_xdp_bpf(int cmd, union bpf_attr *attr) {
+    return (int)syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+//! Build a bpf instruction.
+static struct bpf_insn hw_xdp_insn(osal_uint8_t code, osal_uint8_t dst, osal_uint8_t src, osal_int16_t off, osal_int32_t imm) {
+    struct bpf_insn insn;
+    (void)memset(&insn, 0, sizeof(insn));
+    insn.code = code;
+    insn.dst_reg = dst;
+    insn.src_reg = src;
+    insn.off = off;
+    insn.imm = imm;
+    return insn;
+}
+
+//! Load XDP program and attach it to interface.
+/*!
+ * The program redirects all EtherCAT frames to the XSKMAP entry of the 
+ * receiving queue and passes everything else to the network stack.
+ *
+ * \param[in]   phw_xdp     Pointer to xdp hw handle. 
+ *
+ * \return 0 or negative error code
+ */
+static int hw_xdp_load_program(struct hw_xdp *phw_xdp) {
+    int ret = EC_OK;
+    ec_t *pec = phw_xdp->common.pec;
+    union bpf_attr attr;
+
+    (void)memset(&attr, 0, sizeof(attr));
+    attr.map_type = BPF_MAP_TYPE_XSKMAP;
+    attr.key_size = sizeof(osal_uint32_t);
+    attr.value_size = sizeof(osal_uint32_t);
+    attr.max_entries = phw_xdp->queue_id + 1u;
+    phw_xdp->map_fd = hw_xdp_bpf(BPF_MAP_CREATE, &attr);
+    if (phw_xdp->map_fd < 0) {
+        ec_log(1, "HW_OPEN", "creating xskmap failed: %s\n", strerror(errno));
+        ret = EC_ERROR_UNAVAILABLE;
+    }
+
+    if (ret == EC_OK) {
+        struct bpf_insn prog[] = {
+            // r2 = data, r3 = data_end, check ethernet header
+            hw_xdp_insn(BPF_LDX | BPF_W | BPF_MEM, BPF_REG_2, BPF_REG_1, offsetof(struct xdp_md, data), 0),
+            hw_xdp_insn(BPF_LDX | BPF_W | BPF_MEM, BPF_REG_3, BPF_REG_1, offsetof(struct xdp_md, data_end), 0),
+            hw_xdp_insn(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_4, BPF_REG_2, 0, 0),
+            hw_xdp_insn(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_4, 0, 0, 14),
+            hw_xdp_insn(BPF_JMP | BPF_JGT | BPF_X, BPF_REG_4, BPF_REG_3, 8, 0),
+            // compare ethertype
+            hw_xdp_insn(BPF_LDX | BPF_H | BPF_MEM, BPF_REG_4, BPF_REG_2, 12, 0),
+            hw_xdp_insn(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_4, 0, 6, htons(ETH_P_ECAT)),
+            // return bpf_redirect_map(&xskmap, ctx->rx_queue_index, XDP_PASS)
+            hw_xdp_insn(BPF_LDX | BPF_W | BPF_MEM, BPF_REG_2, BPF_REG_1, offsetof(struct xdp_md, rx_queue_index), 0),
+            hw_xdp_insn(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, phw_xdp->map_fd),
+            hw_xdp_insn(0, 0, 0, 0, 0),
+            hw_xdp_insn(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_3, 0, 0, XDP_PASS),
+            hw_xdp_insn(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map),
+            hw_xdp_insn(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+            // return XDP_PASS
+            hw_xdp_insn(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, XDP_PASS),
+            hw_xdp_insn(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+        };
+        static const osal_char_t license[] = "GPL";
+
+        (void)memset(&attr, 0, sizeof(attr));
+        attr.prog_type = BPF_PROG_TYPE_XDP;
+        attr.insn_cnt = sizeof(prog) / sizeof(prog[0]);
+        attr.insns = (osal_uint64_t)(unsigned long)&prog[0];
+        attr.license = (osal_uint64_t)(unsigned long)&license[0];
+        phw_xdp->prog_fd = hw_xdp_bpf(BPF_PROG_LOAD, &attr);
+        if (phw_xdp->prog_fd < 0) {
+            ec_log(1, "HW_OPEN", "loading xdp program failed: %s\n", strerror(errno));
+            ret = EC_ERROR_UNAVAILABLE;
+        }
+    }
+
+    if (ret == EC_OK) {
+        // try native xdp first, generic xdp works on every interface
+        static const osal_uint32_t modes[] = { XDP_FLAGS_DRV_MODE, XDP_FLAGS_SKB_MODE };
+
+        for (osal_uint32_t i = 0u; i < (sizeof(modes) / sizeof(modes[0])); ++i) {
+            (void)memset(&attr, 0, sizeof(attr));
+            attr.link_create.prog_fd = phw_xdp->prog_fd;
+            attr.link_create.target_ifindex = phw_xdp->ifindex;
+            attr.link_create.attach_type = BPF_XDP;
+            attr.link_create.flags = modes[i];
+            phw_xdp->link_fd = hw_xdp_bpf(BPF_LINK_CREATE, &attr);
+            if (phw_xdp->link_fd >= 0) {
+                ec_log(10, "HW_OPEN", "attached xdp program in %s mode\n", 
+                        modes[i] == XDP_FLAGS_DRV_MODE ? "native" : "generic");
+                break;
+            }
+        }
+
+        if (phw_xdp->link_fd < 0) {
+            ec_log(1, "HW_OPEN", "attaching xdp program failed: %s\n", strerror(errno));
+            ret = EC_ERROR_UNAVAILABLE;
+        }
+    }
+
+    return ret;
+}
+
+//! Map one AF_XDP ring.
+/*!
+ * \param[in]   phw_xdp     Pointer to xdp hw handle. 
+ * \param[out]  ring        Ring to map.
+ * \param[in]   off         Ring offsets returned by kernel.
+ * \param[in]   entries     Number of ring entries.
+ * \param[in]   entry_size  Size of one ring entry.
+ * \param[in]   pgoff       Mmap offset of ring.
+ *
+ * \return 0 or negative error code
+ */
+static int hw_xdp_map_ring(struct hw_xdp *phw_xdp, hw_xdp_ring_t *ring, 
+        const struct xdp_ring_offset *off, osal_uint32_t entries, osal_size_t entry_size, off_t pgoff) {
+    int ret = EC_OK;
+
+    ring->map_size = off->desc + (entries * entry_size);
+    ring->map = mmap(NULL, ring->map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, phw_xdp->sockfd, pgoff);
+    if (ring->map == MAP_FAILED) {
+        ring->map = NULL;
+        ret = EC_ERROR_UNAVAILABLE;
+    } else {
+        // cppcheck-suppress misra-c2012-11.3
+        ring->producer = (osal_uint32_t *)(&((osal_uint8_t *)ring->map)[off->producer]);
+        // cppcheck-suppress misra-c2012-11.3
+        ring->consumer = (osal_uint32_t *)(&((osal_uint8_t *)ring->map)[off->consumer]);
+        // cppcheck-suppress misra-c2012-11.3
+        ring->flags = (osal_uint32_t *)(&((osal_uint8_t *)ring->map)[off->flags]);
+        ring->ring = &((osal_uint8_t *)ring->map)[off->desc];
+        ring->mask = entries - 1u;
+    }
+
+    return ret;
+}
+
+//! Create AF_XDP socket with UMEM and bind it to interface queue.
+/*!
+ * \param[in]   phw_xdp     Pointer to xdp hw handle. 
+ *
+ * \return 0 or negative error code
+ */
+static int hw_xdp_create_socket(struct hw_xdp *phw_xdp) {
+    int ret = EC_OK;
+    ec_t *pec = phw_xdp->common.pec;
+
+    phw_xdp->sockfd = socket(AF_XDP, SOCK_RAW, 0);
+    if (phw_xdp->sockfd < 0) {
+        ec_log(1, "HW_OPEN", "socket error on opening AF_XDP: %s\n", strerror(errno));
+        ret = EC_ERROR_UNAVAILABLE;
+    }
+
+    if (ret == EC_OK) {
+        // first HW_XDP_RX_FRAMES frames are for receiving, the rest for sending
+        phw_xdp->umem_size = (HW_XDP_RX_FRAMES + HW_XDP_TX_FRAMES) * HW_XDP_FRAME_SIZE;
+        void *umem = mmap(NULL, phw_xdp->umem_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+        if (umem == MAP_FAILED) {
+            ec_log(1, "HW_OPEN", "allocating umem failed: %s\n", strerror(errno));
+            phw_xdp->umem = NULL;
+            ret = EC_ERROR_OUT_OF_MEMORY;
+        } else {
+            phw_xdp->umem = (osal_uint8_t *)umem;
+        }
+    }
+
+    if (ret == EC_OK) {
+        struct xdp_umem_reg reg;
+        (void)memset(&reg, 0, sizeof(reg));
+        reg.addr = (osal_uint64_t)(unsigned long)phw_xdp->umem;
+        reg.len = phw_xdp->umem_size;
+        reg.chunk_size = HW_XDP_FRAME_SIZE;
+        reg.headroom = 0;
+
+        int fill_size = HW_XDP_RX_FRAMES;
+        int comp_size = HW_XDP_TX_FRAMES;
+        int rx_size = HW_XDP_RX_FRAMES;
+        int tx_size = HW_XDP_TX_FRAMES;
+
+        if (setsockopt(phw_xdp->sockfd, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) != 0) {
+            ec_log(1, "HW_OPEN", "setsockopt() umem: %s\n", strerror(errno));
+            ret = EC_ERROR_UNAVAILABLE;
+        } else if (
+                (setsockopt(phw_xdp->sockfd, SOL_XDP, XDP_UMEM_FILL_RING, &fill_size, sizeof(fill_size)) != 0) ||
+                (setsockopt(phw_xdp->sockfd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &comp_size, sizeof(comp_size)) != 0) ||
+                (setsockopt(phw_xdp->sockfd, SOL_XDP, XDP_RX_RING, &rx_size, sizeof(rx_size)) != 0) ||
+                (setsockopt(phw_xdp->sockfd, SOL_XDP, XDP_TX_RING, &tx_size, sizeof(tx_size)) != 0)) {
+            ec_log(1, "HW_OPEN", "setsockopt() rings: %s\n", strerror(errno));
+            ret = EC_ERROR_UNAVAILABLE;
+        } else {}
+    }
+
+    if (ret == EC_OK) {
+        struct xdp_mmap_offsets off;
+        socklen_t optlen = sizeof(off);
+
+        if (getsockopt(phw_xdp->sockfd, SOL_XDP, XDP_MMAP_OFFSETS, &off, &optlen) != 0) {
+            ec_log(1, "HW_OPEN", "getsockopt() mmap offsets: %s\n", strerror(errno));
+            ret = EC_ERROR_UNAVAILABLE;
+        } else if (
+                (hw_xdp_map_ring(phw_xdp, &phw_xdp->fill, &off.fr, HW_XDP_RX_FRAMES, sizeof(osal_uint64_t), XDP_UMEM_PGOFF_FILL_RING) != EC_OK) ||
+                (hw_xdp_map_ring(phw_xdp, &phw_xdp->comp, &off.cr, HW_XDP_TX_FRAMES, sizeof(osal_uint64_t), XDP_UMEM_PGOFF_COMPLETION_RING) != EC_OK) ||
+                (hw_xdp_map_ring(phw_xdp, &phw_xdp->rx, &off.rx, HW_XDP_RX_FRAMES, sizeof(struct xdp_desc), XDP_PGOFF_RX_RING) != EC_OK) ||
+                (hw_xdp_map_ring(phw_xdp, &phw_xdp->tx, &off.tx, HW_XDP_TX_FRAMES, sizeof(struct xdp_desc), XDP_PGOFF_TX_RING) != EC_OK)) {
+            ec_log(1, "HW_OPEN", "mmap() rings: %s\n", strerror(errno));
+            ret = EC_ERROR_UNAVAILABLE;
+        } else {}
+    }
+
+    if (ret == EC_OK) {
+        // hand all rx frames to the kernel
+        osal_uint64_t *fill = (osal_uint64_t *)phw_xdp->fill.ring;
+        for (osal_uint32_t i = 0u; i < HW_XDP_RX_FRAMES; ++i) {
+            fill[i] = (osal_uint64_t)i * HW_XDP_FRAME_SIZE;
+        }
+        __atomic_store_n(phw_xdp->fill.producer, HW_XDP_RX_FRAMES, __ATOMIC_RELEASE);
+
+        for (osal_uint32_t i = 0u; i < HW_XDP_TX_FRAMES; ++i) {
+            phw_xdp->tx_free[i] = (osal_uint64_t)(HW_XDP_RX_FRAMES + i) * HW_XDP_FRAME_SIZE;
+        }
+        phw_xdp->tx_free_cnt = HW_XDP_TX_FRAMES;
+        phw_xdp->tx_pending = 0u;
+
+        // zero-copy needs driver support, copy mode works everywhere
+        static const osal_uint16_t bind_flags[] = { 
+            XDP_ZEROCOPY | XDP_USE_NEED_WAKEUP, XDP_COPY | XDP_USE_NEED_WAKEUP, XDP_COPY };
+
+        ret = EC_ERROR_UNAVAILABLE;
+        for (osal_uint32_t i = 0u; i < (sizeof(bind_flags) / sizeof(bind_flags[0])); ++i) {
+            struct sockaddr_xdp sxdp;
+            (void)memset(&sxdp, 0, sizeof(sxdp));
+            sxdp.sxdp_family = AF_XDP;
+            sxdp.sxdp_ifindex = phw_xdp->ifindex;
+            sxdp.sxdp_queue_id = phw_xdp->queue_id;
+            sxdp.sxdp_flags = bind_flags[i];
+
+            if (bind(phw_xdp->sockfd, (struct sockaddr *)&sxdp, sizeof(sxdp)) == 0) {
+                phw_xdp->zero_copy = ((bind_flags[i] & XDP_ZEROCOPY) != 0u) ? OSAL_TRUE : OSAL_FALSE;
+                phw_xdp->need_wakeup = ((bind_flags[i] & XDP_USE_NEED_WAKEUP) != 0u) ? OSAL_TRUE : OSAL_FALSE;
+                ec_log(10, "HW_OPEN", "bound AF_XDP socket to queue %u in %s mode\n", 
+                        phw_xdp->queue_id, phw_xdp->zero_copy == OSAL_TRUE ? "zero-copy" : "copy");
+                ret = EC_OK;
+                break;
+            }
+        }
+
+        if (ret != EC_OK) {
+            ec_log(1, "HW_OPEN", "binding AF_XDP socket failed: %s\n", strerror(errno));
+        }
+    }
+
+    if (ret == EC_OK) {
+        osal_uint32_t key = phw_xdp->queue_id;
+        osal_uint32_t value = (osal_uint32_t)phw_xdp->sockfd;
+        union bpf_attr attr;
+
+        (void)memset(&attr, 0, sizeof(attr));
+        attr.map_fd = phw_xdp->map_fd;
+        attr.key = (osal_uint64_t)(unsigned long)&key;
+        attr.value = (osal_uint64_t)(unsigned long)&value;
+        if (hw_xdp_bpf(BPF_MAP_UPDATE_ELEM, &attr) != 0) {
+            ec_log(1, "HW_OPEN", "adding socket to xskmap failed: %s\n", strerror(errno));
+            ret = EC_ERROR_UNAVAILABLE;
+        }
+    }
+
+    return ret;
+}
+
+//! Opens EtherCAT hw device.
+/*!
+ * \param[in]   phw_xdp     Pointer to xdp hw handle. 
+ * \param[in]   pec         Pointer to master struct.
+ * \param[in]   devname     Null-terminated string to EtherCAT hw device name.
+ * \param[in]   prio        Priority for receiver thread.
+ * \param[in]   cpu_mask    CPU mask for receiver thread.
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_xdp_open(struct hw_xdp *phw_xdp, ec_t *pec, const osal_char_t *devname, int prio, int cpumask) {
+    assert(phw_xdp != NULL);
+    assert(devname != NULL);
+
+    int ret = EC_OK;
+    
+    hw_open(&phw_xdp->common, pec);
+
+    phw_xdp->common.send = hw_device_xdp_send;
+    phw_xdp->common.recv = hw_device_xdp_recv;
+    phw_xdp->common.send_finished = hw_device_xdp_send_finished;
+    phw_xdp->common.get_tx_buffer = hw_device_xdp_get_tx_buffer;
+    phw_xdp->common.close = hw_device_xdp_close;
+
+    phw_xdp->sockfd = -1;
+    phw_xdp->prog_fd = -1;
+    phw_xdp->map_fd = -1;
+    phw_xdp->link_fd = -1;
+    phw_xdp->queue_id = 0u;
+    phw_xdp->umem = NULL;
+    (void)memset(&phw_xdp->fill, 0, sizeof(phw_xdp->fill));
+    (void)memset(&phw_xdp->comp, 0, sizeof(phw_xdp->comp));
+    (void)memset(&phw_xdp->rx, 0, sizeof(phw_xdp->rx));
+    (void)memset(&phw_xdp->tx, 0, sizeof(phw_xdp->tx));
+    phw_xdp->rxthreadrunning = 0;
+
+    phw_xdp->ifindex = (int)if_nametoindex(devname);
+    if (phw_xdp->ifindex == 0) {
+        ec_log(1, "HW_OPEN", "unknown interface %s: %s\n", devname, strerror(errno));
+        ret = EC_ERROR_UNAVAILABLE;
+    }
+
+    if (ret == EC_OK) {
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd >= 0) {
+            struct ifreq ifr;
+            (void)memset(&ifr, 0, sizeof(ifr));
+            (void)strncpy(ifr.ifr_name, devname, IFNAMSIZ - 1);
+
+            if (ioctl(fd, SIOCGIFFLAGS, &ifr) == 0) {
+                ifr.ifr_flags = ifr.ifr_flags | IFF_PROMISC | IFF_BROADCAST | IFF_UP;
+                (void)ioctl(fd, SIOCSIFFLAGS, &ifr);
+            }
+
+            if (ioctl(fd, SIOCGIFMTU, &ifr) == 0) {
+                phw_xdp->common.mtu_size = ifr.ifr_mtu;
+            }
+
+            close(fd);
+        }
+
+        // frame has to fit into one umem frame
+        if ((phw_xdp->common.mtu_size == 0u) || (phw_xdp->common.mtu_size > 1500u)) {
+            phw_xdp->common.mtu_size = 1500u;
+        }
+        ec_log(10, "HW_OPEN", "got mtu size %d\n", phw_xdp->common.mtu_size);
+
+        ret = hw_xdp_load_program(phw_xdp);
+    }
+
+    if (ret == EC_OK) {
+        ret = hw_xdp_create_socket(phw_xdp);
+    }
+
+    if (ret == EC_OK) {
+        phw_xdp->rx_busy_poll = hw_device_cpu_isolated(cpumask);
+        if (phw_xdp->rx_busy_poll == OSAL_TRUE) {
+            ec_log(10, "HW_OPEN", "receive thread pinned to isolated cpu, busy-polling rx ring\n");
+
+#if defined(SO_PREFER_BUSY_POLL) && defined(SO_BUSY_POLL_BUDGET)
+            // let the napi context run from our receive thread
+            int i = 1;
+            (void)setsockopt(phw_xdp->sockfd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &i, sizeof(i));
+            i = 20;
+            (void)setsockopt(phw_xdp->sockfd, SOL_SOCKET, SO_BUSY_POLL, &i, sizeof(i));
+            i = HW_XDP_RX_BATCH;
+            (void)setsockopt(phw_xdp->sockfd, SOL_SOCKET, SO_BUSY_POLL_BUDGET, &i, sizeof(i));
+#endif
+        }
+    }
+    
+    if (ret == EC_OK) {
+        phw_xdp->rxthreadrunning = 1;
+        osal_task_attr_t attr;
+        attr.policy = OSAL_SCHED_POLICY_FIFO;
+        attr.priority = prio;
+        attr.affinity = cpumask;
+        (void)strcpy(&attr.task_name[0], "ecat.rx");
+        osal_task_create(&phw_xdp->rxthread, &attr, hw_device_xdp_rx_thread, phw_xdp);
+    } else {
+        (void)hw_device_xdp_close(&phw_xdp->common);
+    }
+
+    return ret;
+}
+
+//! Unmap one AF_XDP ring.
+static void hw_xdp_unmap_ring(hw_xdp_ring_t *ring) {
+    if (ring->map != NULL) {
+        (void)munmap(ring->map, ring->map_size);
+        ring->map = NULL;
+    }
+}
+
+//! Close hardware layer
+/*!
+ * \param[in]   phw         Pointer to hw handle.
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_xdp_close(struct hw_common *phw) {
+    int ret = 0;
+
+    struct hw_xdp *phw_xdp = container_of(phw, struct hw_xdp, common);
+    
+    if (phw_xdp->rxthreadrunning != 0) {
+        phw_xdp->rxthreadrunning = 0;
+        osal_task_join(&phw_xdp->rxthread, NULL);
+    }
+
+    // closing the link detaches the program from the interface
+    if (phw_xdp->link_fd >= 0) { close(phw_xdp->link_fd); phw_xdp->link_fd = -1; }
+    if (phw_xdp->prog_fd >= 0) { close(phw_xdp->prog_fd); phw_xdp->prog_fd = -1; }
+    if (phw_xdp->map_fd >= 0) { close(phw_xdp->map_fd); phw_xdp->map_fd = -1; }
+
+    hw_xdp_unmap_ring(&phw_xdp->fill);
+    hw_xdp_unmap_ring(&phw_xdp->comp);
+    hw_xdp_unmap_ring(&phw_xdp->rx);
+    hw_xdp_unmap_ring(&phw_xdp->tx);
+
+    if (phw_xdp->sockfd >= 0) { close(phw_xdp->sockfd); phw_xdp->sockfd = -1; }
+
+    if (phw_xdp->umem != NULL) {
+        (void)munmap(phw_xdp->umem, phw_xdp->umem_size);
+        phw_xdp->umem = NULL;
+    }
+
+    return ret;
+}
+
+//! Receive a frame from an EtherCAT hw device.
+/*!
+ * \param[in]   phw         Pointer to hw handle. 
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_xdp_recv(struct hw_common *phw) {
+    assert(phw != NULL);
+
+    struct hw_xdp *phw_xdp = container_of(phw, struct hw_xdp, common);
+
+    osal_uint32_t cons = *phw_xdp->rx.consumer;
+    osal_uint32_t prod = __atomic_load_n(phw_xdp->rx.producer, __ATOMIC_ACQUIRE);
+
+    if (prod == cons) {
+        if (phw_xdp->rx_busy_poll == OSAL_FALSE) {
+            struct pollfd pollset;
+            pollset.fd = phw_xdp->sockfd;
+            pollset.events = POLLIN;
+            pollset.revents = 0;
+            (void)poll(&pollset, 1, 1);
+        } else if (    (phw_xdp->need_wakeup == OSAL_FALSE) || 
+                ((__atomic_load_n(phw_xdp->fill.flags, __ATOMIC_RELAXED) & XDP_RING_NEED_WAKEUP) != 0u)) {
+            (void)recvfrom(phw_xdp->sockfd, NULL, 0, MSG_DONTWAIT, NULL, NULL);
+        } else {}
+
+        prod = __atomic_load_n(phw_xdp->rx.producer, __ATOMIC_ACQUIRE);
+    }
+
+    if (prod != cons) {
+        struct xdp_desc *rx = (struct xdp_desc *)phw_xdp->rx.ring;
+        osal_uint64_t *fill = (osal_uint64_t *)phw_xdp->fill.ring;
+        osal_uint32_t fill_prod = *phw_xdp->fill.producer;
+        ec_frame_t *frames[HW_XDP_RX_BATCH];
+        osal_size_t cnt = 0u;
+
+        // frames are processed in place in umem
+        for (osal_uint32_t i = cons; i != prod; ++i) {
+            struct xdp_desc *desc = &rx[i & phw_xdp->rx.mask];
+            // cppcheck-suppress misra-c2012-11.3
+            frames[cnt++] = (ec_frame_t *)(&phw_xdp->umem[desc->addr]);
+            if (cnt == HW_XDP_RX_BATCH) {
+                (void)hw_process_rx_frames(phw, frames, cnt);
+                cnt = 0u;
+            }
+        }
+
+        (void)hw_process_rx_frames(phw, frames, cnt);
+
+        // give frames back to kernel, fill ring holds all rx frames
+        for (osal_uint32_t i = cons; i != prod; ++i) {
+            fill[(fill_prod++) & phw_xdp->fill.mask] = rx[i & phw_xdp->rx.mask].addr & ~((osal_uint64_t)HW_XDP_FRAME_SIZE - 1u);
+        }
+
+        __atomic_store_n(phw_xdp->fill.producer, fill_prod, __ATOMIC_RELEASE);
+        __atomic_store_n(phw_xdp->rx.consumer, prod, __ATOMIC_RELEASE);
+    }
+
+    return EC_OK;
+}
+
+//! receiver thread
+void *hw_device_xdp_rx_thread(void *arg) {
+    // cppcheck-suppress misra-c2012-11.5
+    struct hw_xdp *phw_xdp = (struct hw_xdp *) arg;
+    ec_t *pec = phw_xdp->common.pec;
+
+    assert(phw_xdp != NULL);
+
+    // received frames show up in the cycle timeline
+    (void)ec_trace_register_thread();
+    
+    osal_task_sched_priority_t rx_prio;
+    if (osal_task_get_priority(&phw_xdp->rxthread, &rx_prio) != OSAL_OK) {
+        rx_prio = 0;
+    }
+
+    ec_log(10, "HW_XDP_RX", "receive thread running (prio %d)\n", rx_prio);
+
+    while (phw_xdp->rxthreadrunning != 0) {
+        (void)hw_device_xdp_recv(&phw_xdp->common);
+    }
+    
+    ec_log(10, "HW_XDP_RX", "receive thread stopped\n");
+    ec_trace_unregister_thread();
+    
+    return NULL;
+}
+
+//! Notify kernel about frames pending in TX ring.
+/*!
+ * \param[in]   phw_xdp     Pointer to xdp hw handle.
+ *
+ * \return 0 or negative error code
+ */
+static int hw_device_xdp_kick(struct hw_xdp *phw_xdp) {
+    int ret = EC_OK;
+    ec_t *pec = phw_xdp->common.pec;
+
+    if (phw_xdp->tx_pending > 0u) {
+        phw_xdp->tx_pending = 0u;
+
+        if (    (phw_xdp->need_wakeup == OSAL_FALSE) || 
+                ((__atomic_load_n(phw_xdp->tx.flags, __ATOMIC_RELAXED) & XDP_RING_NEED_WAKEUP) != 0u)) {
+            if (    (sendto(phw_xdp->sockfd, NULL, 0, MSG_DONTWAIT, NULL, 0) < 0) && 
+                    (errno != EAGAIN) && (errno != EBUSY) && (errno != ENOBUFS)) {
+                ec_log(1, "HW_TX", "error on sendto: %s\n", strerror(errno));
+                ret = EC_ERROR_HW_SEND;
+            }
+        }
+    }
+
+    return ret;
+}
+
+//! Return completed TX frames to free list.
+static void hw_device_xdp_reclaim(struct hw_xdp *phw_xdp) {
+    osal_uint32_t cons = *phw_xdp->comp.consumer;
+    osal_uint32_t prod = __atomic_load_n(phw_xdp->comp.producer, __ATOMIC_ACQUIRE);
+    osal_uint64_t *comp = (osal_uint64_t *)phw_xdp->comp.ring;
+
+    for (; cons != prod; ++cons) {
+        phw_xdp->tx_free[phw_xdp->tx_free_cnt++] = comp[cons & phw_xdp->comp.mask];
+    }
+
+    __atomic_store_n(phw_xdp->comp.consumer, cons, __ATOMIC_RELEASE);
+}
+
+//! Get a free tx buffer from underlying hw device.
+/*!
+ * \param[in]   phw         Pointer to hw handle. 
+ * \param[in]   ppframe     Pointer to return frame buffer pointer.
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_xdp_get_tx_buffer(struct hw_common *phw, ec_frame_t **ppframe) {
+    assert(phw != NULL);
+    assert(ppframe != NULL);
+
+    int ret = EC_OK;
+    ec_t *pec = phw->pec;
+    struct hw_xdp *phw_xdp = container_of(phw, struct hw_xdp, common);
+    
+    static const osal_uint8_t mac_dest[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+    static const osal_uint8_t mac_src[] = {0x00, 0x30, 0x64, 0x0f, 0x83, 0x35};
+
+    hw_device_xdp_reclaim(phw_xdp);
+
+    while (phw_xdp->tx_free_cnt == 0u) {
+        // all frames in flight, let kernel process the tx ring
+        phw_xdp->tx_pending = 0u;
+        (void)sendto(phw_xdp->sockfd, NULL, 0, MSG_DONTWAIT, NULL, 0);
+
+        struct pollfd pollset;
+        pollset.fd = phw_xdp->sockfd;
+        pollset.events = POLLOUT;
+        pollset.revents = 0;
+        if (poll(&pollset, 1, 1) < 0) {
+            ec_log(1, "HW_TX", "error on poll: %s\n", strerror(errno));
+        }
+
+        hw_device_xdp_reclaim(phw_xdp);
+    }
+
+    // cppcheck-suppress misra-c2012-11.3
+    ec_frame_t *pframe = (ec_frame_t *)(&phw_xdp->umem[phw_xdp->tx_free[--phw_xdp->tx_free_cnt]]);
+
+    // reset length to send new frame
+    (void)memcpy(pframe->mac_dest, mac_dest, 6);
+    (void)memcpy(pframe->mac_src, mac_src, 6);
+    pframe->ethertype = htons(ETH_P_ECAT);
+    pframe->type = 0x01;
+    pframe->len = sizeof(ec_frame_t);
+
+    *ppframe = pframe;
+
+    return ret;
+}
+
+//! Send a frame from an EtherCAT hw device.
+/*!
+ * \param[in]   phw         Pointer to hw handle. 
+ * \param[in]   pframe      Pointer to frame buffer.
+ * \param[in]   pool_type   Pool type to distinguish between high and low prio frames.
+ *
+ * \return 0 or negative error code
+ */
+int hw_device_xdp_send(struct hw_common *phw, ec_frame_t *pframe, pooltype_t pool_type) {
+    assert(phw != NULL);
+    assert(pframe != NULL);
+
+    (void)pool_type;
+
+    int ret = EC_OK;
+    struct hw_xdp *phw_xdp = container_of(phw, struct hw_xdp, common);
+
+    // tx ring has one slot per tx frame, so it is never full here
+    osal_uint32_t prod = *phw_xdp->tx.producer;
+    struct xdp_desc *desc = &((struct xdp_desc *)phw_xdp->tx.ring)[prod & phw_xdp->tx.mask];
+    desc->addr = (osal_uint64_t)((osal_uint8_t *)pframe - phw_xdp->umem);
+    desc->len = pframe->len;
+    desc->options = 0;
+
+    // kernel is notified in send_finished
+    __atomic_store_n(phw_xdp->tx.producer, prod + 1u, __ATOMIC_RELEASE);
+    phw_xdp->tx_pending++;
+
+    return ret;
+}
+
+//! Doing internal stuff when finished sending frames
+/*!
+ * Notifies the kernel once about all frames queued to the TX ring.
+ *
+ * \param[in]   phw         Pointer to hw handle.
+ */
+void hw_device_xdp_send_finished(struct hw_common *phw) {
+    assert(phw != NULL);
+
+    struct hw_xdp *phw_xdp = container_of(phw, struct hw_xdp, common);
+
+    (void)hw_device_xdp_kick(phw_xdp);
+}
+
+#endif /* LIBETHERCAT_BUILD_DEVICE_XDP == 1 */
+
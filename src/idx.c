@@ -43,10 +43,115 @@
 #include <string.h>
 #include <assert.h>
 
+#if defined(__linux__)
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
 #include "libethercat/idx.h"
 #include "libethercat/ec.h"
 #include "libethercat/error_codes.h"
 
+#if defined(__linux__)
+#define IDX_WAITER_IDLE         0u      //!< \brief Nobody waiting, not posted.
+#define IDX_WAITER_POSTED       1u      //!< \brief Completion posted, not yet consumed.
+#define IDX_WAITER_SLEEPING     2u      //!< \brief Waiter sleeps in futex.
+
+//! Relax cpu in spin loop.
+static inline void idx_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield" ::: "memory");
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+//! Try to consume a posted completion.
+static inline osal_bool_t idx_waiter_consume(idx_waiter_t *waiter) {
+    osal_uint32_t expected = IDX_WAITER_POSTED;
+    return __atomic_compare_exchange_n(&waiter->state, &expected, IDX_WAITER_IDLE, 
+            0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ? OSAL_TRUE : OSAL_FALSE;
+}
+#endif
+
+//! Update adaptive spin time.
+/*!
+ * The spin time follows twice the observed completion latency, so 
+ * fast answers are picked up while spinning. Latencies beyond 
+ * \link LEC_INDEX_SPIN_MAX_NS \endlink let the spin time decay to zero.
+ *
+ * \param[in]   idx_q       Pointer to index queue.
+ * \param[in]   latency_ns  Observed completion latency.
+ */
+static void ec_index_spin_update(idx_queue_t *idx_q, osal_uint64_t latency_ns) {
+    osal_uint64_t target = 2u * latency_ns;
+    if (target > LEC_INDEX_SPIN_MAX_NS) {
+        target = (latency_ns > LEC_INDEX_SPIN_MAX_NS) ? 0u : LEC_INDEX_SPIN_MAX_NS;
+    }
+
+    osal_uint64_t spin_ns = __atomic_load_n(&idx_q->spin_ns, __ATOMIC_RELAXED);
+    __atomic_store_n(&idx_q->spin_ns, ((3u * spin_ns) + target) / 4u, __ATOMIC_RELAXED);
+}
+
+//! Reset waiter of index entry, drops stale completions.
+static void ec_index_wait_reset(idx_entry_t *entry) {
+#if defined(__linux__)
+    __atomic_store_n(&entry->waiter.state, IDX_WAITER_IDLE, __ATOMIC_RELAXED);
+#else
+    (void)osal_binary_semaphore_trywait(&entry->waiter.sem);
+#endif
+}
+
+//! Claim next free index within range.
+/*!
+ * Searches round robin from the index behind the one claimed last in this
+ * range. The start word is visited twice, first from the start bit up, 
+ * after wrapping around below it.
+ *
+ * \param[in]   idx_q   Pointer to index queue.
+ * \param[in]   cyclic  Search reserved cyclic (OSAL_TRUE) or common (OSAL_FALSE) range.
+ *
+ * \return claimed index or -1 if none is free
+ */
+static int ec_index_claim(idx_queue_t *idx_q, osal_bool_t cyclic) {
+    int ret = -1;
+    osal_uint32_t *next = &idx_q->next[(cyclic == OSAL_TRUE) ? 1 : 0];
+    osal_uint32_t start = __atomic_load_n(next, __ATOMIC_RELAXED) % LEC_MAX_INDEX;
+    osal_uint64_t upper = ~(osal_uint64_t)0u << (start % 64u);
+
+    for (osal_uint32_t k = 0u; (ret == -1) && (k <= LEC_INDEX_WORDS); ++k) {
+        osal_uint32_t w = ((start / 64u) + k) % LEC_INDEX_WORDS;
+        osal_uint64_t mask = (cyclic == OSAL_TRUE) ? idx_q->cyclic_map[w] : ~idx_q->cyclic_map[w];
+        osal_uint64_t old_map = __atomic_load_n(&idx_q->free_map[w], __ATOMIC_RELAXED);
+
+        if (k == 0u) {
+            mask &= upper;
+        } else if (k == LEC_INDEX_WORDS) {
+            mask &= ~upper;
+        } else {}
+
+        while ((old_map & mask) != 0u) {
+            osal_uint32_t bit = (osal_uint32_t)__builtin_ctzll(old_map & mask);
+            osal_uint64_t new_map = old_map & ~((osal_uint64_t)1u << bit);
+
+            // on failure old_map is reloaded with the current value
+            if (__atomic_compare_exchange_n(&idx_q->free_map[w], &old_map, new_map, 
+                        0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                ret = (int)((w * 64u) + bit);
+                __atomic_store_n(next, (osal_uint32_t)ret + 1u, __ATOMIC_RELAXED);
+                break;
+            }
+        }
+    }
+
+    return ret;
+}
+
 //! Get next free index entry.
 /*!
  * \param[in]   idx_q   Pointer to index queue.
@@ -60,17 +165,45 @@ int ec_index_get(idx_queue_t *idx_q, struct idx_entry **entry) {
     assert(idx_q != NULL);
     assert(entry != NULL);
 
-    osal_mutex_lock(&idx_q->lock);
+    *entry = NULL;
 
-    *entry = (idx_entry_t *)TAILQ_FIRST(&idx_q->q);
-    if ((*entry) != NULL) {
-        TAILQ_REMOVE(&idx_q->q, *entry, qh);
+    int idx = ec_index_claim(idx_q, OSAL_FALSE);
+    if (idx >= 0) {
+        *entry = &idx_q->entries[idx];
         ret = EC_OK;
     
-        osal_binary_semaphore_trywait(&(*entry)->waiter);
+        ec_index_wait_reset(*entry);
+    }
+
+    return ret;
+}
+
+//! Get next free index entry for a cyclic datagram.
+/*!
+ * \param[in]   idx_q   Pointer to index queue.
+ * \param[out]  entry   Return entry of next free index.
+ *
+ * \return EC_OK on succes, otherwise error code
+ */
+int ec_index_get_cyclic(idx_queue_t *idx_q, struct idx_entry **entry) {
+    int ret = EC_ERROR_OUT_OF_INDICES;
+
+    assert(idx_q != NULL);
+    assert(entry != NULL);
+
+    *entry = NULL;
+
+    int idx = ec_index_claim(idx_q, OSAL_TRUE);
+    if (idx < 0) {
+        idx = ec_index_claim(idx_q, OSAL_FALSE);
     }
 
-    osal_mutex_unlock(&idx_q->lock);
+    if (idx >= 0) {
+        *entry = &idx_q->entries[idx];
+        ret = EC_OK;
+    
+        ec_index_wait_reset(*entry);
+    }
 
     return ret;
 }
@@ -84,9 +217,116 @@ void ec_index_put(idx_queue_t *idx_q, struct idx_entry *entry) {
     assert(idx_q != NULL);
     assert(entry != NULL);
 
-    osal_mutex_lock(&idx_q->lock);
-    TAILQ_INSERT_TAIL(&idx_q->q, entry, qh);
-    osal_mutex_unlock(&idx_q->lock);
+    osal_uint64_t bit = (osal_uint64_t)1u << (entry->idx % 64u);
+    osal_uint64_t old_map = __atomic_fetch_or(&idx_q->free_map[entry->idx / 64u], bit, __ATOMIC_RELEASE);
+    assert((old_map & bit) == 0u);
+    (void)old_map;
+}
+
+//! Signal completion of index entry.
+/*!
+ * \param[in]  entry    Index entry to signal.
+ */
+void ec_index_complete(struct idx_entry *entry) {
+    assert(entry != NULL);
+
+#if defined(__linux__)
+    if (__atomic_exchange_n(&entry->waiter.state, IDX_WAITER_POSTED, __ATOMIC_RELEASE) == IDX_WAITER_SLEEPING) {
+        (void)syscall(SYS_futex, &entry->waiter.state, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+#else
+    (void)osal_binary_semaphore_post(&entry->waiter.sem);
+#endif
+}
+
+//! Wait for completion of index entry.
+/*!
+ * \param[in]  idx_q    Pointer to index queue.
+ * \param[in]  entry    Index entry to wait for.
+ * \param[in]  timeout  Absolute timeout.
+ *
+ * \return EC_OK on completion, EC_ERROR_TIMEOUT on timeout, otherwise error code
+ */
+int ec_index_wait(idx_queue_t *idx_q, struct idx_entry *entry, osal_timer_t *timeout) {
+    int ret = EC_ERROR_TIMEOUT;
+
+    assert(idx_q != NULL);
+    assert(entry != NULL);
+    assert(timeout != NULL);
+
+    osal_uint64_t start = osal_timer_gettime_nsec();
+
+#if defined(__linux__)
+    osal_uint64_t deadline = (timeout->sec * 1000000000u) + timeout->nsec;
+    osal_uint64_t spin_end = start + __atomic_load_n(&idx_q->spin_ns, __ATOMIC_RELAXED);
+    osal_uint64_t now = start;
+    osal_bool_t slept = OSAL_FALSE;
+
+    // spin phase, answers of short frames return within a few microseconds
+    do {
+        if (idx_waiter_consume(&entry->waiter) == OSAL_TRUE) {
+            ret = EC_OK;
+            break;
+        }
+
+        idx_cpu_relax();
+        now = osal_timer_gettime_nsec();
+    } while ((now < spin_end) && (now < deadline));
+
+    // sleep phase
+    while (ret != EC_OK) {
+        if (idx_waiter_consume(&entry->waiter) == OSAL_TRUE) {
+            ret = EC_OK;
+            break;
+        }
+
+        now = osal_timer_gettime_nsec();
+        if (now >= deadline) {
+            osal_uint32_t expected = IDX_WAITER_SLEEPING;
+            if (__atomic_compare_exchange_n(&entry->waiter.state, &expected, IDX_WAITER_IDLE, 
+                        0, __ATOMIC_RELAXED, __ATOMIC_RELAXED) || (expected == IDX_WAITER_IDLE)) {
+                ret = EC_ERROR_TIMEOUT;
+                break;
+            }
+
+            // posted meanwhile, consume it on next iteration
+            continue;
+        }
+
+        osal_uint32_t expected = IDX_WAITER_IDLE;
+        if (!__atomic_compare_exchange_n(&entry->waiter.state, &expected, IDX_WAITER_SLEEPING, 
+                    0, __ATOMIC_RELAXED, __ATOMIC_RELAXED) && (expected != IDX_WAITER_SLEEPING)) {
+            // posted meanwhile
+            continue;
+        }
+
+        struct timespec rel;
+        rel.tv_sec = (time_t)((deadline - now) / 1000000000u);
+        rel.tv_nsec = (long)((deadline - now) % 1000000000u);
+        slept = OSAL_TRUE;
+
+        if (syscall(SYS_futex, &entry->waiter.state, FUTEX_WAIT_PRIVATE, IDX_WAITER_SLEEPING, &rel, NULL, 0) == -1) {
+            if ((errno != EAGAIN) && (errno != EINTR) && (errno != ETIMEDOUT)) {
+                ret = EC_ERROR_UNAVAILABLE;
+                break;
+            }
+        }
+    }
+
+    if ((ret == EC_OK) || (slept == OSAL_TRUE)) {
+        ec_index_spin_update(idx_q, osal_timer_gettime_nsec() - start);
+    }
+#else
+    osal_retval_t local_ret = osal_binary_semaphore_timedwait(&entry->waiter.sem, timeout);
+    if (local_ret == OSAL_OK) {
+        ec_index_spin_update(idx_q, osal_timer_gettime_nsec() - start);
+        ret = EC_OK;
+    } else if (local_ret != OSAL_ERR_TIMEOUT) {
+        ret = EC_ERROR_UNAVAILABLE;
+    }
+#endif
+
+    return ret;
 }
 
 //! Initialize index queue structure.
@@ -103,21 +343,29 @@ int ec_index_init(idx_queue_t *idx_q) {
 
     assert(idx_q != NULL);
 
-    osal_mutex_attr_t lock_attr = OSAL_MUTEX_ATTR__PROTOCOL__INHERIT;
-    osal_mutex_init(&idx_q->lock, &lock_attr);
+    (void)memset(idx_q->cyclic_map, 0, sizeof(idx_q->cyclic_map));
+    for (i = 0; (i < LEC_MAX_INDEX_CYCLIC) && (i < LEC_MAX_INDEX); ++i) {
+        idx_q->cyclic_map[i / 64u] |= (osal_uint64_t)1u << (i % 64u);
+    }
     
     // fill index queue
-    TAILQ_INIT(&idx_q->q);
+    for (i = 0; i < LEC_INDEX_WORDS; ++i) {
+        __atomic_store_n(&idx_q->free_map[i], ~(osal_uint64_t)0u, __ATOMIC_RELEASE);
+    }
+
     for (i = 0; i < LEC_MAX_INDEX; ++i) {
         idx_entry_t *entry = &idx_q->entries[i];
         entry->idx = i;
-        osal_binary_semaphore_init(&entry->waiter, NULL);
-        (void)ec_index_put(idx_q, entry);
+#if defined(__linux__)
+        __atomic_store_n(&entry->waiter.state, IDX_WAITER_IDLE, __ATOMIC_RELAXED);
+#else
+        osal_binary_semaphore_init(&entry->waiter.sem, NULL);
+#endif
     }
 
-    if (ret != EC_OK) {
-        ec_index_deinit(idx_q);
-    }
+    idx_q->next[0] = 0u;
+    idx_q->next[1] = 0u;
+    idx_q->spin_ns = LEC_INDEX_SPIN_MAX_NS / 4u;
 
     return ret;
 }
@@ -131,14 +379,14 @@ int ec_index_init(idx_queue_t *idx_q) {
 void ec_index_deinit(idx_queue_t *idx_q) {
     assert(idx_q != NULL);
 
-    idx_entry_t *idx = TAILQ_FIRST(&idx_q->q);
-    while (idx != NULL) {
-        TAILQ_REMOVE(&idx_q->q, idx, qh);
-        osal_binary_semaphore_destroy(&idx->waiter);
-
-        idx = TAILQ_FIRST(&idx_q->q);
+    for (osal_uint32_t i = 0; i < LEC_INDEX_WORDS; ++i) {
+        __atomic_store_n(&idx_q->free_map[i], 0u, __ATOMIC_RELEASE);
     }
 
-    osal_mutex_destroy(&idx_q->lock);
+#if !defined(__linux__)
+    for (osal_uint32_t i = 0; i < LEC_MAX_INDEX; ++i) {
+        osal_binary_semaphore_destroy(&idx_q->entries[i].waiter.sem);
+    }
+#endif
 }
 
@@ -0,0 +1,523 @@
+/**
+ * \file log.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief deferred logging
+ *
+ * Messages are stored as format pointer and raw arguments in a lock-free 
+ * ring, a low priority task formats them later. This keeps vsnprintf out 
+ * of the realtime path.
+ */
+
+/*
+ * This file is part of libethercat.
+ *
+ * libethercat is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * libethercat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with libethercat (LICENSE.LGPL-V3); if not, write 
+ * to the Free Software Foundation, Inc., 51 Franklin Street, Fifth 
+ * Floor, Boston, MA  02110-1301, USA.
+ * 
+ * Please note that the use of the EtherCAT technology, the EtherCAT 
+ * brand name and the EtherCAT logo is only permitted if the property 
+ * rights of Beckhoff Automation GmbH are observed. For further 
+ * information please contact Beckhoff Automation GmbH & Co. KG, 
+ * Hülshorstweg 20, D-33415 Verl, Germany (www.beckhoff.com) or the 
+ * EtherCAT Technology Group, Ostendstraße 196, D-90482 Nuremberg, 
+ * Germany (ETG, www.ethercat.org).
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libethercat/config.h>
+#endif
+
+#include "libethercat/log.h"
+#include "libethercat/ec.h"
+#include "libethercat/error_codes.h"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define EC_LOG_DRAIN_IDLE_NS    (1000000u)  //!< \brief Drain task sleep time if ring is empty.
+#define EC_LOG_BUF_SIZE         (512u)      //!< \brief Size of formatted message.
+
+//! Parsed conversion specification.
+typedef struct ec_log_spec {
+    osal_char_t flags[8];       //!< \brief Flag characters.
+    int width;                  //!< \brief Field width, -1 if none.
+    int precision;              //!< \brief Precision, -1 if none.
+    osal_bool_t width_arg;      //!< \brief Width passed as argument.
+    osal_bool_t precision_arg;  //!< \brief Precision passed as argument.
+    osal_char_t length[3];      //!< \brief Length modifier.
+    osal_char_t conv;           //!< \brief Conversion character, 0 if incomplete.
+} ec_log_spec_t;
+
+//! Parse conversion specification.
+/*!
+ * \param[in]  p           Character following '%'.
+ * \param[out] spec        Parsed specification.
+ *
+ * \return Character following the conversion.
+ */
+static const osal_char_t *ec_log_spec_parse(const osal_char_t *p, ec_log_spec_t *spec) {
+    osal_size_t i = 0u;
+
+    (void)memset(spec, 0, sizeof(*spec));
+    spec->width = -1;
+    spec->precision = -1;
+
+    while ((strchr("-+ #0'", *p) != NULL) && (*p != '\0')) {
+        if (i < (sizeof(spec->flags) - 1u)) {
+            spec->flags[i] = *p;
+            i++;
+        }
+        p++;
+    }
+
+    if (*p == '*') {
+        spec->width_arg = OSAL_TRUE;
+        p++;
+    } else {
+        while ((*p >= '0') && (*p <= '9')) {
+            spec->width = (spec->width < 0 ? 0 : spec->width * 10) + (*p - '0');
+            p++;
+        }
+    }
+
+    if (*p == '.') {
+        p++;
+        spec->precision = 0;
+        if (*p == '*') {
+            spec->precision_arg = OSAL_TRUE;
+            p++;
+        } else {
+            while ((*p >= '0') && (*p <= '9')) {
+                spec->precision = (spec->precision * 10) + (*p - '0');
+                p++;
+            }
+        }
+    }
+
+    i = 0u;
+    while ((strchr("hlqLjzt", *p) != NULL) && (*p != '\0')) {
+        if (i < (sizeof(spec->length) - 1u)) {
+            spec->length[i] = *p;
+            i++;
+        }
+        p++;
+    }
+
+    if (*p != '\0') {
+        spec->conv = *p;
+        p++;
+    }
+
+    return p;
+}
+
+//! Fetch signed integer argument according to length modifier.
+static osal_int64_t ec_log_arg_signed(const osal_char_t *length, va_list *args) {
+    osal_int64_t val;
+
+    if (strcmp(length, "hh") == 0)      { val = (signed char)va_arg(*args, int); }
+    else if (strcmp(length, "h") == 0)  { val = (short)va_arg(*args, int); }
+    else if (strcmp(length, "l") == 0)  { val = va_arg(*args, long); }
+    else if ((strcmp(length, "ll") == 0) || (strcmp(length, "q") == 0)) 
+                                        { val = va_arg(*args, long long); }
+    else if (strcmp(length, "j") == 0)  { val = va_arg(*args, intmax_t); }
+    else if (strcmp(length, "z") == 0)  { val = va_arg(*args, osal_ssize_t); }
+    else if (strcmp(length, "t") == 0)  { val = va_arg(*args, ptrdiff_t); }
+    else                                { val = va_arg(*args, int); }
+
+    return val;
+}
+
+//! Fetch unsigned integer argument according to length modifier.
+static osal_uint64_t ec_log_arg_unsigned(const osal_char_t *length, va_list *args) {
+    osal_uint64_t val;
+
+    if (strcmp(length, "hh") == 0)      { val = (unsigned char)va_arg(*args, unsigned int); }
+    else if (strcmp(length, "h") == 0)  { val = (unsigned short)va_arg(*args, unsigned int); }
+    else if (strcmp(length, "l") == 0)  { val = va_arg(*args, unsigned long); }
+    else if ((strcmp(length, "ll") == 0) || (strcmp(length, "q") == 0)) 
+                                        { val = va_arg(*args, unsigned long long); }
+    else if (strcmp(length, "j") == 0)  { val = va_arg(*args, uintmax_t); }
+    else if (strcmp(length, "z") == 0)  { val = va_arg(*args, osal_size_t); }
+    else if (strcmp(length, "t") == 0)  { val = (osal_uint64_t)va_arg(*args, ptrdiff_t); }
+    else                                { val = va_arg(*args, unsigned int); }
+
+    return val;
+}
+
+//! Store raw arguments of message in record.
+/*!
+ * \param[out] rec         Record to fill.
+ * \param[in]  format      Format string.
+ * \param[in]  args        Format arguments.
+ *
+ * \retval EC_OK                    Arguments stored.
+ * \retval EC_ERROR_OUT_OF_MEMORY   Too many arguments or strings too long.
+ * \retval EC_ERROR_UNAVAILABLE     Conversion not supported.
+ */
+static int ec_log_capture(ec_log_record_t *rec, const osal_char_t *format, va_list *args) {
+    int ret = EC_OK;
+    osal_size_t arg_cnt = 0u;
+    osal_size_t str_len = 0u;
+    const osal_char_t *p = format;
+
+    while ((ret == EC_OK) && (*p != '\0')) {
+        if (*p != '%') {
+            p++;
+            continue;
+        }
+
+        ec_log_spec_t spec;
+        p = ec_log_spec_parse(&p[1], &spec);
+        if (spec.conv == '%') {
+            continue;
+        }
+
+        osal_size_t needed = 1u + (spec.width_arg ? 1u : 0u) + (spec.precision_arg ? 1u : 0u);
+        if ((arg_cnt + needed) > EC_LOG_MAX_ARGS) {
+            ret = EC_ERROR_OUT_OF_MEMORY;
+            break;
+        }
+
+        if (spec.width_arg == OSAL_TRUE) {
+            rec->args[arg_cnt] = (osal_uint64_t)(osal_int64_t)va_arg(*args, int);
+            arg_cnt++;
+        }
+
+        int precision = spec.precision;
+        if (spec.precision_arg == OSAL_TRUE) {
+            precision = va_arg(*args, int);
+            rec->args[arg_cnt] = (osal_uint64_t)(osal_int64_t)precision;
+            arg_cnt++;
+        }
+
+        switch (spec.conv) {
+            case 'd':
+            case 'i':
+                rec->args[arg_cnt] = (osal_uint64_t)ec_log_arg_signed(spec.length, args);
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                rec->args[arg_cnt] = ec_log_arg_unsigned(spec.length, args);
+                break;
+            case 'c':
+                if (spec.length[0] != '\0') {
+                    ret = EC_ERROR_UNAVAILABLE;
+                } else {
+                    rec->args[arg_cnt] = (osal_uint64_t)(osal_int64_t)va_arg(*args, int);
+                }
+                break;
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                if (spec.length[0] == 'L') {
+                    ret = EC_ERROR_UNAVAILABLE;
+                } else {
+                    double val = va_arg(*args, double);
+                    (void)memcpy(&rec->args[arg_cnt], &val, sizeof(val));
+                }
+                break;
+            case 's': {
+                if (spec.length[0] != '\0') {
+                    ret = EC_ERROR_UNAVAILABLE;
+                    break;
+                }
+
+                const osal_char_t *str = va_arg(*args, const osal_char_t *);
+                if (str == NULL) {
+                    str = "(null)";
+                }
+
+                // strings with precision need not be terminated
+                osal_size_t room = EC_LOG_STR_SIZE - str_len;
+                osal_size_t len = (precision >= 0) ? strnlen(str, (osal_size_t)precision) : strnlen(str, room);
+                if (len >= room) {
+                    ret = EC_ERROR_OUT_OF_MEMORY;
+                } else {
+                    (void)memcpy(&rec->str[str_len], str, len);
+                    rec->str[str_len + len] = '\0';
+                    rec->args[arg_cnt] = str_len;
+                    str_len += len + 1u;
+                }
+                break;
+            }
+            case 'p':
+                rec->args[arg_cnt] = (osal_uint64_t)(uintptr_t)va_arg(*args, void *);
+                break;
+            default:
+                // %n, wide characters and incomplete specifications
+                ret = EC_ERROR_UNAVAILABLE;
+                break;
+        }
+
+        arg_cnt++;
+    }
+
+    return ret;
+}
+
+//! Format record.
+/*!
+ * \param[in]  rec         Record to format.
+ * \param[out] buf         Return buffer for formatted message.
+ * \param[in]  size        Size of buf.
+ */
+static void ec_log_render(const ec_log_record_t *rec, osal_char_t *buf, osal_size_t size) {
+    osal_size_t pos = 0u;
+    osal_size_t arg_cnt = 0u;
+    const osal_char_t *p = rec->format;
+
+#define EC_LOG_ADVANCE(n) { \
+    int tmp_n = (n); \
+    if (tmp_n > 0) { pos += (osal_size_t)tmp_n; } \
+    if (pos >= size) { pos = size - 1u; } }
+
+    EC_LOG_ADVANCE(snprintf(buf, size, "%-20.20s: ", rec->pre));
+
+    if (rec->rendered == OSAL_TRUE) {
+        EC_LOG_ADVANCE(snprintf(&buf[pos], size - pos, "%s", rec->str));
+        p = "";
+    }
+
+    while ((*p != '\0') && (pos < (size - 1u))) {
+        if (*p != '%') {
+            buf[pos] = *p;
+            pos++;
+            p++;
+            continue;
+        }
+
+        ec_log_spec_t spec;
+        p = ec_log_spec_parse(&p[1], &spec);
+        if (spec.conv == '%') {
+            buf[pos] = '%';
+            pos++;
+            continue;
+        }
+
+        // rebuild specification with resolved width and precision
+        osal_char_t fmt[40];
+        int fmt_len = snprintf(fmt, sizeof(fmt), "%%%s", spec.flags);
+        int width = spec.width;
+        if (spec.width_arg == OSAL_TRUE) {
+            width = (int)(osal_int64_t)rec->args[arg_cnt];
+            arg_cnt++;
+        }
+        if (spec.width_arg || (width >= 0)) {
+            fmt_len += snprintf(&fmt[fmt_len], sizeof(fmt) - (osal_size_t)fmt_len, "%d", width);
+        }
+        int precision = spec.precision;
+        if (spec.precision_arg == OSAL_TRUE) {
+            precision = (int)(osal_int64_t)rec->args[arg_cnt];
+            arg_cnt++;
+        }
+        if (precision >= 0) {
+            fmt_len += snprintf(&fmt[fmt_len], sizeof(fmt) - (osal_size_t)fmt_len, ".%d", precision);
+        }
+
+        osal_uint64_t arg = rec->args[arg_cnt];
+        arg_cnt++;
+
+        switch (spec.conv) {
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                (void)snprintf(&fmt[fmt_len], sizeof(fmt) - (osal_size_t)fmt_len, "ll%c", spec.conv);
+                if ((spec.conv == 'd') || (spec.conv == 'i')) {
+                    EC_LOG_ADVANCE(snprintf(&buf[pos], size - pos, fmt, (long long)(osal_int64_t)arg));
+                } else {
+                    EC_LOG_ADVANCE(snprintf(&buf[pos], size - pos, fmt, (unsigned long long)arg));
+                }
+                break;
+            case 'c':
+                (void)snprintf(&fmt[fmt_len], sizeof(fmt) - (osal_size_t)fmt_len, "c");
+                EC_LOG_ADVANCE(snprintf(&buf[pos], size - pos, fmt, (int)(osal_int64_t)arg));
+                break;
+            case 's':
+                (void)snprintf(&fmt[fmt_len], sizeof(fmt) - (osal_size_t)fmt_len, "s");
+                EC_LOG_ADVANCE(snprintf(&buf[pos], size - pos, fmt, &rec->str[arg]));
+                break;
+            case 'p':
+                (void)snprintf(&fmt[fmt_len], sizeof(fmt) - (osal_size_t)fmt_len, "p");
+                EC_LOG_ADVANCE(snprintf(&buf[pos], size - pos, fmt, (void *)(uintptr_t)arg));
+                break;
+            default: {
+                double val;
+                (void)memcpy(&val, &arg, sizeof(val));
+                (void)snprintf(&fmt[fmt_len], sizeof(fmt) - (osal_size_t)fmt_len, "%c", spec.conv);
+                EC_LOG_ADVANCE(snprintf(&buf[pos], size - pos, fmt, val));
+                break;
+            }
+        }
+    }
+
+#undef EC_LOG_ADVANCE
+
+    buf[pos] = '\0';
+}
+
+//! Output all pending messages.
+/*!
+ * \param[in] pec           Pointer to EtherCAT master structure.
+ *
+ * \return Number of messages output.
+ */
+static osal_size_t ec_log_drain(ec_t *pec) {
+    ec_log_ring_t *ring = &pec->log_ring;
+    osal_char_t buf[EC_LOG_BUF_SIZE];
+    osal_size_t cnt = 0u;
+
+    osal_uint64_t dropped = __atomic_exchange_n(&ring->dropped, 0u, __ATOMIC_RELAXED);
+    if (dropped > 0u) {
+        (void)snprintf(buf, sizeof(buf), "%-20.20s: %" PRIu64 " messages dropped, ring full\n", "LOG", dropped);
+        ec_log_output(pec, 1, buf);
+    }
+
+    // cppcheck-suppress misra-c2012-11.5
+    ec_log_record_t *rec = (ec_log_record_t *)ec_ring_peek(&ring->ring);
+    while (rec != NULL) {
+        ec_log_render(rec, buf, sizeof(buf));
+        int lvl = rec->lvl;
+
+        ec_ring_release(&ring->ring, rec);
+
+        ec_log_output(pec, lvl, buf);
+        cnt++;
+
+        // cppcheck-suppress misra-c2012-11.5
+        rec = (ec_log_record_t *)ec_ring_peek(&ring->ring);
+    }
+
+    return cnt;
+}
+
+//! Drain task.
+static void *ec_log_drain_thread(void *arg) {
+    ec_t *pec = (ec_t *)arg;
+
+    while (__atomic_load_n(&pec->log_ring.running, __ATOMIC_ACQUIRE) != 0) {
+        if (ec_log_drain(pec) == 0u) {
+            (void)osal_sleep(EC_LOG_DRAIN_IDLE_NS);
+        }
+    }
+
+    return NULL;
+}
+
+// Start deferred logging.
+int ec_log_deferred_start(ec_t *pec) {
+    assert(pec != NULL);
+    assert((LEC_LOG_RING_SIZE & (LEC_LOG_RING_SIZE - 1u)) == 0u);
+
+    ec_log_ring_t *ring = &pec->log_ring;
+    int ret = EC_OK;
+
+    if (__atomic_load_n(&ring->running, __ATOMIC_ACQUIRE) == 0) {
+        ec_ring_init(&ring->ring, &ring->records[0], sizeof(ring->records[0]), LEC_LOG_RING_SIZE);
+        ring->dropped = 0u;
+        __atomic_store_n(&ring->running, 1, __ATOMIC_RELEASE);
+
+        osal_task_attr_t attr;
+        attr.policy = OSAL_SCHED_POLICY_OTHER;
+        attr.priority = 0;
+        attr.affinity = 0xFF;
+        (void)memset(&attr.task_name[0], 0, sizeof(attr.task_name));
+        (void)memcpy(&attr.task_name[0], "ecat.log", strlen("ecat.log"));
+        if (osal_task_create(&ring->drain_tid, &attr, ec_log_drain_thread, pec) != OSAL_OK) {
+            __atomic_store_n(&ring->running, 0, __ATOMIC_RELEASE);
+            ec_log(1, "LOG", "error creating log drain task!\n");
+            ret = EC_ERROR_UNAVAILABLE;
+        }
+    }
+
+    return ret;
+}
+
+// Stop deferred logging.
+void ec_log_deferred_stop(ec_t *pec) {
+    assert(pec != NULL);
+
+    ec_log_ring_t *ring = &pec->log_ring;
+
+    if (__atomic_load_n(&ring->running, __ATOMIC_ACQUIRE) != 0) {
+        __atomic_store_n(&ring->running, 0, __ATOMIC_RELEASE);
+        (void)osal_task_join(&ring->drain_tid, NULL);
+
+        while (ec_log_drain(pec) > 0u) {}
+    }
+}
+
+// Store message in ring.
+int ec_log_deferred_push(ec_t *pec, int lvl, const osal_char_t *pre, 
+        const osal_char_t *format, va_list args) 
+{
+    assert(pec != NULL);
+    assert(pre != NULL);
+    assert(format != NULL);
+
+    ec_log_ring_t *ring = &pec->log_ring;
+    int ret = EC_ERROR_UNAVAILABLE;
+
+    if (__atomic_load_n(&ring->running, __ATOMIC_ACQUIRE) != 0) {
+        ret = EC_OK;
+
+        // claim slot, drop message if ring is full
+        // cppcheck-suppress misra-c2012-11.5
+        ec_log_record_t *rec = (ec_log_record_t *)ec_ring_claim(&ring->ring);
+
+        if (rec == NULL) {
+            (void)__atomic_add_fetch(&ring->dropped, 1u, __ATOMIC_RELAXED);
+        } else {
+            rec->lvl = lvl;
+            rec->format = format;
+            (void)strncpy(&rec->pre[0], pre, EC_LOG_PRE_SIZE - 1u);
+            rec->pre[EC_LOG_PRE_SIZE - 1u] = '\0';
+
+            va_list tmp_args;                   // cppcheck-suppress misra-c2012-17.1
+            va_copy(tmp_args, args);            // cppcheck-suppress misra-c2012-17.1
+            rec->rendered = OSAL_FALSE;
+            if (ec_log_capture(rec, format, &tmp_args) != EC_OK) {
+                // not storable as raw arguments, format right away
+                rec->rendered = OSAL_TRUE;
+                (void)vsnprintf(&rec->str[0], EC_LOG_STR_SIZE, format, args);
+            }
+            va_end(tmp_args);                   // cppcheck-suppress misra-c2012-17.1
+
+            ec_ring_publish(rec);
+        }
+    }
+
+    return ret;
+}
+
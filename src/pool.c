@@ -48,6 +48,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stddef.h>
 #include <string.h>
 // cppcheck-suppress misra-c2012-21.6
 #include <stdio.h>
@@ -222,3 +223,181 @@ void pool_put_head(pool_t *pp, pool_entry_t *entry) {
     osal_mutex_unlock(&pp->_pool_lock);
 }
 
+
+//! \brief Get pool entry from embedded MPSC queue handle.
+static inline pool_entry_t *pool_mpsc_entry(pool_mpsc_node_t *node) {
+    // cppcheck-suppress misra-c2012-11.3
+    return (pool_entry_t *)((osal_uint8_t *)node - offsetof(pool_entry_t, mpsc_qh));
+}
+
+//! \brief Link node at the end of the queue.
+static inline void pool_mpsc_push(pool_mpsc_t *pq, pool_mpsc_node_t *node) {
+    __atomic_store_n(&node->next, NULL, __ATOMIC_RELAXED);
+
+    // serialization point for producers, after the exchange the node 
+    // belongs to the queue, the consumer will see it once prev is linked.
+    pool_mpsc_node_t *prev = __atomic_exchange_n(&pq->head, node, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+}
+
+//! \brief Initialize a lock-free MPSC queue.
+/*!
+ * \param[in]   pq          Pointer to queue.
+ *
+ * \return EC_OK or error code
+ */
+int pool_mpsc_open(pool_mpsc_t *pq) {
+    assert(pq != NULL);
+
+    pq->stub.next = NULL;
+    pq->tail = &pq->stub;
+    __atomic_store_n(&pq->head, &pq->stub, __ATOMIC_RELEASE);
+
+    return EC_OK;
+}
+
+//! \brief Destroys a lock-free MPSC queue.
+/*!
+ * \param[in]   pq          Pointer to queue.
+ *
+ * \return EC_OK or error code
+ */
+int pool_mpsc_close(pool_mpsc_t *pq) {
+    assert(pq != NULL);
+
+    return pool_mpsc_open(pq);
+}
+
+//! \brief Enqueue entry, may be called concurrently from any thread.
+/*!
+ * \param[in]   pq          Pointer to queue.
+ * \param[in]   entry       Entry to enqueue.
+ */
+void pool_mpsc_put(pool_mpsc_t *pq, pool_entry_t *entry) {
+    assert(pq != NULL);
+    assert(entry != NULL);
+
+    pool_mpsc_push(pq, &entry->mpsc_qh);
+}
+
+//! \brief Dequeue oldest entry, consumer side only.
+/*!
+ * \param[in]   pq          Pointer to queue.
+ * \param[out]  entry       Returns pointer to pool entry.
+ *
+ * \return EC_OK or error code
+ */
+int pool_mpsc_get(pool_mpsc_t *pq, pool_entry_t **entry) {
+    assert(pq != NULL);
+    assert(entry != NULL);
+
+    int ret = EC_ERROR_UNAVAILABLE;
+    *entry = NULL;
+
+    pool_mpsc_node_t *tail = pq->tail;
+    pool_mpsc_node_t *next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+
+    if (tail == &pq->stub) {
+        if (next != NULL) {
+            // skip stub node
+            pq->tail = next;
+            tail = next;
+            next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+        } else {
+            tail = NULL;
+        }
+    }
+
+    if (tail != NULL) {
+        if ((next == NULL) && (tail == __atomic_load_n(&pq->head, __ATOMIC_ACQUIRE))) {
+            // tail is the last entry, re-insert stub behind it so we can 
+            // hand it out without loosing the queue anchor.
+            pool_mpsc_push(pq, &pq->stub);
+            next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+        }
+
+        // next == NULL here means a producer is just linking a new entry 
+        // behind tail, it will be returned on one of the next calls.
+        if (next != NULL) {
+            pq->tail = next;
+            *entry = pool_mpsc_entry(tail);
+            ret = EC_OK;
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Get oldest entry without dequeuing it, consumer side only.
+/*!
+ * \param[in]   pq          Pointer to queue.
+ * \param[out]  entry       Returns pointer to pool entry.
+ *
+ * \return EC_OK or error code
+ */
+int pool_mpsc_peek(pool_mpsc_t *pq, pool_entry_t **entry) {
+    assert(pq != NULL);
+    assert(entry != NULL);
+
+    int ret = EC_ERROR_UNAVAILABLE;
+    *entry = NULL;
+
+    pool_mpsc_node_t *tail = pq->tail;
+
+    if (tail == &pq->stub) {
+        pool_mpsc_node_t *next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+        if (next != NULL) {
+            // skip stub node, same as pool_mpsc_get does
+            pq->tail = next;
+        }
+
+        tail = next;
+    }
+
+    if (tail != NULL) {
+        *entry = pool_mpsc_entry(tail);
+        ret = EC_OK;
+    }
+
+    return ret;
+}
+
+//! \brief Remove entry from queue if it is still queued, consumer side only.
+/*!
+ * \param[in]   pq          Pointer to queue.
+ * \param[in]   entry       Entry to remove.
+ *
+ * \return EC_OK or error code
+ */
+int pool_mpsc_remove(pool_mpsc_t *pq, pool_entry_t *entry) {
+    assert(pq != NULL);
+    assert(entry != NULL);
+
+    int ret = EC_ERROR_UNAVAILABLE;
+    pool_mpsc_node_t *stack = NULL;
+    pool_entry_t *tmp = NULL;
+
+    // drain queue up to entry, dequeued nodes are no longer referenced by 
+    // any producer so their link can be used to stack them.
+    while (pool_mpsc_get(pq, &tmp) == EC_OK) {
+        if (tmp == entry) {
+            ret = EC_OK;
+            break;
+        }
+
+        tmp->mpsc_qh.next = stack;
+        stack = &tmp->mpsc_qh;
+    }
+
+    // the consumer owns the tail, so it may prepend nodes. popping the stack
+    // restores the original order.
+    while (stack != NULL) {
+        pool_mpsc_node_t *node = stack;
+        stack = node->next;
+
+        node->next = pq->tail;
+        pq->tail = node;
+    }
+
+    return ret;
+}
@@ -0,0 +1,133 @@
+/**
+ * \file ring.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief bounded lock-free ring of fixed size slots
+ *
+ */
+
+/*
+ * This file is part of libethercat.
+ *
+ * libethercat is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * libethercat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with libethercat (LICENSE.LGPL-V3); if not, write 
+ * to the Free Software Foundation, Inc., 51 Franklin Street, Fifth 
+ * Floor, Boston, MA  02110-1301, USA.
+ * 
+ * Please note that the use of the EtherCAT technology, the EtherCAT 
+ * brand name and the EtherCAT logo is only permitted if the property 
+ * rights of Beckhoff Automation GmbH are observed. For further 
+ * information please contact Beckhoff Automation GmbH & Co. KG, 
+ * Hülshorstweg 20, D-33415 Verl, Germany (www.beckhoff.com) or the 
+ * EtherCAT Technology Group, Ostendstraße 196, D-90482 Nuremberg, 
+ * Germany (ETG, www.ethercat.org).
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libethercat/config.h>
+#endif
+
+#include "libethercat/ring.h"
+
+#include <assert.h>
+
+//! Sequence number of slot.
+static osal_uint64_t *ec_ring_seq(ec_ring_t *ring, osal_uint64_t pos) {
+    // cppcheck-suppress misra-c2012-11.3
+    return (osal_uint64_t *)&ring->slots[(pos & (ring->size - 1u)) * ring->slot_size];
+}
+
+// Initialize empty ring.
+void ec_ring_init(ec_ring_t *ring, void *slots, osal_size_t slot_size, osal_uint64_t size) {
+    assert(ring != NULL);
+    assert(slots != NULL);
+    assert(slot_size >= sizeof(osal_uint64_t));
+    assert((size > 0u) && ((size & (size - 1u)) == 0u));
+
+    // cppcheck-suppress misra-c2012-11.5
+    ring->slots = (osal_uint8_t *)slots;
+    ring->slot_size = slot_size;
+    ring->size = size;
+    ring->enqueue_pos = 0u;
+    ring->dequeue_pos = 0u;
+
+    for (osal_uint64_t i = 0u; i < size; ++i) {
+        *ec_ring_seq(ring, i) = i;
+    }
+}
+
+// Claim next free slot.
+void *ec_ring_claim(ec_ring_t *ring) {
+    assert(ring != NULL);
+
+    osal_uint64_t *seq = NULL;
+    osal_uint64_t pos = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+
+    for (;;) {
+        osal_uint64_t *slot_seq = ec_ring_seq(ring, pos);
+        osal_int64_t diff = (osal_int64_t)(__atomic_load_n(slot_seq, __ATOMIC_ACQUIRE) - pos);
+
+        if (diff == 0) {
+            // slot free in this round, take it unless another producer was faster
+            if (__atomic_compare_exchange_n(&ring->enqueue_pos, &pos, pos + 1u, 
+                        1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                seq = slot_seq;
+                break;
+            }
+        } else if (diff < 0) {
+            // slot still holds data of the last round, ring full
+            break;
+        } else {
+            pos = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    return seq;
+}
+
+// Hand filled slot to consumer.
+void ec_ring_publish(void *slot) {
+    assert(slot != NULL);
+
+    // cppcheck-suppress misra-c2012-11.5
+    osal_uint64_t *seq = (osal_uint64_t *)slot;
+    __atomic_store_n(seq, *seq + 1u, __ATOMIC_RELEASE);
+}
+
+// Get oldest published slot.
+void *ec_ring_peek(ec_ring_t *ring) {
+    assert(ring != NULL);
+
+    osal_uint64_t *seq = ec_ring_seq(ring, ring->dequeue_pos);
+    if (__atomic_load_n(seq, __ATOMIC_ACQUIRE) != (ring->dequeue_pos + 1u)) {
+        seq = NULL;
+    }
+
+    return seq;
+}
+
+// Give consumed slot back to producers.
+void ec_ring_release(ec_ring_t *ring, void *slot) {
+    assert(ring != NULL);
+    assert(slot != NULL);
+
+    // cppcheck-suppress misra-c2012-11.5
+    osal_uint64_t *seq = (osal_uint64_t *)slot;
+    __atomic_store_n(seq, ring->dequeue_pos + ring->size, __ATOMIC_RELEASE);
+    ring->dequeue_pos++;
+}
+
@@ -0,0 +1,193 @@
+/**
+ * \file trace.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief cycle timeline tracer
+ *
+ */
+
+/*
+ * This file is part of libethercat.
+ *
+ * libethercat is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * libethercat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License along with libethercat (LICENSE.LGPL-V3); if not, write 
+ * to the Free Software Foundation, Inc., 51 Franklin Street, Fifth 
+ * Floor, Boston, MA  02110-1301, USA.
+ * 
+ * Please note that the use of the EtherCAT technology, the EtherCAT 
+ * brand name and the EtherCAT logo is only permitted if the property 
+ * rights of Beckhoff Automation GmbH are observed. For further 
+ * information please contact Beckhoff Automation GmbH & Co. KG, 
+ * Hülshorstweg 20, D-33415 Verl, Germany (www.beckhoff.com) or the 
+ * EtherCAT Technology Group, Ostendstraße 196, D-90482 Nuremberg, 
+ * Germany (ETG, www.ethercat.org).
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libethercat/config.h>
+#endif
+
+#include "libethercat/trace.h"
+#include "libethercat/error_codes.h"
+
+#include <libosal/timer.h>
+
+#include <assert.h>
+#include <inttypes.h>
+
+#if LIBETHERCAT_TRACE == 1 && LIBETHERCAT_BUILD_POSIX == 1
+#include <stdio.h>
+#endif
+
+#if LIBETHERCAT_TRACE == 1
+static ec_trace_ring_t ec_trace_rings[EC_TRACE_MAX_THREADS];    //!< \brief Rings of all threads.
+static osal_uint32_t ec_trace_ring_used = 0u;                   //!< \brief Bitmask of rings taken by registered threads.
+static __thread ec_trace_ring_t *ec_trace_ring = NULL;          //!< \brief Ring of calling thread, NULL if not registered.
+
+//! Event names shown in trace.
+static const osal_char_t *ec_trace_names[EC_TRACE_TYPE_CNT] = {
+    "cycle", "send_group", "send_dc", "frame_tx", "frame_rx", "datagram_cb", "user_cb" 
+};
+
+// claim ring for calling thread
+int ec_trace_register_thread(void) {
+    int ret = EC_OK;
+
+    if (ec_trace_ring == NULL) {
+        osal_uint32_t used = __atomic_load_n(&ec_trace_ring_used, __ATOMIC_RELAXED);
+        osal_uint32_t n = 0u;
+
+        do {
+            osal_uint32_t free_mask = ~used & ((1u << EC_TRACE_MAX_THREADS) - 1u);
+            if (free_mask == 0u) {
+                ret = EC_ERROR_UNAVAILABLE;
+                break;
+            }
+
+            n = (osal_uint32_t)__builtin_ctz(free_mask);
+        } while (__atomic_compare_exchange_n(&ec_trace_ring_used, &used, used | (1u << n), 
+                    0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) == 0);
+
+        if (ret == EC_OK) {
+            ec_trace_rings[n].tid = n + 1u;
+            ec_trace_ring = &ec_trace_rings[n];
+        }
+    }
+
+    return ret;
+}
+
+// release ring of calling thread
+void ec_trace_unregister_thread(void) {
+    ec_trace_ring_t *ring = ec_trace_ring;
+
+    if (ring != NULL) {
+        ec_trace_ring = NULL;
+        (void)__atomic_fetch_and(&ec_trace_ring_used, ~(1u << (ring->tid - 1u)), __ATOMIC_RELEASE);
+    }
+}
+
+// record event
+void ec_trace_record(ec_trace_type_t type, osal_uint8_t phase, osal_uint32_t arg) {
+    ec_trace_ring_t *ring = ec_trace_ring;
+
+    // events of unregistered threads are not recorded
+    if (ring != NULL) {
+        osal_uint64_t head = ring->head;
+        ec_trace_event_t *ev = &ring->events[head & (LEC_MAX_TRACE_EVENTS - 1u)];
+
+        ev->timestamp = osal_timer_gettime_nsec();
+        ev->arg = arg;
+        ev->type = (osal_uint8_t)type;
+        ev->phase = phase;
+
+        __atomic_store_n(&ring->head, head + 1u, __ATOMIC_RELEASE);
+    }
+}
+
+// drop all recorded events
+void ec_trace_reset(void) {
+    for (osal_uint32_t i = 0u; i < EC_TRACE_MAX_THREADS; ++i) {
+        __atomic_store_n(&ec_trace_rings[i].head, 0u, __ATOMIC_RELEASE);
+    }
+}
+#else
+// claim ring for calling thread
+int ec_trace_register_thread(void) {
+    return EC_ERROR_UNAVAILABLE;
+}
+
+// release ring of calling thread
+void ec_trace_unregister_thread(void) {
+}
+
+// record event
+void ec_trace_record(ec_trace_type_t type, osal_uint8_t phase, osal_uint32_t arg) {
+    (void)type;
+    (void)phase;
+    (void)arg;
+}
+
+// drop all recorded events
+void ec_trace_reset(void) {
+}
+#endif
+
+// write recorded events as chrome trace json
+int ec_trace_dump(const osal_char_t *path) {
+    assert(path != NULL);
+
+    int ret = EC_ERROR_UNAVAILABLE;
+
+#if LIBETHERCAT_TRACE == 1 && LIBETHERCAT_BUILD_POSIX == 1
+    FILE *fp = fopen(path, "w");
+    if (fp != NULL) {
+        const osal_char_t *sep = "";
+
+        (void)fprintf(fp, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+        // rings released by their threads still hold events
+        for (osal_uint32_t i = 0u; i < EC_TRACE_MAX_THREADS; ++i) {
+            ec_trace_ring_t *ring = &ec_trace_rings[i];
+            osal_uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+            osal_uint64_t first = (head > LEC_MAX_TRACE_EVENTS) ? (head - LEC_MAX_TRACE_EVENTS) : 0u;
+
+            for (osal_uint64_t pos = first; pos < head; ++pos) {
+                const ec_trace_event_t *ev = &ring->events[pos & (LEC_MAX_TRACE_EVENTS - 1u)];
+                if (ev->type >= (osal_uint8_t)EC_TRACE_TYPE_CNT) {
+                    continue;
+                }
+
+                (void)fprintf(fp, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%" PRIu64 ".%03u,"
+                        "\"pid\":1,\"tid\":%u,%s\"args\":{\"arg\":%u}}", sep, ec_trace_names[ev->type], 
+                        (char)ev->phase, ev->timestamp / 1000u, (unsigned)(ev->timestamp % 1000u), 
+                        ring->tid, (ev->phase == (osal_uint8_t)'i') ? "\"s\":\"t\"," : "", ev->arg);
+                sep = ",\n";
+            }
+        }
+
+        (void)fprintf(fp, "\n]}\n");
+
+        if (fclose(fp) == 0) {
+            ret = EC_OK;
+        }
+    }
+#endif
+
+    return ret;
+}
+
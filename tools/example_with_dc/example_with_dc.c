@@ -6,8 +6,6 @@
  * $Id$
  */
 
-#include <libosal/trace.h>
-
 #ifdef HAVE_CONFIG_H
 #include <libethercat/config.h>
 #endif
@@ -56,6 +54,18 @@ static struct hw_sock_raw hw_sock_raw;
 #include <libethercat/hw_sock_raw_mmaped.h>
 static struct hw_sock_raw_mmaped hw_sock_raw_mmaped;
 #endif
+#if LIBETHERCAT_BUILD_DEVICE_XDP == 1
+#include <libethercat/hw_xdp.h>
+static struct hw_xdp hw_xdp;
+#endif
+#if LIBETHERCAT_BUILD_DEVICE_URING == 1
+#include <libethercat/hw_uring.h>
+static struct hw_uring hw_uring;
+#endif
+#if LIBETHERCAT_BUILD_DEVICE_REPLAY == 1
+#include <libethercat/hw_replay.h>
+static struct hw_replay hw_replay;
+#endif
 
 #include <signal.h>
 
@@ -114,11 +124,6 @@ static ec_dc_mode_t dc_mode = dc_mode_master_as_ref_clock;
 osal_retval_t (*wait_time)(osal_uint64_t) = osal_sleep_until_nsec;
 
 osal_uint64_t last_sent;
-osal_trace_t *tx_start;
-osal_trace_t *tx_duration;
-osal_trace_t *rx_duration;
-osal_trace_t *roundtrip_duration;
-osal_trace_t *dc_diff;
 
 osal_size_t bytes_last_sent = 0;
 
@@ -128,7 +133,9 @@ static osal_void_t* cyclic_task(osal_void_t* param) {
     ec_t *pec = (ec_t *)param;
     osal_uint64_t abs_timeout = osal_timer_gettime_nsec();
     abs_timeout = (abs_timeout / pec->main_cycle_interval) * pec->main_cycle_interval;
-    osal_uint64_t time_start = 0u;
+
+    // only registered threads are recorded by the cycle tracer
+    (void)ec_trace_register_thread();
 
     osal_task_sched_priority_t prio;
     osal_task_get_priority(NULL, &prio);
@@ -142,23 +149,21 @@ static osal_void_t* cyclic_task(osal_void_t* param) {
         (void)wait_time(abs_timeout);
 
         last_sent = abs_timeout - pec->dc.rtc_sto;
-        time_start = osal_trace_point(tx_start);
-        
-        osal_trace_time(rx_duration, pec->phw->last_rx_duration_ns);
 
-        // execute one EtherCAT cycle
+        // execute one EtherCAT cycle, cyclic datagrams are built in place
+        hw_tx_frame_open(pec->phw);
         ec_send_distributed_clocks_sync(pec);
         ec_send_process_data(pec);
 
         // transmit cyclic packets (and also acyclic if there are any)
-        if (hw_tx_high(pec->phw) == OSAL_TRUE) hw_rx(pec->phw);
+        if (hw_tx_frame_close(pec->phw) == OSAL_TRUE) hw_rx(pec->phw);
 
-        osal_trace_time(tx_duration, pec->phw->last_tx_duration_ns);
         bytes_last_sent = ec.phw->bytes_last_sent;
         
         if (hw_tx_low(pec->phw) == OSAL_TRUE) hw_rx(pec->phw);
     }
 
+    ec_trace_unregister_thread();
     ec_log(100, "CYCLIC_TASK", "exiting!\n");
 }
 
@@ -287,13 +292,6 @@ int main(int argc, char **argv) {
     }
 #endif
 
-    int num_samples = 1. / (cycle_rate * 1E-9);
-    osal_trace_alloc(&tx_start, num_samples);
-    osal_trace_alloc(&tx_duration, num_samples);
-    osal_trace_alloc(&rx_duration, num_samples);
-    osal_trace_alloc(&roundtrip_duration, num_samples);
-    osal_trace_alloc(&dc_diff, num_samples);
-
     // use our log function
     pec->ec_log_func_user = NULL;
     pec->ec_log_func = &no_verbose_log;
@@ -362,6 +360,43 @@ int main(int argc, char **argv) {
         }
     }
 #endif
+#if LIBETHERCAT_BUILD_DEVICE_XDP == 1
+    if (strncmp(intf, "xdp:", 4) == 0) {
+        intf = &intf[4];
+
+        ec_log(10, "HW_OPEN", "Opening interface as AF_XDP: %s\n", intf);
+        ret = hw_device_xdp_open(&hw_xdp, pec, intf, base_prio, base_affinity);
+
+        if (ret == 0) {
+            phw = &hw_xdp.common;
+        }
+    }
+#endif
+#if LIBETHERCAT_BUILD_DEVICE_URING == 1
+    if ((strncmp(intf, "uring:", 6) == 0) || (strncmp(intf, "uring-sqpoll:", 13) == 0)) {
+        osal_bool_t sqpoll = (intf[5] == '-') ? OSAL_TRUE : OSAL_FALSE;
+        intf = (sqpoll == OSAL_TRUE) ? &intf[13] : &intf[6];
+
+        ec_log(10, "HW_OPEN", "Opening interface with io_uring%s: %s\n", sqpoll == OSAL_TRUE ? " (SQPOLL)" : "", intf);
+        ret = hw_device_uring_open(&hw_uring, pec, intf, base_prio, base_affinity, sqpoll);
+
+        if (ret == 0) {
+            phw = &hw_uring.common;
+        }
+    }
+#endif
+#if LIBETHERCAT_BUILD_DEVICE_REPLAY == 1
+    if (strncmp(intf, "replay:", 7) == 0) {
+        intf = &intf[7];
+
+        ec_log(10, "HW_OPEN", "Replaying recorded session: %s\n", intf);
+        ret = hw_device_replay_open(&hw_replay, pec, intf);
+
+        if (ret == 0) {
+            phw = &hw_replay.common;
+        }
+    }
+#endif
 
     if (phw == NULL) {
         ec_log(10, "HW_OPEN", "Hardware device layer failure!\n");
@@ -414,8 +449,6 @@ int main(int argc, char **argv) {
 			}
 
                         act_cycle_rate = cycle_rate + correction; //ec.dc.timer_correction;
-
-                        osal_trace_time(dc_diff, ec.dc.act_diff);
                     }
                 } &anon_cb; }), NULL);
 
@@ -429,16 +462,7 @@ int main(int argc, char **argv) {
     // -----------------------------------------------------------
     // creating process data groups
     ec_create_pd_groups(&ec, 1);
-    ec_configure_pd_group(&ec, 0, 1, ({
-                void anon_cb(void *arg, int num) { 
-                    struct ec *pec = (struct ec *)arg;
-
-                    osal_uint64_t time_end = osal_timer_gettime_nsec();
-                    osal_uint64_t time_start = osal_trace_get_last_time(tx_start);
-
-                    osal_trace_time(roundtrip_duration, time_end - time_start);
-                    //osal_trace_time(roundtrip_duration, pec->dc.packet_duration);//time_end - time_start);
-                } &anon_cb; }), &ec);
+    ec_configure_pd_group(&ec, 0, 1, NULL, NULL);
         
     ec.pd_groups[0].use_lrw = disable_lrw == 0 ? 1 : 0;
     ec.pd_groups[0].overlapping = disable_overlapping == 0 ? 1 : 0;
@@ -462,66 +486,26 @@ int main(int argc, char **argv) {
     signal(SIGINT, sig_handler);
 
     // wait here
-    osal_uint64_t tx_timer_med = 0, tx_timer_avg_jit = 0, tx_timer_max_jit = 0, tx_timer_min, tx_timer_max, tx_timer_min_ever = 0, tx_timer_max_ever = 0;
-    osal_uint64_t tx_duration_med = 0, tx_duration_avg_jit = 0, tx_duration_max_jit = 0, tx_duration_min, tx_duration_max, tx_duration_min_ever = 0, tx_duration_max_ever = 0;
-    osal_uint64_t rx_duration_med = 0, rx_duration_avg_jit = 0, rx_duration_max_jit = 0, rx_duration_min, rx_duration_max, rx_duration_min_ever = 0, rx_duration_max_ever = 0;
-    osal_uint64_t roundtrip_duration_med = 0, roundtrip_duration_avg_jit = 0, roundtrip_duration_max_jit = 0, roundtrip_duration_min, roundtrip_duration_max;
-
-    osal_uint64_t roundtrip_max_ever = 0;
-    osal_uint64_t roundtrip_min_ever = 0;
-
     for (;keep_running == 1;) {
-        osal_timer_t to;
-        osal_timer_init(&to, 10000000000);
-        osal_trace_timedwait(roundtrip_duration, &to);
-
-        if (dc_mode == dc_mode_ref_clock) 
-            osal_trace_timedwait(dc_diff, &to);
-
-        osal_trace_analyze_min_max(tx_start, &tx_timer_med, &tx_timer_avg_jit, &tx_timer_max_jit, &tx_timer_min, &tx_timer_max);
-        osal_trace_analyze_rel_min_max(tx_duration, &tx_duration_med, &tx_duration_avg_jit, &tx_duration_max_jit, &tx_duration_min, &tx_duration_max);
-        osal_trace_analyze_rel_min_max(rx_duration, &rx_duration_med, &rx_duration_avg_jit, &rx_duration_max_jit, &rx_duration_min, &rx_duration_max);
-        osal_trace_analyze_rel_min_max(roundtrip_duration, &roundtrip_duration_med, &roundtrip_duration_avg_jit, &roundtrip_duration_max_jit, &roundtrip_duration_min, &roundtrip_duration_max);
-
-        static int skip_first = 1;
-        if (skip_first > 0) {
-            skip_first = 0;
-            continue;
-        }
+        osal_sleep(1000000000);
 
-        if (!roundtrip_min_ever || (roundtrip_min_ever > roundtrip_duration_min))
-            roundtrip_min_ever = roundtrip_duration_min;
-        if (!roundtrip_max_ever || (roundtrip_max_ever < roundtrip_duration_max))
-            roundtrip_max_ever = roundtrip_duration_max;
-        if (!rx_duration_min_ever || (rx_duration_min_ever > rx_duration_min))
-            rx_duration_min_ever = rx_duration_min;
-        if (!rx_duration_max_ever || (rx_duration_max_ever < rx_duration_max))
-            rx_duration_max_ever = rx_duration_max;
-        if (!tx_duration_min_ever || (tx_duration_min_ever > tx_duration_min))
-            tx_duration_min_ever = tx_duration_min;
-        if (!tx_duration_max_ever || (tx_duration_max_ever < tx_duration_max))
-            tx_duration_max_ever = tx_duration_max;
-        if (!tx_timer_min_ever || (tx_timer_min_ever > tx_timer_min))
-            tx_timer_min_ever = tx_timer_min;
-        if (!tx_timer_max_ever || (tx_timer_max_ever < tx_timer_max))
-            tx_timer_max_ever = tx_timer_max;
-
-#define to_us(x)    ((double)(x)/1000.)
         ec_log(10, "", "=====================================================================================================\n");
         ec_log(10, "Times", "RTC %15.9fs, Last Sent %15.9fs, DC %15.9fs, Cyclerate %ldns\n", ec.dc.rtc_time/1E9, last_sent/1E9, ec.dc.dc_time/1E9, act_cycle_rate);
         ec_log(10, "Frame", "Length %" PRIu64 " bytes, Time @ 100 MBit/s %7.1fus\n", bytes_last_sent + 7 + 4, (10 * 8 * (bytes_last_sent + 7 + 4)) / 1000.); // preamble, fcs
-        ec_log(10, "Timer", "Avg %7.1fus (stddev %4" PRId64 "ns / maxdev %4" PRId64 "ns, min %8" PRId64 "ns / max %8" PRId64 "ns, min ever %8"PRId64"ns / max ever %8"PRId64"ns)\n",  
-                to_us(tx_timer_med), tx_timer_avg_jit, tx_timer_max_jit, tx_timer_min, tx_timer_max, tx_timer_min_ever, tx_timer_max_ever);
-        ec_log(10, "TX", "Avg %7.1fus (stddev %4" PRId64 "ns / maxdev %4" PRId64 "ns, min %8" PRId64 "ns / max %8" PRId64 "ns, min ever %8"PRId64"ns / max ever %8"PRId64"ns)\n", 
-                to_us(tx_duration_med), tx_duration_avg_jit, tx_duration_max_jit, tx_duration_min, tx_duration_max, tx_duration_min_ever, tx_duration_max_ever);
-        ec_log(10, "RX", "Avg %7.1fus (stddev %4" PRId64 "ns / maxdev %4" PRId64 "ns, min %8" PRId64 "ns / max %8" PRId64 "ns, min ever %8"PRId64"ns / max ever %8"PRId64"ns)\n", 
-                to_us(rx_duration_med), rx_duration_avg_jit, rx_duration_max_jit, rx_duration_min, rx_duration_max, rx_duration_min_ever, rx_duration_max_ever);
-        ec_log(10, "Rounttrip", "Avg %7.1fus (stddev %4" PRId64 "ns / maxdev %4" PRId64 "ns, min %8" PRId64 "ns / max %8" PRId64 "ns, min ever %8"PRId64"ns / max ever %8"PRId64"ns)\n", 
-                to_us(roundtrip_duration_med), roundtrip_duration_avg_jit, roundtrip_duration_max_jit, roundtrip_duration_min, roundtrip_duration_max, roundtrip_min_ever, roundtrip_max_ever);
 
         if (dc_mode == dc_mode_ref_clock) {
             ec_log(10, "DC", "Diff %4" PRId64 "ns, i_part %+7.1fns\n", ec.dc.act_diff, ec.dc.control.i_part);
         }
+
+        static ec_statistics_t stats;
+        ec_get_statistics(&ec, &stats, 1);
+        ec_log(10, "Stats", "jitter p99 %6" PRIu64 "ns / max %6" PRIu64 "ns, round trip p99 %6" PRIu64 
+                "ns / max %6" PRIu64 "ns, wkc mismatch %" PRIu64 "\n",
+                ec_histogram_percentile(&stats.cycle_jitter, 99.), stats.cycle_jitter.max,
+                ec_histogram_percentile(&stats.round_trip, 99.), stats.round_trip.max, stats.wkc_mismatch[0]);
+        ec_log(10, "Stats", "tx p99 %6" PRIu64 "ns / max %6" PRIu64 "ns, rx p99 %6" PRIu64 "ns / max %6" PRIu64 "ns\n",
+                ec_histogram_percentile(&stats.tx_duration, 99.), stats.tx_duration.max,
+                ec_histogram_percentile(&stats.rx_duration, 99.), stats.rx_duration.max);
     }
 
 exit:
@@ -535,10 +519,6 @@ exit:
     printf("done\n");
 
 hw_exit:
-    osal_trace_free(tx_start);
-    osal_trace_free(tx_duration);
-    osal_trace_free(roundtrip_duration);
-
     return 0;
 }
 
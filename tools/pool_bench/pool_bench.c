@@ -0,0 +1,247 @@
+//! contention benchmark for datagram send queues
+//
+/*!
+ * author: Robert Burger
+ *
+ * Compares the mutex/semaphore based pool_t with the lock-free pool_mpsc_t 
+ * used as hw send queues. A number of producer threads (mimicking mailbox 
+ * handlers) enqueue datagrams while one consumer (mimicking the cyclic 
+ * sender) drains the queue.
+ *
+ * $Id$
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libethercat/config.h>
+#endif
+
+#include <libosal/task.h>
+#include <libosal/timer.h>
+
+#include <libethercat/pool.h>
+#include <libethercat/error_codes.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sched.h>
+
+typedef enum bench_queue_type {
+    BENCH_POOL,
+    BENCH_POOL_MPSC,
+} bench_queue_type_t;
+
+typedef struct bench_producer {
+    struct bench *pb;
+    pool_entry_t *entries;
+    osal_task_t hdl;
+
+    osal_uint32_t outstanding;
+    osal_uint64_t put_max_ns;
+    osal_uint64_t put_sum_ns;
+} bench_producer_t;
+
+typedef struct bench {
+    bench_queue_type_t type;
+    pool_t pool;
+    pool_mpsc_t mpsc;
+
+    osal_uint32_t start;
+    osal_size_t producers;
+    osal_size_t batch;
+    osal_size_t loops;
+    bench_producer_t *prod;
+} bench_t;
+
+static void bench_put(bench_t *pb, pool_entry_t *p_entry) {
+    if (pb->type == BENCH_POOL) {
+        pool_put(&pb->pool, p_entry);
+    } else {
+        pool_mpsc_put(&pb->mpsc, p_entry);
+    }
+}
+
+static int bench_get(bench_t *pb, pool_entry_t **pp_entry) {
+    int ret;
+
+    if (pb->type == BENCH_POOL) {
+        ret = pool_get(&pb->pool, pp_entry, NULL);
+    } else {
+        ret = pool_mpsc_get(&pb->mpsc, pp_entry);
+    }
+
+    return ret;
+}
+
+static osal_void_t *producer_task(osal_void_t *arg) {
+    bench_producer_t *pp = (bench_producer_t *)arg;
+    bench_t *pb = pp->pb;
+
+    while (__atomic_load_n(&pb->start, __ATOMIC_ACQUIRE) == 0u) { (void)sched_yield(); }
+
+    for (osal_size_t l = 0u; l < pb->loops; ++l) {
+        __atomic_store_n(&pp->outstanding, pb->batch, __ATOMIC_RELEASE);
+
+        for (osal_size_t i = 0u; i < pb->batch; ++i) {
+            osal_uint64_t start = osal_timer_gettime_nsec();
+            bench_put(pb, &pp->entries[i]);
+            osal_uint64_t duration = osal_timer_gettime_nsec() - start;
+
+            pp->put_sum_ns += duration;
+            if (duration > pp->put_max_ns) {
+                pp->put_max_ns = duration;
+            }
+        }
+
+        // wait until our datagrams are "sent"
+        while (__atomic_load_n(&pp->outstanding, __ATOMIC_ACQUIRE) != 0u) { (void)sched_yield(); }
+    }
+
+    return NULL;
+}
+
+static void run_bench(bench_t *pb, const char *name) {
+    osal_size_t total = pb->producers * pb->batch * pb->loops;
+    osal_size_t done = 0u;
+    osal_uint64_t drain_max_ns = 0u;
+    osal_uint64_t empty_polls = 0u;
+
+    if (pb->type == BENCH_POOL) {
+        (void)pool_open(&pb->pool, 0, NULL);
+    } else {
+        (void)pool_mpsc_open(&pb->mpsc);
+    }
+
+    __atomic_store_n(&pb->start, 0u, __ATOMIC_RELEASE);
+    for (osal_size_t p = 0u; p < pb->producers; ++p) {
+        bench_producer_t *pp = &pb->prod[p];
+        pp->pb = pb;
+        pp->outstanding = 0u;
+        pp->put_max_ns = 0u;
+        pp->put_sum_ns = 0u;
+
+        for (osal_size_t i = 0u; i < pb->batch; ++i) {
+            pp->entries[i].user_arg = (int)p;
+        }
+
+        (void)osal_task_create(&pp->hdl, NULL, producer_task, pp);
+    }
+
+    osal_uint64_t bench_start = osal_timer_gettime_nsec();
+    __atomic_store_n(&pb->start, 1u, __ATOMIC_RELEASE);
+
+    while (done < total) {
+        pool_entry_t *p_entry;
+        osal_uint64_t start = osal_timer_gettime_nsec();
+        osal_size_t cnt = 0u;
+
+        // drain like hw_tx_pool does
+        while (bench_get(pb, &p_entry) == EC_OK) {
+            (void)__atomic_sub_fetch(&pb->prod[p_entry->user_arg].outstanding, 1u, __ATOMIC_ACQ_REL);
+            cnt++;
+        }
+
+        if (cnt == 0u) {
+            empty_polls++;
+            (void)sched_yield();
+        } else {
+            osal_uint64_t duration = osal_timer_gettime_nsec() - start;
+            if (duration > drain_max_ns) {
+                drain_max_ns = duration;
+            }
+
+            done += cnt;
+        }
+    }
+
+    osal_uint64_t bench_duration = osal_timer_gettime_nsec() - bench_start;
+
+    osal_uint64_t put_max_ns = 0u;
+    osal_uint64_t put_sum_ns = 0u;
+    for (osal_size_t p = 0u; p < pb->producers; ++p) {
+        (void)osal_task_join(&pb->prod[p].hdl, NULL);
+
+        put_sum_ns += pb->prod[p].put_sum_ns;
+        if (pb->prod[p].put_max_ns > put_max_ns) {
+            put_max_ns = pb->prod[p].put_max_ns;
+        }
+    }
+
+    if (pb->type == BENCH_POOL) {
+        (void)pool_close(&pb->pool);
+    } else {
+        (void)pool_mpsc_close(&pb->mpsc);
+    }
+
+    printf("%-10s %10.0f dg/s, put avg %6" PRIu64 " ns, put max %8" PRIu64 " ns, drain max %8" PRIu64 " ns, empty polls %" PRIu64 "\n",
+            name, (double)total * 1.e9 / (double)bench_duration, put_sum_ns / total, 
+            put_max_ns, drain_max_ns, empty_polls);
+}
+
+int usage(int argc, char **argv) {
+    printf("%s [-p|--producers <cnt>] [-b|--batch <cnt>] [-l|--loops <cnt>]\n", argv[0]);
+    printf("  -h|--help             Display this help page.\n");
+    printf("  -p|--producers        Number of producer threads (default 8).\n");
+    printf("  -b|--batch            Datagrams enqueued per producer and round (default 4).\n");
+    printf("  -l|--loops            Rounds per producer (default 100000).\n");
+
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int ret = 0;
+    bench_t bench;
+
+    (void)memset(&bench, 0, sizeof(bench));
+    bench.producers = 8u;
+    bench.batch = 4u;
+    bench.loops = 100000u;
+
+    for (int i = 1; i < argc; ++i) {
+        if ((strcmp(argv[i], "-p") == 0) || (strcmp(argv[i], "--producers") == 0)) {
+            if (++i < argc) { bench.producers = strtoul(argv[i], NULL, 10); }
+        } else if ((strcmp(argv[i], "-b") == 0) || (strcmp(argv[i], "--batch") == 0)) {
+            if (++i < argc) { bench.batch = strtoul(argv[i], NULL, 10); }
+        } else if ((strcmp(argv[i], "-l") == 0) || (strcmp(argv[i], "--loops") == 0)) {
+            if (++i < argc) { bench.loops = strtoul(argv[i], NULL, 10); }
+        } else {
+            return usage(argc, argv);
+        }
+    }
+
+    if ((bench.producers == 0u) || (bench.batch == 0u) || (bench.loops == 0u)) {
+        return usage(argc, argv);
+    }
+
+    bench.prod = (bench_producer_t *)calloc(bench.producers, sizeof(bench_producer_t));
+    for (osal_size_t p = 0u; (bench.prod != NULL) && (p < bench.producers); ++p) {
+        bench.prod[p].entries = (pool_entry_t *)calloc(bench.batch, sizeof(pool_entry_t));
+        if (bench.prod[p].entries == NULL) {
+            ret = -1;
+        }
+    }
+
+    if ((bench.prod == NULL) || (ret != 0)) {
+        printf("out of memory!\n");
+        ret = -1;
+    } else {
+        printf("%" PRIu64 " producers, batch %" PRIu64 ", %" PRIu64 " rounds\n", 
+                (osal_uint64_t)bench.producers, (osal_uint64_t)bench.batch, (osal_uint64_t)bench.loops);
+
+        bench.type = BENCH_POOL;
+        run_bench(&bench, "pool_t");
+
+        bench.type = BENCH_POOL_MPSC;
+        run_bench(&bench, "pool_mpsc_t");
+    }
+
+    if (bench.prod != NULL) {
+        for (osal_size_t p = 0u; p < bench.producers; ++p) {
+            free(bench.prod[p].entries);
+        }
+        free(bench.prod);
+    }
+
+    return ret;
+}
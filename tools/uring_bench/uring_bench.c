@@ -0,0 +1,201 @@
+//! cycle benchmark for io_uring hw device layer
+//
+/*!
+ * author: Robert Burger
+ *
+ * Compares the read/write based hw_sock_raw and hw_file device layers 
+ * with hw_uring (with and without SQPOLL). Every cycle a number of frames 
+ * is sent and the cycle is finished when all of them were received back. 
+ * On an interface without slaves (e.g. lo) the frames are seen again by 
+ * the raw socket, so no EtherCAT hardware is needed.
+ *
+ * $Id$
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libethercat/config.h>
+#endif
+
+#include <libosal/timer.h>
+
+#include <libethercat/ec.h>
+#include <libethercat/hw.h>
+#include <libethercat/hw_uring.h>
+#include <libethercat/error_codes.h>
+
+#if LIBETHERCAT_BUILD_DEVICE_SOCK_RAW_LEGACY == 1
+#include <libethercat/hw_sock_raw.h>
+#endif
+
+#if LIBETHERCAT_BUILD_DEVICE_FILE == 1
+#include <libethercat/hw_file.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sched.h>
+#include <unistd.h>
+
+//! Maximum frames per cycle, bounded by uring tx buffers.
+#define BENCH_MAX_FRAMES    HW_URING_TX_FRAMES
+
+typedef struct bench {
+    ec_t ec;
+    struct hw_common *phw;
+
+    osal_size_t frames;
+    osal_size_t dg_len;
+    osal_size_t cycles;
+
+    pool_entry_t entries[BENCH_MAX_FRAMES];
+    osal_uint32_t received;
+} bench_t;
+
+static bench_t bench;
+
+static void bench_cb(struct ec *pec, pool_entry_t *p_entry, ec_datagram_t *p_dg) {
+    (void)pec;
+    (void)p_entry;
+    (void)p_dg;
+
+    (void)__atomic_add_fetch(&bench.received, 1u, __ATOMIC_RELEASE);
+}
+
+static void run_bench(bench_t *pb, const char *name) {
+    osal_uint64_t cycle_max_ns = 0u;
+    osal_uint64_t cycle_sum_ns = 0u;
+    osal_size_t lost = 0u;
+
+    pb->phw->pec = &pb->ec;
+    pb->ec.phw = pb->phw;
+
+    for (osal_size_t c = 0u; c < pb->cycles; ++c) {
+        osal_uint64_t start = osal_timer_gettime_nsec();
+        __atomic_store_n(&pb->received, 0u, __ATOMIC_RELEASE);
+
+        for (osal_size_t k = 0u; k < pb->frames; ++k) {
+            ec_frame_t *pframe;
+            (void)pb->phw->get_tx_buffer(pb->phw, &pframe);
+
+            ec_datagram_t *p_dg = (ec_datagram_t *)ec_frame_end(pframe);
+            (void)memset(p_dg, 0, sizeof(ec_datagram_t) + pb->dg_len + 2u);
+            p_dg->cmd = EC_CMD_BRD;
+            p_dg->idx = (osal_uint8_t)k;
+            p_dg->len = pb->dg_len;
+            pframe->len += sizeof(ec_datagram_t) + pb->dg_len + 2u;
+
+            pb->entries[k].user_cb = bench_cb;
+            pb->phw->tx_send[k] = &pb->entries[k];
+            (void)pb->phw->send(pb->phw, pframe, POOL_HIGH);
+        }
+
+        if (pb->phw->send_finished != NULL) {
+            pb->phw->send_finished(pb->phw);
+        }
+
+        // wait for all frames, give up after 10 ms
+        while (__atomic_load_n(&pb->received, __ATOMIC_ACQUIRE) < pb->frames) {
+            if ((osal_timer_gettime_nsec() - start) > 10000000u) {
+                lost += pb->frames - __atomic_load_n(&pb->received, __ATOMIC_ACQUIRE);
+                for (osal_size_t k = 0u; k < pb->frames; ++k) {
+                    pb->phw->tx_send[k] = NULL;
+                }
+                break;
+            }
+
+            (void)sched_yield();
+        }
+
+        osal_uint64_t duration = osal_timer_gettime_nsec() - start;
+        cycle_sum_ns += duration;
+        if (duration > cycle_max_ns) {
+            cycle_max_ns = duration;
+        }
+    }
+
+    printf("%-14s cycle avg %8" PRIu64 " ns, cycle max %9" PRIu64 " ns, %10.0f frames/s, lost %" PRIu64 "\n",
+            name, cycle_sum_ns / pb->cycles, cycle_max_ns, 
+            (double)(pb->cycles * pb->frames) * 1.e9 / (double)cycle_sum_ns, (osal_uint64_t)lost);
+
+    (void)hw_close(pb->phw);
+}
+
+int usage(int argc, char **argv) {
+    (void)argc;
+
+    printf("%s [-i|--interface <intf>] [-f|--frames <cnt>] [-s|--size <bytes>] [-c|--cycles <cnt>]\n", argv[0]);
+    printf("  -h|--help             Display this help page.\n");
+    printf("  -i|--interface        Network interface or device file (default lo).\n");
+    printf("  -f|--frames           Frames sent per cycle (default 4, max %u).\n", BENCH_MAX_FRAMES);
+    printf("  -s|--size             Datagram payload size in bytes (default 1000).\n");
+    printf("  -c|--cycles           Number of cycles (default 10000).\n");
+
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    const osal_char_t *intf = "lo";
+
+    (void)memset(&bench, 0, sizeof(bench));
+    bench.frames = 4u;
+    bench.dg_len = 1000u;
+    bench.cycles = 10000u;
+
+    for (int i = 1; i < argc; ++i) {
+        if ((strcmp(argv[i], "-i") == 0) || (strcmp(argv[i], "--interface") == 0)) {
+            if (++i < argc) { intf = argv[i]; }
+        } else if ((strcmp(argv[i], "-f") == 0) || (strcmp(argv[i], "--frames") == 0)) {
+            if (++i < argc) { bench.frames = strtoul(argv[i], NULL, 10); }
+        } else if ((strcmp(argv[i], "-s") == 0) || (strcmp(argv[i], "--size") == 0)) {
+            if (++i < argc) { bench.dg_len = strtoul(argv[i], NULL, 10); }
+        } else if ((strcmp(argv[i], "-c") == 0) || (strcmp(argv[i], "--cycles") == 0)) {
+            if (++i < argc) { bench.cycles = strtoul(argv[i], NULL, 10); }
+        } else {
+            return usage(argc, argv);
+        }
+    }
+
+    if (    (bench.frames == 0u) || (bench.frames > BENCH_MAX_FRAMES) || 
+            (bench.cycles == 0u) || (bench.dg_len > 1400u)) {
+        return usage(argc, argv);
+    }
+
+    printf("%s: %" PRIu64 " frames per cycle, %" PRIu64 " bytes payload, %" PRIu64 " cycles\n", intf,
+            (osal_uint64_t)bench.frames, (osal_uint64_t)bench.dg_len, (osal_uint64_t)bench.cycles);
+
+    if (intf[0] == '/') {
+#if LIBETHERCAT_BUILD_DEVICE_FILE == 1
+        static struct hw_file hw_file;
+        if (hw_device_file_open(&hw_file, &bench.ec, intf, 0, 0) == EC_OK) {
+            bench.phw = &hw_file.common;
+            run_bench(&bench, "file");
+        }
+#endif
+    } else {
+#if LIBETHERCAT_BUILD_DEVICE_SOCK_RAW_LEGACY == 1
+        static struct hw_sock_raw hw_sock_raw;
+        if (hw_device_sock_raw_open(&hw_sock_raw, &bench.ec, intf, 0, 0) == EC_OK) {
+            bench.phw = &hw_sock_raw.common;
+            run_bench(&bench, "sock_raw");
+        }
+#endif
+    }
+
+    static struct hw_uring hw_uring;
+    if (hw_device_uring_open(&hw_uring, &bench.ec, intf, 0, 0, OSAL_FALSE) == EC_OK) {
+        bench.phw = &hw_uring.common;
+        run_bench(&bench, "uring");
+    }
+
+    // kernel polling thread needs a cpu on its own
+    if (sysconf(_SC_NPROCESSORS_ONLN) < 2) {
+        printf("%-14s skipped, needs at least 2 cpus\n", "uring-sqpoll");
+    } else if (hw_device_uring_open(&hw_uring, &bench.ec, intf, 0, 0, OSAL_TRUE) == EC_OK) {
+        bench.phw = &hw_uring.common;
+        run_bench(&bench, "uring-sqpoll");
+    }
+
+    return 0;
+}